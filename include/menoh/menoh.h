@@ -52,6 +52,7 @@ enum menoh_dtype_constant {
     menoh_dtype_int16,
     menoh_dtype_int32,
     menoh_dtype_int64,
+    menoh_dtype_bfloat16, // upper 16 bits of float32
 };
 /*! @ingroup vpt
  */
@@ -88,6 +89,8 @@ enum menoh_error_code_constant {
     menoh_error_code_invalid_backend_config_error,
     menoh_error_code_input_not_found_error,
     menoh_error_code_output_not_found_error,
+    menoh_error_code_deadline_exceeded,
+    menoh_error_code_run_cancelled,
 };
 typedef int32_t menoh_error_code;
 /*! \brief Users can get detailed message about last error.
@@ -183,6 +186,14 @@ menoh_error_code MENOH_API
 menoh_model_data_add_attribute_floats_to_current_node(
   menoh_model_data_handle model_data, const char* attribute_name, int32_t size,
   const float* value);
+/*! \brief Add a new string attribute to latest added node in model_data
+ *
+ * \note Duplication of attribute_name is not allowed and it throws error.
+ */
+menoh_error_code MENOH_API
+menoh_model_data_add_attribute_string_to_current_node(
+  menoh_model_data_handle model_data, const char* attribute_name,
+  const char* value);
 /** @} */
 
 /*! @addtogroup vpt Variable profile table types and operations
@@ -463,11 +474,468 @@ menoh_error_code MENOH_API menoh_model_get_variable_dims(
   const int32_t** dims);
 
 /*! \brief Run model inference
+ *
+ * Models built with "sub_batch_size" in backend_config run a larger batch as
+ * sub-batches of at most that size, split along the first axis of inputs and
+ * outputs. Each group of cpus has one sub-batch model, which runs the
+ * sub-batches assigned to it in turn and copies their slices in and out.
+ * With "sub_batch_mode": "concurrent" (default) sub-batches are assigned to
+ * groups in turn and the groups run concurrently. With "sequential" one
+ * group runs all of them to bound the memory of activations.
  *
  * \warning This function can't be called asynchronously.
  */
 menoh_error_code MENOH_API menoh_model_run(menoh_model_handle model);
 
+/*! \struct menoh_cancellation_token
+ *  \brief Flag to stop runs from other threads
+ *
+ * See menoh_model_run_with_deadline()
+ */
+struct menoh_cancellation_token;
+typedef struct menoh_cancellation_token* menoh_cancellation_token_handle;
+
+/*! \brief Factory function for menoh_cancellation_token
+ */
+menoh_error_code MENOH_API
+menoh_make_cancellation_token(menoh_cancellation_token_handle* dst_handle);
+/*! \brief Delete function for menoh_cancellation_token
+ *
+ * \warning Do not delete the token while runs are watching it.
+ */
+void MENOH_API
+menoh_delete_cancellation_token(menoh_cancellation_token_handle token);
+
+/*! \brief Cancel runs watching the token
+ *
+ * It can be called from any thread.
+ */
+menoh_error_code MENOH_API
+menoh_cancellation_token_cancel(menoh_cancellation_token_handle token);
+
+/*! \brief Clear the cancellation to reuse the token
+ */
+menoh_error_code MENOH_API
+menoh_cancellation_token_reset(menoh_cancellation_token_handle token);
+
+/*! \brief Run model inference with a deadline
+ *
+ * The deadline is `timeout_in_microseconds` after the call. A negative value
+ * means no deadline. `token` can be NULL.
+ *
+ * The deadline and the token are checked before each procedure (a sequence
+ * of mkldnn primitives or a kernel of the generic backend) and before each
+ * pipeline stage. menoh_error_code_deadline_exceeded or
+ * menoh_error_code_run_cancelled is returned when the run stops early. Then
+ * values of output variables are undefined.
+ *
+ * \note The "mkldnn" backend checks them before the primitives of each node.
+ *
+ * \warning This function can't be called asynchronously.
+ */
+menoh_error_code MENOH_API menoh_model_run_with_deadline(
+  menoh_model_handle model, int64_t timeout_in_microseconds,
+  const menoh_cancellation_token_handle token);
+
+/*! \brief Warm up the model before serving
+ *
+ * Pages of input and output buffers allocated by menoh for all streams are
+ * mapped without changing their contents. External buffers are not
+ * touched. Then each stream runs `iteration_num` times with current
+ * inputs, which touches activations allocated by backends and prepares
+ * mkldnn streams and caches. The first stream is warmed on the calling
+ * thread, so call this function from the thread which runs the model.
+ * Other streams are warmed concurrently. Warm-up runs are not recorded to
+ * the profiler. Values of outputs are overwritten.
+ *
+ * \warning This function can't be called asynchronously.
+ */
+menoh_error_code MENOH_API menoh_model_warmup(menoh_model_handle model,
+                                              int32_t iteration_num);
+
+/*! \brief Start recording runs of all streams of the model
+ *
+ * Each node run is recorded as its own event with its start and end
+ * times, op_type, backend context, dims of inputs and outputs and their
+ * memory formats (e.g. "nChw8c") when the backend knows them. Events
+ * recorded before are discarded. The "mkldnn_with_generic_fallback" backend
+ * also enables profiling at build by "profiling": true in backend_config.
+ *
+ * When profiling is disabled, runs pay only one check per node.
+ *
+ * \warning This function can't be called while the model is running.
+ */
+menoh_error_code MENOH_API
+menoh_model_enable_profiling(menoh_model_handle model);
+
+/*! \brief Stop recording runs. Recorded events are kept.
+ *
+ * \warning This function can't be called while the model is running.
+ */
+menoh_error_code MENOH_API
+menoh_model_disable_profiling(menoh_model_handle model);
+
+/*! \brief Save recorded events as Chrome trace_event JSON
+ *
+ * The file can be opened by chrome://tracing or Perfetto. Timestamps are
+ * microseconds since profiling was enabled.
+ */
+menoh_error_code MENOH_API menoh_model_save_profile_trace(
+  const menoh_model_handle model, const char* filename);
+
+/*! \brief Save per-op_type totals of recorded events
+ *
+ * The file is a tab separated table with columns op_type, count, total_us,
+ * average_us and ratio of total time, sorted by total time.
+ */
+menoh_error_code MENOH_API menoh_model_save_profile_summary(
+  const menoh_model_handle model, const char* filename);
+
+/*! \struct menoh_memory_stats
+ *  \brief menoh_memory_stats is a snapshot of memory held by a model.
+ *
+ * Each block of memory is counted once even if it is shared by streams or
+ * backends. External buffers attached by users and parameters added by
+ * menoh_model_data_add_parameter(), which refer to user buffers, are not
+ * counted.
+ */
+struct menoh_memory_stats;
+typedef struct menoh_memory_stats* menoh_memory_stats_handle;
+
+enum menoh_memory_category_constant {
+    /*! parameters of the model as given */
+    menoh_memory_category_parameter,
+    /*! parameters reordered or quantized by backends */
+    menoh_memory_category_packed_weight,
+    /*! variables computed by the model */
+    menoh_memory_category_activation,
+    /*! temporary memory of mkldnn primitives */
+    menoh_memory_category_scratch,
+    /*! input and output buffers allocated by menoh */
+    menoh_memory_category_io,
+};
+typedef int32_t menoh_memory_category;
+
+/*! \brief Take memory_stats of all streams of the model
+ *
+ * \note The "mkldnn" backend reports reordered weights as scratch.
+ */
+menoh_error_code MENOH_API menoh_model_get_memory_stats(
+  const menoh_model_handle model, menoh_memory_stats_handle* dst_handle);
+/*! \brief Delete function for memory_stats
+ */
+void MENOH_API menoh_delete_memory_stats(menoh_memory_stats_handle stats);
+
+/*! \brief Get bytes of the category
+ */
+menoh_error_code MENOH_API menoh_memory_stats_get_bytes(
+  const menoh_memory_stats_handle stats, menoh_memory_category category,
+  int64_t* dst_bytes);
+
+/*! \brief Get bytes of all categories
+ */
+menoh_error_code MENOH_API menoh_memory_stats_get_total_bytes(
+  const menoh_memory_stats_handle stats, int64_t* dst_bytes);
+
+/*! \brief Get the number of entries of the per-variable breakdown
+ */
+menoh_error_code MENOH_API menoh_memory_stats_get_entry_num(
+  const menoh_memory_stats_handle stats, int32_t* dst_num);
+
+/*! \brief Get the entry at `index` of the per-variable breakdown
+ *
+ * The name is the variable which the memory holds, or an empty string when
+ * it is not known. The returned string is valid while the stats is alive.
+ */
+menoh_error_code MENOH_API menoh_memory_stats_get_entry(
+  const menoh_memory_stats_handle stats, int32_t index, const char** dst_name,
+  menoh_memory_category* dst_category, int64_t* dst_bytes);
+
+/*! \brief Get the number of streams of the model
+ *
+ * Models built with "stream_num" in backend_config have that number of
+ * streams. Each stream is an independent replica of the model with its own
+ * buffers and runs on its own group of cpus, which are split from
+ * "cpu_list", the cpus of "numa_node" or all cpus the calling thread can run
+ * on. Other models have one stream. The first stream is the one run by
+ * menoh_model_run() and accessed by menoh_model_get_variable_buffer_handle().
+ *
+ * Parameters are shared by all streams. With "mkldnn_with_generic_fallback"
+ * and "composite_backend", weights reordered into formats chosen by mkldnn
+ * are also shared: they are made once when the model is built and are only
+ * read when it runs.
+ */
+menoh_error_code MENOH_API menoh_model_get_stream_num(
+  const menoh_model_handle model, int32_t* dst_stream_num);
+
+/*! \brief Get a buffer handle attached to target variable of the stream
+ *
+ * \note Only the first stream uses buffers attached by
+ * menoh_model_builder_attach_external_buffer(). Buffers of the other streams
+ * are allocated internally.
+ */
+menoh_error_code MENOH_API menoh_model_get_stream_variable_buffer_handle(
+  const menoh_model_handle model, int32_t stream_index,
+  const char* variable_name, void** dst_data);
+
+/*! \brief Callback called for each batch by menoh_model_run_batches()
+ */
+typedef void (*menoh_batch_callback)(void* user_data, int32_t batch_index,
+                                     int32_t stream_index);
+
+/*! \brief Run batch_num batches on all streams of the model
+ *
+ * Each stream takes the next batch from a shared queue. `prepare` is called
+ * to fill input buffers of the stream before it runs and `finish` to read its
+ * output buffers after that. Either of them can be NULL. Each stream runs on
+ * its own worker thread, which is started on the first call and kept until
+ * the model is deleted.
+ *
+ * Models built with "pipeline_stage_num" in backend_config split their nodes
+ * into that number of stages running on their own groups of cpus. Stage cut
+ * points are given by "pipeline_cut_points" (indices of the first nodes of
+ * stages) or chosen by measured time of nodes. For such a model with one
+ * stream, batches are streamed through the stages: `prepare` of the next
+ * batch is called while later stages run the current one.
+ *
+ * \warning Callbacks are called concurrently from different threads and must
+ * not throw.
+ */
+menoh_error_code MENOH_API menoh_model_run_batches(
+  menoh_model_handle model, int32_t batch_num, menoh_batch_callback prepare,
+  menoh_batch_callback finish, void* user_data);
+
+/** @} */
+
+/** @addtogroup session Session to serve requests with replicas of a model
+ * @{ */
+/*! \struct menoh_session
+ *  \brief menoh_session runs requests on a pool of replicas of a model.
+ *
+ * Replicas are the streams of the model built with "stream_num" in
+ * backend_config (one replica when it is not given). They share parameters
+ * and run on their own groups of cpus. Requests are put into a lock-free
+ * queue of "session_queue_capacity" (default 1024) and each replica has a
+ * worker thread taking them. Each worker warms its replica up like
+ * menoh_model_warmup() with "session_warmup_iteration_num" (default 1)
+ * iterations before taking requests.
+ */
+struct menoh_session;
+typedef struct menoh_session* menoh_session_handle;
+
+/*! \brief Callback to fill input buffers of the replica
+ */
+typedef void (*menoh_session_prepare_callback)(void* user_data,
+                                               int32_t replica_index);
+/*! \brief Callback to read output buffers of the replica
+ *
+ * error_code is not menoh_error_code_success when the request failed.
+ */
+typedef void (*menoh_session_finish_callback)(void* user_data,
+                                              int32_t replica_index,
+                                              menoh_error_code error_code);
+
+/*! \brief Factory function for menoh_session
+ *
+ * Arguments are same to menoh_build_model(). It returns after warm-up of
+ * all replicas.
+ */
+menoh_error_code MENOH_API menoh_build_session(
+  const menoh_model_builder_handle builder,
+  const menoh_model_data_handle model_data, const char* backend_name,
+  const char* backend_config, menoh_session_handle* dst_handle);
+/*! \brief Delete function for session
+ *
+ * It waits for all submitted requests.
+ */
+void MENOH_API menoh_delete_session(menoh_session_handle session);
+
+/*! \brief Submit a request
+ *
+ * `prepare` and `finish` are called on the worker of the replica which runs
+ * the request. Either of them can be NULL. This function waits for a free
+ * slot when the queue is full.
+ *
+ * \warning Callbacks must not throw.
+ */
+menoh_error_code MENOH_API menoh_session_submit(
+  menoh_session_handle session, menoh_session_prepare_callback prepare,
+  menoh_session_finish_callback finish, void* user_data);
+
+/*! \brief Wait until all submitted requests finish
+ */
+menoh_error_code MENOH_API menoh_session_wait(menoh_session_handle session);
+
+/*! \brief Get the number of replicas
+ */
+menoh_error_code MENOH_API menoh_session_get_replica_num(
+  const menoh_session_handle session, int32_t* dst_replica_num);
+
+/*! \brief Get a buffer handle attached to target variable of the replica
+ */
+menoh_error_code MENOH_API menoh_session_get_variable_buffer_handle(
+  const menoh_session_handle session, int32_t replica_index,
+  const char* variable_name, void** dst_data);
+
+/*! \brief Get the number of requests waiting in the queue
+ */
+menoh_error_code MENOH_API menoh_session_get_queue_depth(
+  const menoh_session_handle session, int32_t* dst_queue_depth);
+
+/*! \brief Get the number of finished requests
+ */
+menoh_error_code MENOH_API menoh_session_get_completed_request_num(
+  const menoh_session_handle session, int64_t* dst_num);
+
+/*! \brief Get the ratio of time replicas spent in requests since the session
+ * was built
+ */
+menoh_error_code MENOH_API menoh_session_get_utilization(
+  const menoh_session_handle session, float* dst_utilization);
+
+/** @} */
+
+/** @addtogroup cost Static cost estimation
+ * @{ */
+/*! \struct menoh_model_cost_table
+ *  \brief menoh_model_cost_table holds static costs of nodes of a model.
+ *
+ * Costs are estimated from dims of variables without running the model.
+ * For each node, flops (a multiply-add counts as 2), bytes of parameters,
+ * bytes of activations read and bytes of activations written are recorded.
+ * Flops of operators which only move data (Reshape, Transpose, Concat, ...)
+ * and of unknown operators are 0.
+ *
+ * Nodes are named by their first output like events of
+ * menoh_model_save_profile_trace(), so measured times can be joined to
+ * costs to tell compute-bound nodes from bandwidth-bound ones.
+ */
+struct menoh_model_cost_table;
+typedef struct menoh_model_cost_table* menoh_model_cost_table_handle;
+
+enum menoh_cost_metric_constant {
+    menoh_cost_metric_flops,
+    menoh_cost_metric_parameter_bytes,
+    menoh_cost_metric_activation_read_bytes,
+    menoh_cost_metric_activation_written_bytes,
+};
+typedef int32_t menoh_cost_metric;
+
+/*! \brief Factory function for model_cost_table
+ *
+ * `variable_profile_table` must be built from `model_data`.
+ */
+menoh_error_code MENOH_API menoh_make_model_cost_table(
+  const menoh_model_data_handle model_data,
+  const menoh_variable_profile_table_handle variable_profile_table,
+  menoh_model_cost_table_handle* dst_handle);
+/*! \brief Delete function for model_cost_table
+ */
+void MENOH_API menoh_delete_model_cost_table(menoh_model_cost_table_handle table);
+
+/*! \brief Get the number of nodes in model_cost_table
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_get_node_num(
+  const menoh_model_cost_table_handle table, int32_t* dst_num);
+
+/*! \brief Get the name (first output name) of the node at `index`
+ *
+ * The returned string is valid while the table is alive.
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_get_node_name(
+  const menoh_model_cost_table_handle table, int32_t index,
+  const char** dst_name);
+
+/*! \brief Get the op_type of the node at `index`
+ *
+ * The returned string is valid while the table is alive.
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_get_node_op_type(
+  const menoh_model_cost_table_handle table, int32_t index,
+  const char** dst_op_type);
+
+/*! \brief Get a metric of the node at `index`
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_get_node_cost(
+  const menoh_model_cost_table_handle table, int32_t index,
+  menoh_cost_metric metric, int64_t* dst_value);
+
+/*! \brief Get the sum of a metric over all nodes
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_get_total_cost(
+  const menoh_model_cost_table_handle table, menoh_cost_metric metric,
+  int64_t* dst_value);
+
+/*! \brief Save model_cost_table as tab separated table
+ *
+ * Columns are name, op_type, flops, parameter_bytes, activation_read_bytes,
+ * activation_written_bytes and arithmetic_intensity (flops per byte moved).
+ * The last row is the total.
+ */
+menoh_error_code MENOH_API menoh_model_cost_table_save(
+  const menoh_model_cost_table_handle table, const char* filename);
+
+/** @} */
+
+/** @addtogroup calibration Calibration for int8 inference
+ * @{ */
+/*! \struct menoh_calibration_table
+ *  \brief menoh_calibration_table records ranges of variables.
+ *
+ * Users run a model with representative inputs and record ranges of variables
+ * by calling menoh_calibration_table_update() after each run. Saved table is
+ * used by "mkldnn_with_generic_fallback" and "composite_backend" backends to
+ * compute convolutions in int8 by setting its filename to
+ * "int8_calibration_table" of backend_config.
+ *
+ * Targets of calibration are added to the model as outputs by calling
+ * menoh_variable_profile_table_builder_add_calibration_targets().
+ */
+struct menoh_calibration_table;
+typedef struct menoh_calibration_table* menoh_calibration_table_handle;
+
+/*! \brief Factory function for empty calibration_table
+ */
+menoh_error_code MENOH_API
+menoh_make_calibration_table(menoh_calibration_table_handle* dst_handle);
+/*! \brief Load calibration_table saved by menoh_calibration_table_save()
+ */
+menoh_error_code MENOH_API menoh_make_calibration_table_from_file(
+  const char* filename, menoh_calibration_table_handle* dst_handle);
+/*! \brief Delete function for calibration_table
+ *
+ * Users must call to release memory resources allocated for
+ * calibration_table
+ */
+void MENOH_API
+menoh_delete_calibration_table(menoh_calibration_table_handle table);
+
+/*! @ingroup vpt
+ * \brief Add variables needed for int8 inference as outputs
+ *
+ * Inputs of Conv, FC and Gemm computed by other nodes are added. Variables
+ * already added are skipped.
+ */
+menoh_error_code MENOH_API
+menoh_variable_profile_table_builder_add_calibration_targets(
+  menoh_variable_profile_table_builder_handle builder,
+  const menoh_model_data_handle model_data);
+
+/*! \brief Extend ranges in calibration_table by current values of all float
+ * variables in the model.
+ *
+ * Per-tensor range and per-channel (axis 1) range are recorded.
+ *
+ * \note Users should call this function after each menoh_model_run().
+ */
+menoh_error_code MENOH_API menoh_calibration_table_update(
+  menoh_calibration_table_handle table, const menoh_model_handle model);
+
+/*! \brief Save calibration_table as JSON file
+ */
+menoh_error_code MENOH_API menoh_calibration_table_save(
+  const menoh_calibration_table_handle table, const char* filename);
+
 /** @} */
 
 /** @} */
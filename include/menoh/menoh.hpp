@@ -1,7 +1,13 @@
 #ifndef MENOH_HPP
 #define MENOH_HPP
 
+#include <chrono>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <menoh/menoh.h>
@@ -48,6 +54,8 @@ namespace menoh {
         same_named_variable_already_exist =
           menoh_error_code_same_named_variable_already_exist,
         invalid_dims_size,
+        deadline_exceeded = menoh_error_code_deadline_exceeded,
+        run_cancelled = menoh_error_code_run_cancelled,
     };
 
     //! The error class thrown when any error occured.
@@ -79,6 +87,7 @@ namespace menoh {
         int16 = menoh_dtype_int16,
         int32 = menoh_dtype_int32,
         int64 = menoh_dtype_int64,
+        bfloat16 = menoh_dtype_bfloat16,
     };
 
     class variable_profile_table;
@@ -173,6 +182,14 @@ namespace menoh {
                 value.data()));
         }
 
+        void
+        add_attribute_string_to_current_node(std::string const& attribute_name,
+                                             std::string const& value) {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_data_add_attribute_string_to_current_node(
+                impl_.get(), attribute_name.c_str(), value.c_str()));
+        }
+
         void add_parameter(std::string const& parameter_name, dtype_t dtype,
                              std::vector<int> const& dims,
                              void* buffer_handle) {
@@ -308,6 +325,16 @@ namespace menoh {
             add_output_name(name);
         }
 
+        //! Add variables needed for int8 inference as outputs.
+        /*! \sa
+         * calibration_table
+         */
+        void add_calibration_targets(model_data const& model_data) {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_variable_profile_table_builder_add_calibration_targets(
+                impl_.get(), model_data.get()));
+        }
+
         //! Factory function for variable_profile_table.
         variable_profile_table
         build_variable_profile_table(model_data const& model_data) {
@@ -332,6 +359,77 @@ namespace menoh {
         void* buffer_handle;
     };
 
+    //! Flag to stop runs from other threads.
+    /*!
+     * \sa
+     * model::run_with_deadline()
+     */
+    class cancellation_token {
+    public:
+        cancellation_token()
+          : impl_(nullptr, menoh_delete_cancellation_token) {
+            menoh_cancellation_token_handle h;
+            MENOH_CPP_API_ERROR_CHECK(menoh_make_cancellation_token(&h));
+            impl_.reset(h);
+        }
+
+        /*! Accessor to internal handle
+         *
+         * \note Normally users needn't call this function.
+         */
+        menoh_cancellation_token_handle get() const noexcept {
+            return impl_.get();
+        }
+
+        //! Cancel runs watching the token. Thread safe.
+        void cancel() {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_cancellation_token_cancel(impl_.get()));
+        }
+
+        //! Clear the cancellation to reuse the token.
+        void reset() {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_cancellation_token_reset(impl_.get()));
+        }
+
+    private:
+        std::unique_ptr<menoh_cancellation_token,
+                        decltype(&menoh_delete_cancellation_token)>
+          impl_;
+    };
+
+    enum class memory_category_t {
+        parameter = menoh_memory_category_parameter,
+        packed_weight = menoh_memory_category_packed_weight,
+        activation = menoh_memory_category_activation,
+        scratch = menoh_memory_category_scratch,
+        io = menoh_memory_category_io
+    };
+
+    //! Memory held by a model.
+    /*!
+     * \sa
+     * menoh_memory_stats
+     */
+    struct memory_stats {
+        struct entry {
+            std::string name; //!< empty when not known
+            memory_category_t category;
+            int64_t bytes;
+        };
+
+        int64_t parameter_bytes;
+        int64_t packed_weight_bytes;
+        int64_t activation_bytes;
+        int64_t scratch_bytes;
+        int64_t io_bytes;
+        int64_t total_bytes;
+
+        //! per-variable breakdown. Empty unless requested
+        std::vector<entry> entry_list;
+    };
+
     //! The main component to run inference.
     class model {
     public:
@@ -340,6 +438,12 @@ namespace menoh {
          */
         explicit model(menoh_model_handle h) : impl_(h, menoh_delete_model) {}
 
+        /*! Accessor to internal handle
+         *
+         * \note Normally users needn't call this function.
+         */
+        menoh_model_handle get() const noexcept { return impl_.get(); }
+
         //! Accsessor to internal variable.
         /*!
          * \sa
@@ -370,10 +474,302 @@ namespace menoh {
          */
         void run() { menoh_model_run(impl_.get()); }
 
+        //! Warm up the model before serving.
+        /*!
+         * \sa
+         * menoh_model_warmup()
+         */
+        void warmup(int iteration_num = 1) {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_warmup(impl_.get(), iteration_num));
+        }
+
+        //! Start recording runs.
+        /*!
+         * \sa
+         * menoh_model_enable_profiling()
+         */
+        void enable_profiling() {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_enable_profiling(impl_.get()));
+        }
+
+        //! Stop recording runs.
+        /*!
+         * \sa
+         * menoh_model_disable_profiling()
+         */
+        void disable_profiling() {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_disable_profiling(impl_.get()));
+        }
+
+        //! Save recorded events as Chrome trace_event JSON.
+        /*!
+         * \sa
+         * menoh_model_save_profile_trace()
+         */
+        void save_profile_trace(std::string const& filename) const {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_save_profile_trace(impl_.get(), filename.c_str()));
+        }
+
+        //! Save per-op_type totals of recorded events.
+        /*!
+         * \sa
+         * menoh_model_save_profile_summary()
+         */
+        void save_profile_summary(std::string const& filename) const {
+            MENOH_CPP_API_ERROR_CHECK(menoh_model_save_profile_summary(
+              impl_.get(), filename.c_str()));
+        }
+
+        //! Take memory held by the model.
+        /*! The per-variable breakdown is filled when `with_breakdown` is
+         * true.
+         *
+         * \sa
+         * menoh_model_get_memory_stats()
+         */
+        memory_stats get_memory_stats(bool with_breakdown = false) const {
+            menoh_memory_stats_handle h;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_get_memory_stats(impl_.get(), &h));
+            std::unique_ptr<menoh_memory_stats,
+                            decltype(&menoh_delete_memory_stats)>
+              handle(h, menoh_delete_memory_stats);
+            memory_stats stats;
+            std::pair<memory_category_t, int64_t*> category_list[] = {
+              {memory_category_t::parameter, &stats.parameter_bytes},
+              {memory_category_t::packed_weight, &stats.packed_weight_bytes},
+              {memory_category_t::activation, &stats.activation_bytes},
+              {memory_category_t::scratch, &stats.scratch_bytes},
+              {memory_category_t::io, &stats.io_bytes}};
+            for(auto const& p : category_list) {
+                MENOH_CPP_API_ERROR_CHECK(menoh_memory_stats_get_bytes(
+                  handle.get(), static_cast<menoh_memory_category>(p.first),
+                  p.second));
+            }
+            MENOH_CPP_API_ERROR_CHECK(menoh_memory_stats_get_total_bytes(
+              handle.get(), &stats.total_bytes));
+            if(with_breakdown) {
+                int32_t entry_num;
+                MENOH_CPP_API_ERROR_CHECK(
+                  menoh_memory_stats_get_entry_num(handle.get(), &entry_num));
+                for(int32_t i = 0; i < entry_num; ++i) {
+                    const char* name;
+                    menoh_memory_category category;
+                    int64_t bytes;
+                    MENOH_CPP_API_ERROR_CHECK(menoh_memory_stats_get_entry(
+                      handle.get(), i, &name, &category, &bytes));
+                    stats.entry_list.push_back(
+                      {name, static_cast<memory_category_t>(category), bytes});
+                }
+            }
+            return stats;
+        }
+
+        //! Run model inference with a deadline.
+        /*! error with error_code_t::deadline_exceeded or
+         * error_code_t::run_cancelled is thrown when the run stops early.
+         *
+         * \sa
+         * menoh_model_run_with_deadline()
+         */
+        void run_with_deadline(std::chrono::microseconds timeout,
+                               cancellation_token const* token = nullptr) {
+            MENOH_CPP_API_ERROR_CHECK(menoh_model_run_with_deadline(
+              impl_.get(), timeout.count(), token ? token->get() : nullptr));
+        }
+
+        //! Number of streams. See menoh_model_get_stream_num()
+        int get_stream_num() const {
+            int32_t stream_num;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_get_stream_num(impl_.get(), &stream_num));
+            return stream_num;
+        }
+
+        //! Accsessor to internal variable of the stream.
+        variable get_stream_variable(int stream_index,
+                                     std::string const& name) const {
+            auto var = get_variable(name);
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_get_stream_variable_buffer_handle(
+                impl_.get(), stream_index, name.c_str(), &var.buffer_handle));
+            return var;
+        }
+
+        //! Run batches on all streams.
+        /*! `prepare` and `finish` take batch index and stream index. The
+         * first exception thrown by them is rethrown after all streams stop.
+         *
+         * \sa
+         * menoh_model_run_batches()
+         */
+        void run_batches(int batch_num,
+                         std::function<void(int, int)> const& prepare,
+                         std::function<void(int, int)> const& finish) {
+            struct callback_set {
+                std::function<void(int, int)> const& prepare;
+                std::function<void(int, int)> const& finish;
+                std::mutex mutex;
+                std::exception_ptr exception;
+
+                void call(std::function<void(int, int)> const& f,
+                          int32_t batch_index, int32_t stream_index) {
+                    if(!f) {
+                        return;
+                    }
+                    try {
+                        f(batch_index, stream_index);
+                    } catch(...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if(!exception) {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+            } callbacks{prepare, finish, {}, nullptr};
+            MENOH_CPP_API_ERROR_CHECK(menoh_model_run_batches(
+              impl_.get(), batch_num,
+              [](void* p, int32_t batch_index, int32_t stream_index) {
+                  auto c = static_cast<callback_set*>(p);
+                  c->call(c->prepare, batch_index, stream_index);
+              },
+              [](void* p, int32_t batch_index, int32_t stream_index) {
+                  auto c = static_cast<callback_set*>(p);
+                  c->call(c->finish, batch_index, stream_index);
+              },
+              &callbacks));
+            if(callbacks.exception) {
+                std::rethrow_exception(callbacks.exception);
+            }
+        }
+
     private:
         std::unique_ptr<menoh_model, decltype(&menoh_delete_model)> impl_;
     };
 
+    //! Pool of replicas of a model serving requests.
+    /*!
+     * \sa
+     * menoh_session
+     */
+    class session {
+    public:
+        /*! \note Normally users needn't call this constructer. Use
+         * model_builder::build_session() instead.
+         */
+        explicit session(menoh_session_handle h)
+          : impl_(h, menoh_delete_session) {}
+
+        /*! Accessor to internal handle
+         *
+         * \note Normally users needn't call this function.
+         */
+        menoh_session_handle get() const noexcept { return impl_.get(); }
+
+        int get_replica_num() const {
+            int32_t replica_num;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_session_get_replica_num(impl_.get(), &replica_num));
+            return replica_num;
+        }
+
+        //! Accsessor to buffer of internal variable of the replica.
+        void* get_variable_buffer_handle(int replica_index,
+                                         std::string const& name) const {
+            void* buff;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_session_get_variable_buffer_handle(
+                impl_.get(), replica_index, name.c_str(), &buff));
+            return buff;
+        }
+
+        //! Submit a request.
+        /*! `prepare` takes replica index. `finish` takes replica index and
+         * the exception thrown by `prepare` or the run, which is null when
+         * the request succeeded. Exceptions thrown by `finish` are
+         * ignored.
+         *
+         * \sa
+         * menoh_session_submit()
+         */
+        void submit(
+          std::function<void(int)> prepare,
+          std::function<void(int, std::exception_ptr)> finish) {
+            struct callback_set {
+                std::function<void(int)> prepare;
+                std::function<void(int, std::exception_ptr)> finish;
+                std::exception_ptr exception;
+            };
+            auto callbacks = std::make_unique<callback_set>(
+              callback_set{std::move(prepare), std::move(finish), nullptr});
+            MENOH_CPP_API_ERROR_CHECK(menoh_session_submit(
+              impl_.get(),
+              [](void* p, int32_t replica_index) {
+                  auto c = static_cast<callback_set*>(p);
+                  if(!c->prepare) {
+                      return;
+                  }
+                  try {
+                      c->prepare(replica_index);
+                  } catch(...) {
+                      c->exception = std::current_exception();
+                  }
+              },
+              [](void* p, int32_t replica_index, menoh_error_code ec) {
+                  std::unique_ptr<callback_set> c(
+                    static_cast<callback_set*>(p));
+                  if(!c->finish) {
+                      return;
+                  }
+                  if(!c->exception && ec) {
+                      c->exception = std::make_exception_ptr(
+                        error(ec, menoh_get_last_error_message()));
+                  }
+                  try {
+                      c->finish(replica_index, c->exception);
+                  } catch(...) {}
+              },
+              callbacks.get()));
+            callbacks.release();
+        }
+
+        //! Wait until all submitted requests finish.
+        void wait() {
+            MENOH_CPP_API_ERROR_CHECK(menoh_session_wait(impl_.get()));
+        }
+
+        //! Number of requests waiting in the queue.
+        int get_queue_depth() const {
+            int32_t depth;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_session_get_queue_depth(impl_.get(), &depth));
+            return depth;
+        }
+
+        //! Number of finished requests.
+        int64_t get_completed_request_num() const {
+            int64_t num;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_session_get_completed_request_num(impl_.get(), &num));
+            return num;
+        }
+
+        //! Ratio of time replicas spent in requests.
+        float get_utilization() const {
+            float utilization;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_session_get_utilization(impl_.get(), &utilization));
+            return utilization;
+        }
+
+    private:
+        std::unique_ptr<menoh_session, decltype(&menoh_delete_session)> impl_;
+    };
+
     /*! \brief The builder class to build model.
      *
      */
@@ -417,6 +813,19 @@ namespace menoh {
             return model(h);
         }
 
+        //! Factory function for session
+        /*! Replicas are built with "stream_num" of backend config.
+         */
+        session build_session(model_data const& model_data,
+                              std::string const& backend_name,
+                              std::string const& backend_config = "") {
+            menoh_session_handle h;
+            MENOH_CPP_API_ERROR_CHECK(menoh_build_session(
+              impl_.get(), model_data.get(), backend_name.c_str(),
+              backend_config.c_str(), &h));
+            return session(h);
+        }
+
     private:
         std::unique_ptr<menoh_model_builder,
                         decltype(&menoh_delete_model_builder)>
@@ -424,6 +833,162 @@ namespace menoh {
     };
     /** @} */
 
+    /*! @addtogroup cpp_cost Static cost estimation
+     * @{ */
+    //! Static cost of a node.
+    /*! A multiply-add counts as 2 flops.
+     *
+     * \sa
+     * menoh_model_cost_table
+     */
+    struct node_cost {
+        std::string name; //!< first output name
+        std::string op_type;
+        int64_t flops;
+        int64_t parameter_bytes;
+        int64_t activation_read_bytes;
+        int64_t activation_written_bytes;
+
+        //! Flops per byte moved. 0 when no byte is moved.
+        double arithmetic_intensity() const {
+            auto bytes = parameter_bytes + activation_read_bytes +
+                         activation_written_bytes;
+            return bytes == 0 ? 0.
+                              : static_cast<double>(flops) /
+                                  static_cast<double>(bytes);
+        }
+    };
+
+    //! Static costs of nodes of a model estimated from dims of variables.
+    /*!
+     * \sa
+     * menoh_model_cost_table
+     */
+    class model_cost_table {
+    public:
+        model_cost_table(model_data const& model_data,
+                         variable_profile_table const& variable_profile_table)
+          : impl_(nullptr, menoh_delete_model_cost_table) {
+            menoh_model_cost_table_handle h;
+            MENOH_CPP_API_ERROR_CHECK(menoh_make_model_cost_table(
+              model_data.get(), variable_profile_table.get(), &h));
+            impl_.reset(h);
+        }
+
+        int get_node_num() const {
+            int32_t node_num;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_cost_table_get_node_num(impl_.get(), &node_num));
+            return node_num;
+        }
+
+        node_cost get_node_cost(int index) const {
+            node_cost cost;
+            const char* name;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_cost_table_get_node_name(impl_.get(), index, &name));
+            cost.name = name;
+            const char* op_type;
+            MENOH_CPP_API_ERROR_CHECK(menoh_model_cost_table_get_node_op_type(
+              impl_.get(), index, &op_type));
+            cost.op_type = op_type;
+            get_metrics(cost, [this, index](menoh_cost_metric metric,
+                                            int64_t* dst_value) {
+                return menoh_model_cost_table_get_node_cost(
+                  impl_.get(), index, metric, dst_value);
+            });
+            return cost;
+        }
+
+        //! Sum of costs of all nodes. name and op_type are "total".
+        node_cost get_total_cost() const {
+            node_cost cost;
+            cost.name = "total";
+            cost.op_type = "total";
+            get_metrics(cost, [this](menoh_cost_metric metric,
+                                     int64_t* dst_value) {
+                return menoh_model_cost_table_get_total_cost(
+                  impl_.get(), metric, dst_value);
+            });
+            return cost;
+        }
+
+        //! Save as tab separated table.
+        /*!
+         * \sa
+         * menoh_model_cost_table_save()
+         */
+        void save(std::string const& filename) const {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_model_cost_table_save(impl_.get(), filename.c_str()));
+        }
+
+    private:
+        template <typename F>
+        static void get_metrics(node_cost& cost, F get_metric) {
+            MENOH_CPP_API_ERROR_CHECK(
+              get_metric(menoh_cost_metric_flops, &cost.flops));
+            MENOH_CPP_API_ERROR_CHECK(get_metric(
+              menoh_cost_metric_parameter_bytes, &cost.parameter_bytes));
+            MENOH_CPP_API_ERROR_CHECK(
+              get_metric(menoh_cost_metric_activation_read_bytes,
+                         &cost.activation_read_bytes));
+            MENOH_CPP_API_ERROR_CHECK(
+              get_metric(menoh_cost_metric_activation_written_bytes,
+                         &cost.activation_written_bytes));
+        }
+
+        std::unique_ptr<menoh_model_cost_table,
+                        decltype(&menoh_delete_model_cost_table)>
+          impl_;
+    };
+    /** @} */
+
+    /*! @addtogroup cpp_calibration Calibration
+     * @{ */
+    //! Ranges of variables for int8 inference.
+    /*! Users run a model with representative inputs and call update() after
+     * each run, then save() the table. Its filename is given to
+     * "int8_calibration_table" of backend config to rebuild the model in int8.
+     *
+     * \sa
+     * variable_profile_table_builder::add_calibration_targets()
+     */
+    class calibration_table {
+    public:
+        calibration_table() : impl_(nullptr, menoh_delete_calibration_table) {
+            menoh_calibration_table_handle h;
+            MENOH_CPP_API_ERROR_CHECK(menoh_make_calibration_table(&h));
+            impl_.reset(h);
+        }
+
+        //! Load table saved by save().
+        explicit calibration_table(std::string const& filename)
+          : impl_(nullptr, menoh_delete_calibration_table) {
+            menoh_calibration_table_handle h;
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_make_calibration_table_from_file(filename.c_str(), &h));
+            impl_.reset(h);
+        }
+
+        //! Extend ranges by current values of variables in the model.
+        void update(model const& model) {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_calibration_table_update(impl_.get(), model.get()));
+        }
+
+        void save(std::string const& filename) const {
+            MENOH_CPP_API_ERROR_CHECK(
+              menoh_calibration_table_save(impl_.get(), filename.c_str()));
+        }
+
+    private:
+        std::unique_ptr<menoh_calibration_table,
+                        decltype(&menoh_delete_calibration_table)>
+          impl_;
+    };
+    /** @} */
+
     /** @} */
 
 } // namespace menoh
@@ -39,6 +39,9 @@ namespace menoh_impl {
         } else if(d == dtype_t::int64) {
             auto u = std::make_unique<std::int64_t[]>(total_size);
             return std::shared_ptr<void>(u.release(), u.get_deleter());
+        } else if(d == dtype_t::bfloat16) {
+            auto u = std::make_unique<std::uint16_t[]>(total_size);
+            return std::shared_ptr<void>(u.release(), u.get_deleter());
         }
 
         throw invalid_dtype(std::to_string(static_cast<int>(d)));
@@ -64,4 +67,28 @@ namespace menoh_impl {
         return uniforms(d, dims, 0.);
     }
 
+    void expand_to_float(array const& a, float* dst) {
+        auto size = total_size(a);
+        if(a.dtype() == dtype_t::float16) {
+            auto src = static_cast<std::uint16_t const*>(a.data());
+            std::transform(src, src + size, dst, float16_to_float);
+        } else if(a.dtype() == dtype_t::bfloat16) {
+            auto src = static_cast<std::uint16_t const*>(a.data());
+            std::transform(src, src + size, dst, bfloat16_to_float);
+        } else if(a.dtype() == dtype_t::float_) {
+            std::copy(fbegin(a), fend(a), dst);
+        } else {
+            throw invalid_dtype(std::to_string(static_cast<int>(a.dtype())));
+        }
+    }
+
+    array to_float_array(array const& a) {
+        if(a.dtype() == dtype_t::float_) {
+            return a;
+        }
+        array float_array(dtype_t::float_, a.dims());
+        expand_to_float(a, fbegin(float_array));
+        return float_array;
+    }
+
 } // namespace menoh_impl
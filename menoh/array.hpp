@@ -85,6 +85,13 @@ namespace menoh_impl {
 
     array zeros(dtype_t d, std::vector<int> const& dims);
 
+    // write elements of float, float16 or bfloat16 array `a` into `dst` as
+    // float
+    void expand_to_float(array const& a, float* dst);
+
+    // float array of same values. float array is returned as is
+    array to_float_array(array const& a);
+
     template <dtype_t dtype>
     dtype_to_type_t<dtype>* begin(array const& a) {
         assert(a.dtype() == dtype);
@@ -7,6 +7,8 @@
  */
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <numeric> // for accumulate
 #include <string>
 #include <unordered_map>
@@ -81,6 +83,38 @@ namespace menoh_impl {
             auto output = [&node](auto i){
                 return node.output_name_list.at(i);
             };
+            // constant inputs such as Resize scales are taken into
+            // attributes
+            auto constant_input_of = [&model_data, &node](
+                std::string const& attr_name, std::string const& name) {
+                auto found = std::find_if(
+                    model_data.parameter_name_and_array_list.begin(),
+                    model_data.parameter_name_and_array_list.end(),
+                    [&name](auto const& p){ return p.first == name; });
+                if(found == model_data.parameter_name_and_array_list.end()) {
+                    throw unsupported_operator_attribute(
+                        node.op_type, node.output_name_list.at(0), attr_name,
+                        name, "constant tensor");
+                }
+                return found->second;
+            };
+            // int64 values out of int range (e.g. INT64_MAX used as Slice
+            // ends) are saturated
+            auto int64_constant_input_of = [&constant_input_of](
+                std::string const& attr_name, std::string const& name) {
+                auto arr = constant_input_of(attr_name, name);
+                ints values;
+                std::transform(
+                    menoh_impl::begin<dtype_t::int64>(arr),
+                    menoh_impl::end<dtype_t::int64>(arr),
+                    std::back_inserter(values), [](int64_t v) {
+                        return static_cast<int>(std::max<int64_t>(
+                            std::min<int64_t>(
+                                v, std::numeric_limits<int>::max()),
+                            std::numeric_limits<int>::min()));
+                    });
+                return values;
+            };
             
 if(node.op_type == "Abs") {
     
@@ -390,10 +424,23 @@ auto strides = get<ints>(node.attribute_table.at("strides"));
 static_cast<void>(strides); // maybe unused
 
         
+/* weight of Conv is (C_out, C_in/group, k0, k1, ...) */
+if(dims_of(input(0)).at(1) != dims_of(input(1)).at(1) * group) {
+    throw dimension_mismatch(
+        node.op_type, output(0), "input[1] and weight[1] * group",
+        std::to_string(dims_of(input(0)).at(1)),
+        std::to_string(dims_of(input(1)).at(1) * group));
+}
+/* dilated kernel covers (k - 1) * dilation + 1 elements */
+auto dilated_kernel_shape = kernel_shape;
+for(unsigned int i = 0; i < kernel_ndims; ++i) {
+    dilated_kernel_shape.at(i) =
+        (kernel_shape.at(i) - 1) * dilations.at(i) + 1;
+}
 add_variable_to_table(output(0), dtype_of(input(0)),
     calc_2d_output_dims(
         dims_of(input(0)), dims_of(input(1)).at(0),
-        kernel_shape, strides, pads));
+        dilated_kernel_shape, strides, pads));
 
     }
 }
@@ -411,7 +458,8 @@ auto kernel_shape = ints(weights_shape.begin()+2, weights_shape.end());
     auto found = node.attribute_table.find("dilations");
     if(found == node.attribute_table.end()) {
         
-assert(!"attribute not found: dilations");
+node.attribute_table.emplace(
+    "dilations", ints(kernel_ndims, 1));
 
     }
 }
@@ -443,7 +491,8 @@ node.attribute_table.emplace(
     auto found = node.attribute_table.find("output_padding");
     if(found == node.attribute_table.end()) {
         
-assert(!"attribute not found: output_padding");
+node.attribute_table.emplace(
+    "output_padding", ints(kernel_ndims, 0));
 
     }
 }
@@ -462,9 +511,9 @@ node.attribute_table.emplace(
     
 {
     auto found = node.attribute_table.find("output_shape");
-    assert(!(found == node.attribute_table.end() &&
-       node.attribute_table.find("pads") == node.attribute_table.end()));
-    if(found != node.attribute_table.end()) {
+    if(found == node.attribute_table.end()) {
+        node.attribute_table.emplace("pads", ints(kernel_ndims*2, 0));
+    } else {
         auto output_shape = get<ints>(found->second);
         /* [dim0_begin, dim1_begin, ... , dim0_end, dim1_end, ..., ...] */
         ints pads(kernel_ndims*2, 0);
@@ -508,10 +557,14 @@ auto strides = get<ints>(node.attribute_table.at("strides"));
 static_cast<void>(strides); // maybe unused
 
         
-add_variable_to_table(output(0), dtype_of(input(0)),
-    calc_2d_output_dims_for_conv_transpose(
-        dims_of(input(0)), dims_of(input(1)).at(0),
-        kernel_shape, strides, get<ints>(node.attribute_table.at("pads"))));
+/* weight of ConvTranspose is (C_in, C_out/group, k0, k1, ...) */
+auto output_dims = calc_2d_output_dims_for_conv_transpose(
+    dims_of(input(0)), dims_of(input(1)).at(1) * group,
+    kernel_shape, strides, get<ints>(node.attribute_table.at("pads")));
+for(unsigned int i = 0; i < kernel_ndims; ++i) {
+    output_dims.at(2 + i) += output_padding.at(i);
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
 
     }
 }
@@ -547,6 +600,22 @@ add_variable_to_table(output(0), dtype_of(input(0)), dims_of(input(0)));
 else
 
 
+if(node.op_type == "Exp") {
+    
+    
+    
+    {
+        
+        
+assert(node.input_name_list.size() > 0);
+assert(node.output_name_list.size() > 0);
+add_variable_to_table(output(0), dtype_of(input(0)), dims_of(input(0)));
+
+    }
+}
+else
+
+
 if(node.op_type == "FC") {
     
     
@@ -798,7 +867,7 @@ auto bias = get<float>(node.attribute_table.at("bias"));
 static_cast<void>(bias); // maybe unused
 
 
-auto size = get<float>(node.attribute_table.at("size"));
+auto size = get<int>(node.attribute_table.at("size"));
 static_cast<void>(size); // maybe unused
 
         
@@ -811,6 +880,40 @@ add_variable_to_table(output(0), dtype_of(input(0)), dims_of(input(0)));
 else
 
 
+if(node.op_type == "MatMul") {
+    
+    
+    
+    {
+        
+        
+auto a_dims = dims_of(input(0));
+auto b_dims = dims_of(input(1));
+auto is_a_1d = a_dims.size() == 1;
+auto is_b_1d = b_dims.size() == 1;
+if(is_a_1d) {
+    a_dims.insert(a_dims.begin(), 1);
+}
+if(is_b_1d) {
+    b_dims.push_back(1);
+}
+assert(a_dims.at(a_dims.size()-1) == b_dims.at(b_dims.size()-2));
+auto output_dims = broadcast_shape(
+    ints(a_dims.begin(), a_dims.end()-2),
+    ints(b_dims.begin(), b_dims.end()-2));
+if(!is_a_1d) {
+    output_dims.push_back(a_dims.at(a_dims.size()-2));
+}
+if(!is_b_1d) {
+    output_dims.push_back(b_dims.at(b_dims.size()-1));
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
 if(node.op_type == "MaxPool") {
     
     
@@ -901,6 +1004,234 @@ add_variable_to_table(output(0), dtype_of(input(0)),
 else
 
 
+if(node.op_type == "ReduceMax") {
+    
+ints all_axes(ndims_of(input(0)));
+std::iota(all_axes.begin(), all_axes.end(), 0);
+
+    
+{
+    auto found = node.attribute_table.find("axes");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axes", all_axes);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("keepdims");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "keepdims", 1);
+
+    }
+}
+
+    
+    {
+        
+auto axes = get<ints>(node.attribute_table.at("axes"));
+static_cast<void>(axes); // maybe unused
+
+
+auto keepdims = get<int>(node.attribute_table.at("keepdims"));
+static_cast<void>(keepdims); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+auto ndims = static_cast<int>(input_dims.size());
+ints output_dims;
+for(int i = 0; i < ndims; ++i) {
+    auto is_reduced = std::any_of(axes.begin(), axes.end(),
+        [i, ndims](auto axis){ return (axis < 0 ? axis + ndims : axis) == i; });
+    if(!is_reduced) {
+        output_dims.push_back(input_dims.at(i));
+    } else if(keepdims) {
+        output_dims.push_back(1);
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
+if(node.op_type == "ReduceMean") {
+    
+ints all_axes(ndims_of(input(0)));
+std::iota(all_axes.begin(), all_axes.end(), 0);
+
+    
+{
+    auto found = node.attribute_table.find("axes");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axes", all_axes);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("keepdims");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "keepdims", 1);
+
+    }
+}
+
+    
+    {
+        
+auto axes = get<ints>(node.attribute_table.at("axes"));
+static_cast<void>(axes); // maybe unused
+
+
+auto keepdims = get<int>(node.attribute_table.at("keepdims"));
+static_cast<void>(keepdims); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+auto ndims = static_cast<int>(input_dims.size());
+ints output_dims;
+for(int i = 0; i < ndims; ++i) {
+    auto is_reduced = std::any_of(axes.begin(), axes.end(),
+        [i, ndims](auto axis){ return (axis < 0 ? axis + ndims : axis) == i; });
+    if(!is_reduced) {
+        output_dims.push_back(input_dims.at(i));
+    } else if(keepdims) {
+        output_dims.push_back(1);
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
+if(node.op_type == "ReduceMin") {
+    
+ints all_axes(ndims_of(input(0)));
+std::iota(all_axes.begin(), all_axes.end(), 0);
+
+    
+{
+    auto found = node.attribute_table.find("axes");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axes", all_axes);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("keepdims");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "keepdims", 1);
+
+    }
+}
+
+    
+    {
+        
+auto axes = get<ints>(node.attribute_table.at("axes"));
+static_cast<void>(axes); // maybe unused
+
+
+auto keepdims = get<int>(node.attribute_table.at("keepdims"));
+static_cast<void>(keepdims); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+auto ndims = static_cast<int>(input_dims.size());
+ints output_dims;
+for(int i = 0; i < ndims; ++i) {
+    auto is_reduced = std::any_of(axes.begin(), axes.end(),
+        [i, ndims](auto axis){ return (axis < 0 ? axis + ndims : axis) == i; });
+    if(!is_reduced) {
+        output_dims.push_back(input_dims.at(i));
+    } else if(keepdims) {
+        output_dims.push_back(1);
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
+if(node.op_type == "ReduceSum") {
+    
+ints all_axes(ndims_of(input(0)));
+std::iota(all_axes.begin(), all_axes.end(), 0);
+
+    
+{
+    auto found = node.attribute_table.find("axes");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axes", all_axes);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("keepdims");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "keepdims", 1);
+
+    }
+}
+
+    
+    {
+        
+auto axes = get<ints>(node.attribute_table.at("axes"));
+static_cast<void>(axes); // maybe unused
+
+
+auto keepdims = get<int>(node.attribute_table.at("keepdims"));
+static_cast<void>(keepdims); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+auto ndims = static_cast<int>(input_dims.size());
+ints output_dims;
+for(int i = 0; i < ndims; ++i) {
+    auto is_reduced = std::any_of(axes.begin(), axes.end(),
+        [i, ndims](auto axis){ return (axis < 0 ? axis + ndims : axis) == i; });
+    if(!is_reduced) {
+        output_dims.push_back(input_dims.at(i));
+    } else if(keepdims) {
+        output_dims.push_back(1);
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
 if(node.op_type == "Relu") {
     
     
@@ -955,6 +1286,123 @@ add_variable_to_table(output(0), dtype_of(input(0)), new_dims);
 else
 
 
+if(node.op_type == "Resize") {
+    
+auto is_resize_11 = node.input_name_list.size() > 2;
+if(node.attribute_table.find("scales") == node.attribute_table.end()) {
+    auto input_dims = dims_of(input(0));
+    std::vector<float> scales;
+    if(!is_resize_11) {
+        auto scales_array = constant_input_of("scales", input(1));
+        scales.assign(fbegin(scales_array), fend(scales_array));
+    } else if(!input(2).empty() &&
+              total_size(constant_input_of("scales", input(2))) != 0) {
+        auto scales_array = constant_input_of("scales", input(2));
+        scales.assign(fbegin(scales_array), fend(scales_array));
+    } else {
+        if(node.input_name_list.size() < 4) {
+            throw unsupported_operator_attribute(
+                node.op_type, node.output_name_list.at(0), "scales",
+                "empty", "scales or sizes");
+        }
+        auto sizes = int64_constant_input_of("sizes", input(3));
+        for(unsigned int i = 0; i < sizes.size(); ++i) {
+            scales.push_back(
+                static_cast<float>(sizes.at(i)) / input_dims.at(i));
+        }
+        node.attribute_table.emplace("sizes", sizes);
+    }
+    node.attribute_table.emplace("scales", scales);
+}
+node.attribute_table.emplace("coordinate_transformation_mode",
+    std::string(is_resize_11 ? "half_pixel" : "asymmetric"));
+node.attribute_table.emplace("nearest_mode",
+    std::string(is_resize_11 ? "round_prefer_floor" : "floor"));
+node.input_name_list.resize(1); // X only
+
+    
+{
+    auto found = node.attribute_table.find("mode");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "mode", std::string("nearest"));
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("scales");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: scales");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("coordinate_transformation_mode");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: coordinate_transformation_mode");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("nearest_mode");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: nearest_mode");
+
+    }
+}
+
+    
+    {
+        
+auto mode = get<std::string>(node.attribute_table.at("mode"));
+static_cast<void>(mode); // maybe unused
+
+
+auto scales = get<std::vector<float>>(node.attribute_table.at("scales"));
+static_cast<void>(scales); // maybe unused
+
+
+auto coordinate_transformation_mode = get<std::string>(node.attribute_table.at("coordinate_transformation_mode"));
+static_cast<void>(coordinate_transformation_mode); // maybe unused
+
+
+auto nearest_mode = get<std::string>(node.attribute_table.at("nearest_mode"));
+static_cast<void>(nearest_mode); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+if(scales.size() != input_dims.size()) {
+    throw dimension_mismatch(
+        node.op_type, output(0), "size of scales and ndims of input",
+        std::to_string(scales.size()), std::to_string(input_dims.size()));
+}
+ints output_dims;
+auto found = node.attribute_table.find("sizes");
+if(found != node.attribute_table.end()) {
+    output_dims = get<ints>(found->second);
+} else {
+    for(unsigned int i = 0; i < input_dims.size(); ++i) {
+        output_dims.push_back(
+            static_cast<int>(std::floor(input_dims.at(i) * scales.at(i))));
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
 if(node.op_type == "Sigmoid") {
     
     
@@ -971,6 +1419,127 @@ add_variable_to_table(output(0), dtype_of(input(0)), dims_of(input(0)));
 else
 
 
+if(node.op_type == "Slice") {
+    
+// Slice-10 takes starts, ends, axes and steps as inputs
+if(node.input_name_list.size() > 1) {
+    std::vector<std::string> names{"", "starts", "ends", "axes", "steps"};
+    for(unsigned int i = 1; i < node.input_name_list.size(); ++i) {
+        if(!input(i).empty()) {
+            node.attribute_table.emplace(
+                names.at(i), int64_constant_input_of(names.at(i), input(i)));
+        }
+    }
+    node.input_name_list.resize(1); // data only
+}
+auto starts_size = attribute_ints(node, "starts").size();
+ints default_axes(starts_size);
+std::iota(default_axes.begin(), default_axes.end(), 0);
+
+    
+{
+    auto found = node.attribute_table.find("starts");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: starts");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("ends");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: ends");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("axes");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axes", default_axes);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("steps");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "steps", ints(starts_size, 1));
+
+    }
+}
+
+    
+    {
+        
+auto starts = get<ints>(node.attribute_table.at("starts"));
+static_cast<void>(starts); // maybe unused
+
+
+auto ends = get<ints>(node.attribute_table.at("ends"));
+static_cast<void>(ends); // maybe unused
+
+
+auto axes = get<ints>(node.attribute_table.at("axes"));
+static_cast<void>(axes); // maybe unused
+
+
+auto steps = get<ints>(node.attribute_table.at("steps"));
+static_cast<void>(steps); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+int ndims = static_cast<int>(input_dims.size());
+if(ends.size() != starts.size() || axes.size() != starts.size() ||
+   steps.size() != starts.size()) {
+    throw dimension_mismatch(
+        node.op_type, output(0), "size of starts, ends, axes and steps",
+        std::to_string(starts.size()), std::to_string(ends.size()));
+}
+auto output_dims = input_dims;
+for(unsigned int i = 0; i < starts.size(); ++i) {
+    auto axis = axes.at(i) < 0 ? axes.at(i) + ndims : axes.at(i);
+    if(axis < 0 || ndims <= axis) {
+        throw unsupported_operator_attribute(
+            node.op_type, output(0), "axes", std::to_string(axes.at(i)),
+            "[" + std::to_string(-ndims) + ", " +
+                std::to_string(ndims - 1) + "]");
+    }
+    auto step = steps.at(i);
+    if(step == 0) {
+        throw unsupported_operator_attribute(
+            node.op_type, output(0), "steps", "0", "non zero");
+    }
+    auto dim = input_dims.at(axis);
+    auto start = starts.at(i) < 0 ? starts.at(i) + dim : starts.at(i);
+    auto end = ends.at(i) < 0 ? ends.at(i) + dim : ends.at(i);
+    if(0 < step) {
+        start = std::max(0, std::min(start, dim));
+        end = std::max(0, std::min(end, dim));
+        output_dims.at(axis) = std::max(0, (end - start + step - 1) / step);
+    } else {
+        start = std::max(0, std::min(start, dim - 1));
+        end = std::max(-1, std::min(end, dim - 1));
+        output_dims.at(axis) =
+            std::max(0, (start - end - step - 1) / -step);
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
+
 if(node.op_type == "Softmax") {
     
     
@@ -1000,6 +1569,89 @@ add_variable_to_table(output(0), dtype_of(input(0)), dims_of(input(0)));
 else
 
 
+if(node.op_type == "Split") {
+    
+// Split-13 takes split as input(1)
+if(node.input_name_list.size() > 1) {
+    if(!input(1).empty()) {
+        node.attribute_table.emplace(
+            "split", int64_constant_input_of("split", input(1)));
+    }
+    node.input_name_list.resize(1); // input only
+}
+ints equal_split;
+if(node.attribute_table.find("split") == node.attribute_table.end()) {
+    auto input_dims = dims_of(input(0));
+    auto split_axis = optional_attribute_int(node, "axis", 0);
+    if(split_axis < 0) {
+        split_axis += static_cast<int>(input_dims.size());
+    }
+    auto output_num = static_cast<int>(node.output_name_list.size());
+    equal_split =
+        ints(output_num, input_dims.at(split_axis) / output_num);
+}
+
+    
+{
+    auto found = node.attribute_table.find("axis");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "axis", 0);
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("split");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "split", equal_split);
+
+    }
+}
+
+    
+    {
+        
+auto axis = get<int>(node.attribute_table.at("axis"));
+static_cast<void>(axis); // maybe unused
+
+
+auto split = get<ints>(node.attribute_table.at("split"));
+static_cast<void>(split); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+int ndims = static_cast<int>(input_dims.size());
+if(axis < -ndims || ndims <= axis) {
+    throw unsupported_operator_attribute(
+        node.op_type, output(0), "axis", std::to_string(axis),
+        "[" + std::to_string(-ndims) + ", " + std::to_string(ndims - 1) + "]");
+}
+if(axis < 0) {
+    axis += ndims;
+}
+if(split.size() != node.output_name_list.size() ||
+   std::accumulate(split.begin(), split.end(), 0) != input_dims.at(axis)) {
+    throw dimension_mismatch(
+        node.op_type, output(0), "sum of split and input dims of axis",
+        std::to_string(std::accumulate(split.begin(), split.end(), 0)),
+        std::to_string(input_dims.at(axis)));
+}
+for(unsigned int i = 0; i < split.size(); ++i) {
+    auto output_dims = input_dims;
+    output_dims.at(axis) = split.at(i);
+    add_variable_to_table(output(i), dtype_of(input(0)), output_dims);
+}
+
+    }
+}
+else
+
+
 if(node.op_type == "Sum") {
     
     
@@ -1084,6 +1736,123 @@ add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
 }
 else
 
+
+if(node.op_type == "Upsample") {
+    
+auto is_resize_11 = node.input_name_list.size() > 2;
+if(node.attribute_table.find("scales") == node.attribute_table.end()) {
+    auto input_dims = dims_of(input(0));
+    std::vector<float> scales;
+    if(!is_resize_11) {
+        auto scales_array = constant_input_of("scales", input(1));
+        scales.assign(fbegin(scales_array), fend(scales_array));
+    } else if(!input(2).empty() &&
+              total_size(constant_input_of("scales", input(2))) != 0) {
+        auto scales_array = constant_input_of("scales", input(2));
+        scales.assign(fbegin(scales_array), fend(scales_array));
+    } else {
+        if(node.input_name_list.size() < 4) {
+            throw unsupported_operator_attribute(
+                node.op_type, node.output_name_list.at(0), "scales",
+                "empty", "scales or sizes");
+        }
+        auto sizes = int64_constant_input_of("sizes", input(3));
+        for(unsigned int i = 0; i < sizes.size(); ++i) {
+            scales.push_back(
+                static_cast<float>(sizes.at(i)) / input_dims.at(i));
+        }
+        node.attribute_table.emplace("sizes", sizes);
+    }
+    node.attribute_table.emplace("scales", scales);
+}
+node.attribute_table.emplace("coordinate_transformation_mode",
+    std::string(is_resize_11 ? "half_pixel" : "asymmetric"));
+node.attribute_table.emplace("nearest_mode",
+    std::string(is_resize_11 ? "round_prefer_floor" : "floor"));
+node.input_name_list.resize(1); // X only
+
+    
+{
+    auto found = node.attribute_table.find("mode");
+    if(found == node.attribute_table.end()) {
+        
+node.attribute_table.emplace(
+    "mode", std::string("nearest"));
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("scales");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: scales");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("coordinate_transformation_mode");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: coordinate_transformation_mode");
+
+    }
+}
+
+
+{
+    auto found = node.attribute_table.find("nearest_mode");
+    if(found == node.attribute_table.end()) {
+        
+assert(!"attribute not found: nearest_mode");
+
+    }
+}
+
+    
+    {
+        
+auto mode = get<std::string>(node.attribute_table.at("mode"));
+static_cast<void>(mode); // maybe unused
+
+
+auto scales = get<std::vector<float>>(node.attribute_table.at("scales"));
+static_cast<void>(scales); // maybe unused
+
+
+auto coordinate_transformation_mode = get<std::string>(node.attribute_table.at("coordinate_transformation_mode"));
+static_cast<void>(coordinate_transformation_mode); // maybe unused
+
+
+auto nearest_mode = get<std::string>(node.attribute_table.at("nearest_mode"));
+static_cast<void>(nearest_mode); // maybe unused
+
+        
+auto input_dims = dims_of(input(0));
+if(scales.size() != input_dims.size()) {
+    throw dimension_mismatch(
+        node.op_type, output(0), "size of scales and ndims of input",
+        std::to_string(scales.size()), std::to_string(input_dims.size()));
+}
+ints output_dims;
+auto found = node.attribute_table.find("sizes");
+if(found != node.attribute_table.end()) {
+    output_dims = get<ints>(found->second);
+} else {
+    for(unsigned int i = 0; i < input_dims.size(); ++i) {
+        output_dims.push_back(
+            static_cast<int>(std::floor(input_dims.at(i) * scales.at(i))));
+    }
+}
+add_variable_to_table(output(0), dtype_of(input(0)), output_dims);
+
+    }
+}
+else
+
             
 {
     throw unsupported_operator(node.op_type);
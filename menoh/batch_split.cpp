@@ -0,0 +1,264 @@
+#include <menoh/batch_split.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <menoh/attribute_completion_and_shape_inference.hpp>
+#include <menoh/exception.hpp>
+#include <menoh/json.hpp>
+#include <menoh/multi_stream.hpp>
+
+namespace menoh_impl {
+
+    optional<batch_split_config>
+    parse_batch_split_config(std::string const& config) {
+        if(config.empty()) {
+            return nullopt;
+        }
+        auto c = nlohmann::json::parse(config);
+        if(c.find("sub_batch_size") == c.end()) {
+            return nullopt;
+        }
+        batch_split_config split;
+        split.sub_batch_size = c["sub_batch_size"].get<int>();
+        if(split.sub_batch_size < 1) {
+            throw invalid_backend_config_error(
+              "invalid value of \"sub_batch_size\": " +
+              std::to_string(split.sub_batch_size));
+        }
+        split.is_sequential = false;
+        if(c.find("sub_batch_mode") != c.end()) {
+            auto mode = c["sub_batch_mode"].get<std::string>();
+            if(mode == "sequential") {
+                split.is_sequential = true;
+            } else if(mode != "concurrent") {
+                throw invalid_backend_config_error(
+                  "invalid value of \"sub_batch_mode\": " + mode);
+            }
+        }
+        return split;
+    }
+
+    batch_split_model_core::batch_split_model_core(
+      std::vector<sub_batch_group> group_list, int batch_size,
+      int sub_batch_size)
+      : group_list_(std::move(group_list)),
+        batch_size_(batch_size),
+        sub_batch_size_(sub_batch_size) {}
+
+    void batch_split_model_core::do_run(run_control const* control) {
+        if(group_list_.size() == 1) {
+            run_group(0, control);
+            return;
+        }
+
+        std::mutex mutex;
+        std::exception_ptr exception;
+        auto work = [&](int group_index) {
+            try {
+                run_group(group_index, control);
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        };
+
+        // the calling thread runs the first group
+        std::vector<std::thread> worker_list;
+        for(int i = 1; i < static_cast<int>(group_list_.size()); ++i) {
+            worker_list.emplace_back(work, i);
+        }
+        work(0);
+        for(auto& worker : worker_list) {
+            worker.join();
+        }
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void batch_split_model_core::do_set_profiler(
+      std::shared_ptr<profiler> const& profiler) {
+        for(auto& group : group_list_) {
+            group.core->set_profiler(profiler);
+        }
+    }
+
+    // the profiler of the first group
+    std::shared_ptr<profiler> batch_split_model_core::do_get_profiler() const {
+        return group_list_.front().core->get_profiler();
+    }
+
+    // buffers of sub-batches are io of their cores
+    void
+    batch_split_model_core::do_collect_memory_stats(memory_stats& stats) const {
+        for(auto const& group : group_list_) {
+            for(auto buffer_list :
+                {&group.input_buffer_list, &group.output_buffer_list}) {
+                for(auto const& b : *buffer_list) {
+                    stats.add(b.name, memory_category::io, b.buffer);
+                }
+            }
+            group.core->collect_memory_stats(stats);
+        }
+    }
+
+    namespace {
+        // bytes of one sample in the array
+        std::size_t sample_size_in_bytes(array const& arr) {
+            return total_size(arr) / arr.dims().front() *
+                   get_size_in_bytes(arr.dtype());
+        }
+    } // namespace
+
+    void batch_split_model_core::run_group(int group_index,
+                                           run_control const* control) {
+        auto const& group = group_list_.at(group_index);
+        int group_num = static_cast<int>(group_list_.size());
+        for(int first = group_index * sub_batch_size_; first < batch_size_;
+            first += group_num * sub_batch_size_) {
+            int n = std::min(sub_batch_size_, batch_size_ - first);
+            for(auto const& b : group.input_buffer_list) {
+                auto size = sample_size_in_bytes(b.buffer);
+                std::memcpy(b.buffer.data(),
+                            static_cast<char*>(b.whole.data()) + first * size,
+                            n * size);
+            }
+            if(control) {
+                group.core->run(*control);
+            } else {
+                group.core->run();
+            }
+            for(auto const& b : group.output_buffer_list) {
+                auto size = sample_size_in_bytes(b.buffer);
+                std::memcpy(static_cast<char*>(b.whole.data()) + first * size,
+                            b.buffer.data(), n * size);
+            }
+        }
+    }
+
+    namespace {
+        std::vector<int> with_batch_size(std::vector<int> dims,
+                                         int batch_size) {
+            dims.front() = batch_size;
+            return dims;
+        }
+
+        // profiles of all variables when inputs have `sub_batch_size`
+        // samples. Required outputs must have them too
+        std::unordered_map<std::string, array_profile> infer_sub_batch_profile(
+          std::unordered_map<std::string, array> const& input_table,
+          std::unordered_map<std::string, array> const& required_output_table,
+          menoh_impl::model_data const& model_data, int sub_batch_size) {
+            std::unordered_map<std::string, array_profile> input_profile_table;
+            for(auto const& p : input_table) {
+                input_profile_table.emplace(
+                  p.first,
+                  array_profile(p.second.dtype(),
+                                with_batch_size(p.second.dims(),
+                                                sub_batch_size)));
+            }
+            auto model_data_copy = model_data;
+            auto profile_table = complete_attribute_and_infer_shape(
+              model_data_copy, input_profile_table);
+            for(auto const& p : required_output_table) {
+                auto const& dims = profile_table.at(p.first).dims();
+                if(dims.empty() ||
+                   dims != with_batch_size(p.second.dims(), sub_batch_size)) {
+                    throw invalid_backend_config_error(
+                      "\"sub_batch_size\" is given but output " + p.first +
+                      " does not have the batch as its first axis");
+                }
+            }
+            return profile_table;
+        }
+    } // namespace
+
+    std::unique_ptr<model_core> make_batch_split_model_core(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      menoh_impl::model_data const& model_data,
+      batch_split_config const& config,
+      optional<cpu_placement> const& placement,
+      std::function<std::unique_ptr<model_core>(
+        std::unordered_map<std::string, array> const&,
+        std::unordered_map<std::string, array> const&,
+        std::unordered_map<std::string, array_profile> const&,
+        optional<cpu_placement> const&)> const& make_sub_core) {
+        optional<int> batch_size_opt;
+        for(auto const& p : input_table) {
+            auto const& dims = p.second.dims();
+            if(dims.empty() ||
+               (batch_size_opt && *batch_size_opt != dims.front())) {
+                throw invalid_backend_config_error(
+                  "\"sub_batch_size\" is given but input " + p.first +
+                  " does not have the batch as its first axis");
+            }
+            batch_size_opt = dims.front();
+        }
+        for(auto const& p : required_output_table) {
+            auto const& dims = p.second.dims();
+            if(dims.empty() || dims.front() != batch_size_opt.value_or(0)) {
+                throw invalid_backend_config_error(
+                  "\"sub_batch_size\" is given but output " + p.first +
+                  " does not have the batch as its first axis");
+            }
+        }
+        if(!batch_size_opt || *batch_size_opt <= config.sub_batch_size) {
+            return nullptr;
+        }
+        int batch_size = *batch_size_opt;
+        int sub_batch_size = config.sub_batch_size;
+
+        // sub-batches are assigned to groups of cpus in turn. There are not
+        // more groups than sub-batches or cpus
+        int group_num = 1;
+        std::vector<optional<cpu_placement>> placement_list{placement};
+        if(!config.is_sequential) {
+            int sub_batch_num =
+              (batch_size + sub_batch_size - 1) / sub_batch_size;
+            auto cpu_num = static_cast<int>(
+              placement && !placement->cpu_list.empty()
+                ? placement->cpu_list.size()
+                : current_thread_cpu_list().size());
+            group_num = cpu_num == 0 ? sub_batch_num
+                                     : std::min(sub_batch_num, cpu_num);
+            auto group_placement_list =
+              partition_cpu_placement(placement, group_num);
+            placement_list.assign(group_placement_list.begin(),
+                                  group_placement_list.end());
+        }
+
+        auto profile_table = infer_sub_batch_profile(
+          input_table, required_output_table, model_data, sub_batch_size);
+        std::vector<sub_batch_group> group_list;
+        for(int g = 0; g < group_num; ++g) {
+            sub_batch_group group;
+            std::unordered_map<std::string, array> sub_input_table;
+            for(auto const& p : input_table) {
+                array buffer(profile_table.at(p.first));
+                sub_input_table.emplace(p.first, buffer);
+                group.input_buffer_list.push_back(
+                  sub_batch_buffer{p.first, p.second, buffer});
+            }
+            std::unordered_map<std::string, array> sub_output_table;
+            for(auto const& p : required_output_table) {
+                array buffer(profile_table.at(p.first));
+                sub_output_table.emplace(p.first, buffer);
+                group.output_buffer_list.push_back(
+                  sub_batch_buffer{p.first, p.second, buffer});
+            }
+            group.core = make_sub_core(sub_input_table, sub_output_table,
+                                       profile_table, placement_list.at(g));
+            group_list.push_back(std::move(group));
+        }
+        return std::make_unique<batch_split_model_core>(
+          std::move(group_list), batch_size, sub_batch_size);
+    }
+
+} // namespace menoh_impl
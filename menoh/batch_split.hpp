@@ -0,0 +1,95 @@
+#ifndef MENOH_BATCH_SPLIT_HPP
+#define MENOH_BATCH_SPLIT_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/cpu_placement.hpp>
+#include <menoh/model_core.hpp>
+#include <menoh/model_data.hpp>
+#include <menoh/optional.hpp>
+
+namespace menoh_impl {
+
+    // "sub_batch_size" and "sub_batch_mode" in backend config. The mode is
+    // "concurrent" (default) or "sequential"
+    struct batch_split_config {
+        int sub_batch_size;
+        bool is_sequential;
+    };
+
+    // nullopt when "sub_batch_size" is not given
+    optional<batch_split_config>
+    parse_batch_split_config(std::string const& config);
+
+    // a variable of the whole batch and the buffer of a sub-batch core
+    struct sub_batch_buffer {
+        std::string name;
+        array whole;
+        array buffer;
+    };
+
+    // a core built for a sub-batch and its input and output buffers
+    struct sub_batch_group {
+        std::unique_ptr<model_core> core;
+        std::vector<sub_batch_buffer> input_buffer_list;
+        std::vector<sub_batch_buffer> output_buffer_list;
+    };
+
+    // Runs a batch as sub-batches split along the first axis of all inputs
+    // and required outputs. Each group has one core built for a sub-batch,
+    // which runs the sub-batches assigned to the group in turn. Slices of
+    // inputs are copied into its buffers and its outputs are copied back to
+    // the slices. The last sub-batch may fill the core partially.
+    //
+    // In concurrent mode sub-batches are assigned to groups of cpus in turn
+    // and the groups run concurrently, so memory of activations grows with
+    // the number of groups, not of sub-batches. In sequential mode one group
+    // runs all sub-batches, which bounds it to one sub-batch
+    class batch_split_model_core final : public model_core {
+    public:
+        // group g runs sub-batches g, g + group_num, ...
+        batch_split_model_core(std::vector<sub_batch_group> group_list,
+                               int batch_size, int sub_batch_size);
+
+    private:
+        virtual void do_run(run_control const* control) override;
+        virtual void
+        do_set_profiler(std::shared_ptr<profiler> const& profiler) override;
+        virtual std::shared_ptr<profiler> do_get_profiler() const override;
+        virtual void
+        do_collect_memory_stats(memory_stats& stats) const override;
+
+        void run_group(int group_index, run_control const* control);
+
+        std::vector<sub_batch_group> group_list_;
+        int batch_size_;
+        int sub_batch_size_;
+    };
+
+    // Returns nullptr when the batch is not larger than the sub-batch.
+    // `make_sub_core` builds a core of the sub-batch from its input and
+    // output tables, profiles of its variables and the placement of its
+    // group. Groups are split from `placement` in concurrent mode and there
+    // are not more of them than sub-batches or cpus.
+    // invalid_backend_config_error is thrown when inputs or required
+    // outputs do not have the batch as their first axis
+    std::unique_ptr<model_core> make_batch_split_model_core(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      menoh_impl::model_data const& model_data,
+      batch_split_config const& config,
+      optional<cpu_placement> const& placement,
+      std::function<std::unique_ptr<model_core>(
+        std::unordered_map<std::string, array> const&,
+        std::unordered_map<std::string, array> const&,
+        std::unordered_map<std::string, array_profile> const&,
+        optional<cpu_placement> const&)> const& make_sub_core);
+
+} // namespace menoh_impl
+
+#endif // MENOH_BATCH_SPLIT_HPP
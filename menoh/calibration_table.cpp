@@ -0,0 +1,126 @@
+#include <menoh/calibration_table.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <unordered_set>
+
+#include <menoh/dtype.hpp>
+#include <menoh/exception.hpp>
+#include <menoh/json.hpp>
+
+namespace menoh_impl {
+
+    void update_calibration_table(calibration_table& table,
+                                  std::string const& name, array const& arr) {
+        if(arr.dtype() != dtype_t::float_ || total_size(arr) == 0) {
+            return;
+        }
+        auto const& dims = arr.dims();
+        int channel_num = dims.size() >= 2 ? dims.at(1) : 1;
+        std::size_t outer = dims.empty() ? 1 : dims.at(0);
+        std::size_t inner = total_size(arr) / (outer * channel_num);
+
+        auto found = table.find(name);
+        if(found == table.end()) {
+            auto inf = std::numeric_limits<float>::infinity();
+            found = table
+                      .emplace(name, variable_range{
+                                       inf, -inf,
+                                       std::vector<float>(channel_num, inf),
+                                       std::vector<float>(channel_num, -inf)})
+                      .first;
+        }
+        auto& range = found->second;
+        if(static_cast<int>(range.channel_min_list.size()) != channel_num) {
+            throw calibration_channel_num_mismatch(
+              name, channel_num,
+              static_cast<int>(range.channel_min_list.size()));
+        }
+
+        float const* x = fbegin(arr);
+        for(std::size_t o = 0; o < outer; ++o) {
+            for(int c = 0; c < channel_num; ++c) {
+                float const* first = x + (o * channel_num + c) * inner;
+                auto minmax = std::minmax_element(first, first + inner);
+                range.channel_min_list.at(c) =
+                  std::min(range.channel_min_list.at(c), *minmax.first);
+                range.channel_max_list.at(c) =
+                  std::max(range.channel_max_list.at(c), *minmax.second);
+            }
+        }
+        range.min = std::min(range.min,
+                             *std::min_element(range.channel_min_list.begin(),
+                                               range.channel_min_list.end()));
+        range.max = std::max(range.max,
+                             *std::max_element(range.channel_max_list.begin(),
+                                               range.channel_max_list.end()));
+    }
+
+    std::vector<std::string>
+    extract_calibration_target_name_list(model_data const& model_data) {
+        std::unordered_set<std::string> output_name_set;
+        for(auto const& node : model_data.node_list) {
+            output_name_set.insert(node.output_name_list.begin(),
+                                   node.output_name_list.end());
+        }
+        std::vector<std::string> target_name_list;
+        for(auto const& node : model_data.node_list) {
+            if(node.op_type != "Conv" && node.op_type != "FC" &&
+               node.op_type != "Gemm") {
+                continue;
+            }
+            auto const& name = node.input_name_list.at(0);
+            if(output_name_set.find(name) != output_name_set.end() &&
+               std::find(target_name_list.begin(), target_name_list.end(),
+                         name) == target_name_list.end()) {
+                target_name_list.push_back(name);
+            }
+        }
+        return target_name_list;
+    }
+
+    void save_calibration_table(calibration_table const& table,
+                                std::string const& filename) {
+        nlohmann::json variables = nlohmann::json::object();
+        for(auto const& p : table) {
+            variables[p.first] = {{"min", p.second.min},
+                                  {"max", p.second.max},
+                                  {"channel_min", p.second.channel_min_list},
+                                  {"channel_max", p.second.channel_max_list}};
+        }
+        nlohmann::json j = {{"version", 1}, {"variables", variables}};
+
+        std::ofstream ofs(filename);
+        if(!ofs) {
+            throw invalid_filename(filename);
+        }
+        ofs << j.dump(2) << std::endl;
+    }
+
+    calibration_table load_calibration_table(std::string const& filename) {
+        std::ifstream ifs(filename);
+        if(!ifs) {
+            throw invalid_filename(filename);
+        }
+        calibration_table table;
+        try {
+            nlohmann::json j;
+            ifs >> j;
+            for(auto it = j.at("variables").begin();
+                it != j.at("variables").end(); ++it) {
+                auto const& v = it.value();
+                table.emplace(
+                  it.key(),
+                  variable_range{
+                    v.at("min").get<float>(), v.at("max").get<float>(),
+                    v.at("channel_min").get<std::vector<float>>(),
+                    v.at("channel_max").get<std::vector<float>>()});
+            }
+        } catch(nlohmann::json::exception const& e) {
+            throw json_parse_error(filename + ": " + e.what());
+        }
+        return table;
+    }
+
+} // namespace menoh_impl
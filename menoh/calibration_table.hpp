@@ -0,0 +1,56 @@
+#ifndef MENOH_CALIBRATION_TABLE_HPP
+#define MENOH_CALIBRATION_TABLE_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/exception.hpp>
+#include <menoh/model_data.hpp>
+
+namespace menoh_impl {
+
+    class calibration_channel_num_mismatch : public exception {
+    public:
+        calibration_channel_num_mismatch(std::string const& name,
+                                         int actual_channel_num,
+                                         int recorded_channel_num)
+          : exception(menoh_error_code_dimension_mismatch,
+                      "menoh calibration channel num mismatch error: \"" +
+                        name + "\" has " +
+                        std::to_string(actual_channel_num) +
+                        " channels but calibration table has " +
+                        std::to_string(recorded_channel_num)) {}
+    };
+
+    // range of values of a variable observed in calibration runs.
+    // channel ranges are along axis 1 (c of nchw and nc)
+    struct variable_range {
+        float min;
+        float max;
+        std::vector<float> channel_min_list;
+        std::vector<float> channel_max_list;
+    };
+
+    using calibration_table =
+      std::unordered_map<std::string, variable_range>;
+
+    // extend range of `name` by values in `arr`. non float arrays are
+    // ignored
+    void update_calibration_table(calibration_table& table,
+                                  std::string const& name, array const& arr);
+
+    // names of variables whose ranges are needed to quantize the model:
+    // activation inputs of Conv, FC and Gemm which are computed by nodes
+    std::vector<std::string>
+    extract_calibration_target_name_list(model_data const& model_data);
+
+    // calibration table is saved as JSON
+    void save_calibration_table(calibration_table const& table,
+                                std::string const& filename);
+    calibration_table load_calibration_table(std::string const& filename);
+
+} // namespace menoh_impl
+
+#endif // MENOH_CALIBRATION_TABLE_HPP
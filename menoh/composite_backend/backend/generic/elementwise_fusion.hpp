@@ -0,0 +1,131 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_ELEMENTWISE_FUSION_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_ELEMENTWISE_FUSION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/optional.hpp>
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/math.hpp>
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // Elementwise kernel applied to a chunk of values in place.
+            // `operand` is nullptr for unary operations
+            using elementwise_kernel = void (*)(float* value,
+                                                float const* operand, int size);
+
+            inline void relu_kernel(float* value, float const*, int size) {
+                for(int i = 0; i < size; ++i) {
+                    value[i] = std::max(value[i], 0.f);
+                }
+            }
+
+            inline void mul_kernel(float* value, float const* operand,
+                                   int size) {
+                for(int i = 0; i < size; ++i) {
+                    value[i] *= operand[i];
+                }
+            }
+
+            inline void identity_kernel(float*, float const*, int) {}
+
+            struct fusible_elementwise_op {
+                elementwise_kernel kernel;
+                int arity;
+            };
+
+            template <void (*F)(math_accuracy, float const*, float*, int),
+                      math_accuracy Accuracy>
+            inline void math_kernel(float* value, float const*, int size) {
+                F(Accuracy, value, value, size);
+            }
+
+            template <void (*F)(math_accuracy, float const*, float*, int)>
+            inline elementwise_kernel
+            select_math_kernel(math_accuracy accuracy) {
+                return accuracy == math_accuracy::fast
+                         ? math_kernel<F, math_accuracy::fast>
+                         : math_kernel<F, math_accuracy::exact>;
+            }
+
+            inline optional<fusible_elementwise_op>
+            find_fusible_elementwise_op(std::string const& op_type,
+                                        math_accuracy accuracy) {
+                if(op_type == "Exp") {
+                    return fusible_elementwise_op{
+                      select_math_kernel<vexp>(accuracy), 1};
+                }
+                if(op_type == "Identity") {
+                    return fusible_elementwise_op{identity_kernel, 1};
+                }
+                if(op_type == "Mul") {
+                    return fusible_elementwise_op{mul_kernel, 2};
+                }
+                if(op_type == "Relu") {
+                    return fusible_elementwise_op{relu_kernel, 1};
+                }
+                if(op_type == "Sigmoid") {
+                    return fusible_elementwise_op{
+                      select_math_kernel<vsigmoid>(accuracy), 1};
+                }
+                if(op_type == "Tanh") {
+                    return fusible_elementwise_op{
+                      select_math_kernel<vtanh>(accuracy), 1};
+                }
+                return nullopt;
+            }
+
+            struct elementwise_stage {
+                elementwise_kernel kernel;
+                optional<array> operand;
+            };
+
+            // Run all stages over the input in one pass. Intermediate values
+            // live in a small per-thread chunk so no intermediate array is
+            // allocated and each tensor is streamed from memory only once
+            inline procedure
+            make_fused_elementwise(array const& input,
+                                   std::vector<elementwise_stage> const& stages,
+                                   array const& output) {
+                assert(total_size(input) == total_size(output));
+                for(auto const& stage : stages) {
+                    static_cast<void>(stage); // maybe unused
+                    assert(!stage.operand ||
+                           total_size(*stage.operand) == total_size(input));
+                }
+                return [input, stages, output]() {
+                    constexpr int chunk_size = 1024;
+                    int size = static_cast<int>(total_size(input));
+                    int chunk_num = (size + chunk_size - 1) / chunk_size;
+                    float const* x = fbegin(input);
+                    float* y = fbegin(output);
+                    parallel_for(0, chunk_num, [&](int c) {
+                        int offset = c * chunk_size;
+                        int n = std::min(chunk_size, size - offset);
+                        alignas(64) float value[chunk_size];
+                        std::copy(x + offset, x + offset + n, value);
+                        for(auto const& stage : stages) {
+                            stage.kernel(value,
+                                         stage.operand
+                                           ? fbegin(*stage.operand) + offset
+                                           : nullptr,
+                                         n);
+                        }
+                        std::copy(value, value + n, y + offset);
+                    });
+                };
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_ELEMENTWISE_FUSION_HPP
@@ -1,24 +1,55 @@
 #include <menoh/composite_backend/backend/generic/generic_context.hpp>
 #include <menoh/composite_backend/backend/generic/operator.hpp>
 
+#include <algorithm>
+#include <functional>
+
+#include <menoh/composite_backend/backend/generic/elementwise_fusion.hpp>
+
 namespace menoh_impl {
     namespace composite_backend {
         namespace generic_backend {
 
-            generic_context::generic_context() : context() {
+            generic_context::generic_context(math_accuracy accuracy)
+              : context(), accuracy_(accuracy) {
+                using namespace std::placeholders;
                 procedure_factory_table_.emplace("Constant", make_constant);
+                procedure_factory_table_.emplace("Conv", make_conv);
+                procedure_factory_table_.emplace(
+                  "Exp", std::bind(make_exp, _1, _2, _3, accuracy));
+                procedure_factory_table_.emplace("Gemm", make_gemm);
+                procedure_factory_table_.emplace("GlobalAveragePool",
+                                                 make_global_average_pool);
+                procedure_factory_table_.emplace("GlobalMaxPool",
+                                                 make_global_max_pool);
                 procedure_factory_table_.emplace("Identity", make_identity);
+                procedure_factory_table_.emplace("ReduceMax", make_reduce_max);
+                procedure_factory_table_.emplace("ReduceMean",
+                                                 make_reduce_mean);
+                procedure_factory_table_.emplace("ReduceMin", make_reduce_min);
+                procedure_factory_table_.emplace("ReduceSum", make_reduce_sum);
                 procedure_factory_table_.emplace("Relu", make_relu);
                 procedure_factory_table_.emplace("Reshape", make_reshape);
+                procedure_factory_table_.emplace("Resize", make_resize);
+                procedure_factory_table_.emplace("MatMul", make_matmul);
                 procedure_factory_table_.emplace("Mul", make_mul);
-                procedure_factory_table_.emplace("Sigmoid", make_sigmoid);
+                procedure_factory_table_.emplace(
+                  "Sigmoid", std::bind(make_sigmoid, _1, _2, _3, accuracy));
+                procedure_factory_table_.emplace("Slice", make_slice);
+                procedure_factory_table_.emplace("Split", make_slice);
+                procedure_factory_table_.emplace(
+                  "Tanh", std::bind(make_tanh, _1, _2, _3, accuracy));
                 procedure_factory_table_.emplace("Transpose", make_transpose);
+                procedure_factory_table_.emplace("Upsample", make_resize);
+
+                view_factory_table_.emplace("Slice", make_slice_view);
+                view_factory_table_.emplace("Split", make_slice_view);
             }
 
             optional<std::tuple<std::vector<procedure>, int>>
             generic_context::do_process_node_list(
               std::string const& context_name, int current_index,
-              std::vector<node> const& node_list,
+              int end_index, std::vector<node> const& node_list,
               std::unordered_map<std::string, array> const&
                 common_parameter_table,
               std::unordered_map<std::string, array> const& common_input_table,
@@ -36,89 +67,277 @@ namespace menoh_impl {
 
                 std::vector<procedure> new_op_proc_list;
 
-                for(; current_index < static_cast<int>(node_list.size());
-                    ++current_index) {
-                    auto const& node = node_list.at(current_index);
-                    std::vector<array> input_list;
-                    std::vector<procedure> new_copy_procedure_list;
+                auto find_input = [&](std::string const& input_name,
+                                      std::vector<procedure>&
+                                        new_copy_procedure_list) {
+                    // search in self variable table
+                    auto found_from_variable_table =
+                      variable_table_.find(input_name);
+                    if(found_from_variable_table != variable_table_.end()) {
+                        *logger << input_name
+                                << " is found in self variable table"
+                                << std::endl;
+                        return found_from_variable_table->second;
+                    }
 
+                    // search in common parameter and input table
+                    auto found_from_parameter_table =
+                      common_parameter_table.find(input_name);
+                    if(found_from_parameter_table !=
+                       common_parameter_table.end()) {
+                        *logger << input_name
+                                << " is found in common parameter table"
+                                << std::endl;
+                        return found_from_parameter_table->second;
+                    }
+                    auto found_from_input_table =
+                      common_input_table.find(input_name);
+                    if(found_from_input_table != common_input_table.end()) {
+                        *logger << input_name
+                                << " is found in common input table"
+                                << std::endl;
+                        return found_from_input_table->second;
+                    }
+
+                    // search in other contexts' variable table
+                    for(auto const& context_pair : context_list) {
+                        if(context_pair.first == context_name) {
+                            continue; // skip self
+                        }
+                        auto found =
+                          context_pair.second->try_to_get_variable(input_name);
+                        if(found) {
+                            *logger << input_name
+                                    << " is found in other context's "
+                                       "varibale table: "
+                                    << context_pair.first << std::endl;
+                            procedure copy_proc;
+                            array arr;
+                            std::tie(copy_proc, arr) = *found;
+                            new_copy_procedure_list.push_back(copy_proc);
+                            return arr;
+                        }
+                    }
+                    assert(!"input is not found");
+                    return array();
+                };
+
+                auto get_output = [&](std::string const& output_name) {
+                    auto found = required_output_table.find(output_name);
+                    if(found == required_output_table.end()) {
+                        // allocate new array by using profile
+                        return array(output_profile_table.at(output_name));
+                    }
+                    // use already allocated array
+                    return found->second;
+                };
+
+                // count consumers of each variable to find intermediate
+                // variables which can be eliminated by fusion
+                std::unordered_map<std::string, int> consumer_count_table;
+                for(auto const& node : node_list) {
                     for(auto const& input_name : node.input_name_list) {
-                        do {
-                            // search in self variable table
-                            auto found_from_variable_table =
-                              variable_table_.find(input_name);
-                            if(found_from_variable_table !=
-                               variable_table_.end()) {
-                                *logger << input_name
-                                        << " is found in self variable table"
-                                        << std::endl;
-                                input_list.push_back(
-                                  found_from_variable_table->second);
+                        ++consumer_count_table[input_name];
+                    }
+                }
+
+                // returns the end of the chain of elementwise nodes starting
+                // from `begin` whose intermediate outputs are consumed only by
+                // the next node in the chain
+                auto find_elementwise_chain_end = [&](int begin) {
+                    int end = begin;
+                    std::string const* prev_output_name = nullptr;
+                    for(; end < end_index; ++end) {
+                        auto const& node = node_list.at(end);
+                        auto op =
+                          find_fusible_elementwise_op(node.op_type, accuracy_);
+                        if(!op ||
+                           static_cast<int>(node.input_name_list.size()) !=
+                             op->arity ||
+                           node.output_name_list.size() != 1) {
+                            break;
+                        }
+                        if(prev_output_name) {
+                            if(std::count(node.input_name_list.begin(),
+                                          node.input_name_list.end(),
+                                          *prev_output_name) != 1 ||
+                               consumer_count_table.at(*prev_output_name) !=
+                                 1 ||
+                               required_output_table.find(*prev_output_name) !=
+                                 required_output_table.end()) {
                                 break;
                             }
+                        }
+                        prev_output_name = &node.output_name_list.front();
+                    }
+                    return end;
+                };
 
-                            // search in common parameter and input table
-                            auto found_from_common_table =
-                              [&](auto const& table) {
-                                  auto found = table.find(input_name);
-                                  if(found != table.end()) {
-                                      input_list.push_back(found->second);
-                                      return true;
-                                  }
-                                  return false;
-                              };
-                            if(found_from_common_table(
-                                 common_parameter_table)) {
-                                *logger << input_name
-                                        << " is found in common parameter table"
-                                        << std::endl;
-                                break;
+                // fuse the chain into one procedure. Returns nullopt when
+                // the chain is not fusible (e.g. dtype or size mismatch)
+                auto try_to_fuse_elementwise_chain =
+                  [&](int begin, int end,
+                      std::vector<procedure>& new_copy_procedure_list)
+                  -> optional<std::tuple<procedure, array>> {
+                    auto is_valid = [](array const& arr, array const& base) {
+                        return arr.dtype() == dtype_t::float_ &&
+                               total_size(arr) == total_size(base);
+                    };
+                    auto const& first_node = node_list.at(begin);
+
+                    // check profiles before find_input() because variables
+                    // of other contexts are converted only once and their
+                    // copy procedures must not be lost
+                    auto has_same_profile = [&output_profile_table](
+                                              std::string const& name,
+                                              std::size_t size) {
+                        auto found = output_profile_table.find(name);
+                        return found != output_profile_table.end() &&
+                               found->second.dtype() == dtype_t::float_ &&
+                               calc_total_size(found->second.dims()) == size;
+                    };
+                    auto found_input_profile = output_profile_table.find(
+                      first_node.input_name_list.front());
+                    if(found_input_profile == output_profile_table.end()) {
+                        return nullopt;
+                    }
+                    auto size =
+                      calc_total_size(found_input_profile->second.dims());
+                    for(int i = begin; i < end; ++i) {
+                        for(auto const& name :
+                            node_list.at(i).input_name_list) {
+                            if(!has_same_profile(name, size)) {
+                                return nullopt;
                             }
-                            if(found_from_common_table(common_input_table)) {
-                                *logger << input_name
-                                        << " is found in common input table"
-                                        << std::endl;
-                                break;
+                        }
+                    }
+                    if(!has_same_profile(
+                         node_list.at(end - 1).output_name_list.front(),
+                         size)) {
+                        return nullopt;
+                    }
+
+                    auto input =
+                      find_input(first_node.input_name_list.front(),
+                                 new_copy_procedure_list);
+                    if(input.dtype() != dtype_t::float_) {
+                        return nullopt;
+                    }
+                    std::vector<elementwise_stage> stages;
+                    std::string const* value_name =
+                      &first_node.input_name_list.front();
+                    for(int i = begin; i < end; ++i) {
+                        auto const& node = node_list.at(i);
+                        auto op =
+                          *find_fusible_elementwise_op(node.op_type, accuracy_);
+                        optional<array> operand;
+                        if(op.arity == 2) {
+                            auto const& operand_name =
+                              node.input_name_list.at(0) == *value_name
+                                ? node.input_name_list.at(1)
+                                : node.input_name_list.at(0);
+                            operand =
+                              find_input(operand_name, new_copy_procedure_list);
+                            if(!is_valid(*operand, input)) {
+                                return nullopt;
                             }
+                        }
+                        stages.push_back({op.kernel, operand});
+                        value_name = &node.output_name_list.front();
+                    }
+                    auto output = get_output(*value_name);
+                    if(!is_valid(output, input)) {
+                        return nullopt;
+                    }
+                    return std::make_tuple(
+                      make_fused_elementwise(input, stages, output), output);
+                };
+
+                for(; current_index < end_index; ++current_index) {
+                    auto const& node = node_list.at(current_index);
+                    std::vector<procedure> new_copy_procedure_list;
+
+                    auto chain_end = find_elementwise_chain_end(current_index);
+                    if(chain_end - current_index >= 2) {
+                        auto fused = try_to_fuse_elementwise_chain(
+                          current_index, chain_end, new_copy_procedure_list);
+                        if(fused) {
+                            *logger << "fuse " << chain_end - current_index
+                                    << " elementwise nodes: "
+                                    << node.output_name_list.front() << " to "
+                                    << node_list.at(chain_end - 1)
+                                         .output_name_list.front()
+                                    << std::endl;
+                            procedure fused_proc;
+                            array output;
+                            std::tie(fused_proc, output) = *fused;
+                            new_op_proc_list.push_back(fused_proc);
+                            procedure_list.insert(
+                              procedure_list.end(),
+                              std::make_move_iterator(
+                                new_copy_procedure_list.begin()),
+                              std::make_move_iterator(
+                                new_copy_procedure_list.end()));
+                            variable_table_.emplace(
+                              node_list.at(chain_end - 1)
+                                .output_name_list.front(),
+                              output);
+                            current_index = chain_end - 1;
+                            continue;
+                        }
+                        // copy procedures already collected are kept.
+                        // Their sources are already computed
+                    }
+
+                    std::vector<array> input_list;
+                    for(auto const& input_name : node.input_name_list) {
+                        input_list.push_back(
+                          find_input(input_name, new_copy_procedure_list));
+                    }
 
-                            // search in other contexts' variable table
-                            bool is_found_from_other_context = false;
-                            for(auto const& context_pair : context_list) {
-                                if(context_pair.first == context_name) {
-                                    continue; // skip self
-                                }
-                                auto found =
-                                  context_pair.second->try_to_get_variable(
-                                    input_name);
-                                if(found) {
-                                    *logger << input_name
-                                            << " is found in other context's "
-                                               "varibale table: "
-                                            << context_pair.first << std::endl;
-                                    procedure copy_proc;
-                                    array arr;
-                                    std::tie(copy_proc, arr) = *found;
-                                    new_copy_procedure_list.push_back(
-                                      copy_proc);
-                                    input_list.push_back(arr);
-                                    is_found_from_other_context = true;
-                                    break;
-                                }
+                    // outputs which are views of the inputs need neither
+                    // allocation nor procedure. Required outputs are always
+                    // written by procedures
+                    auto found_view_factory =
+                      view_factory_table_.find(node.op_type);
+                    if(found_view_factory != view_factory_table_.end() &&
+                       std::none_of(node.output_name_list.begin(),
+                                    node.output_name_list.end(),
+                                    [&](std::string const& name) {
+                                        return required_output_table.find(
+                                                 name) !=
+                                               required_output_table.end();
+                                    })) {
+                        optional<std::vector<array>> view_list;
+                        try {
+                            view_list =
+                              found_view_factory->second(node, input_list);
+                        } catch(std::exception const& e) {
+                            *logger << e.what() << std::endl;
+                        }
+                        if(view_list) {
+                            *logger << node.op_type << " outputs are views: "
+                                    << node.output_name_list.front()
+                                    << std::endl;
+                            procedure_list.insert(
+                              procedure_list.end(),
+                              std::make_move_iterator(
+                                new_copy_procedure_list.begin()),
+                              std::make_move_iterator(
+                                new_copy_procedure_list.end()));
+                            for(unsigned int i = 0; i < view_list->size();
+                                ++i) {
+                                variable_table_.emplace(
+                                  node.output_name_list.at(i),
+                                  view_list->at(i));
                             }
-                            assert(is_found_from_other_context);
-                        } while(false);
+                            continue;
+                        }
                     }
+
                     std::vector<array> output_list;
                     for(auto const& output_name : node.output_name_list) {
-                        auto found = required_output_table.find(output_name);
-                        if(found == required_output_table.end()) {
-                            // allocate new array by using profile
-                            output_list.push_back(
-                              array(output_profile_table.at(output_name)));
-                        } else {
-                            // use already allocated array
-                            output_list.push_back(found->second);
-                        }
+                        output_list.push_back(get_output(output_name));
                     }
 
                     procedure op_proc;
@@ -3,13 +3,16 @@
 
 #include <menoh/composite_backend/context.hpp>
 
+#include <menoh/composite_backend/backend/generic/math.hpp>
+
 namespace menoh_impl {
     namespace composite_backend {
         namespace generic_backend {
 
             class generic_context final : public context {
             public:
-                generic_context();
+                explicit generic_context(
+                  math_accuracy accuracy = math_accuracy::exact);
 
             private:
                 virtual optional<std::tuple<procedure, array>>
@@ -25,7 +28,7 @@ namespace menoh_impl {
                 virtual optional<std::tuple<std::vector<procedure>, int>>
                 do_process_node_list(
                   std::string const& context_name, int current_index,
-                  std::vector<node> const& node_list,
+                  int end_index, std::vector<node> const& node_list,
                   std::unordered_map<std::string, array> const&
                     common_parameter_table,
                   std::unordered_map<std::string, array> const&
@@ -45,19 +48,37 @@ namespace menoh_impl {
                     return variable_table_.at(name);
                 }
 
+                virtual void
+                do_collect_memory_stats(memory_stats& stats) const override {
+                    for(auto const& p : variable_table_) {
+                        stats.add(p.first, memory_category::activation,
+                                  p.second);
+                    }
+                }
+
                 using procedure_factory = std::function<procedure(
                   node const&, // node
                   std::vector<array> const&, // input list
                   std::vector<array> const&  // output list
                   )>;
+                // returns output arrays sharing data with the inputs or
+                // nullopt when the outputs can not be views
+                using view_factory =
+                  std::function<optional<std::vector<array>>(
+                    node const&,              // node
+                    std::vector<array> const& // input list
+                    )>;
                 optional<std::function<void()>>
                 try_to_get_input_from_common_table(
                   std::string const& input_name,
                   std::unordered_map<std::string, array> const& common_table);
 
+                math_accuracy accuracy_;
                 std::unordered_map<std::string, array> variable_table_;
                 std::unordered_map<std::string, procedure_factory>
                   procedure_factory_table_;
+                std::unordered_map<std::string, view_factory>
+                  view_factory_table_;
             };
 
         } // namespace generic_backend
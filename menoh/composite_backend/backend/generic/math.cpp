@@ -0,0 +1,163 @@
+#include <menoh/composite_backend/backend/generic/math.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MENOH_GENERIC_MATH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            namespace {
+
+#ifdef MENOH_GENERIC_MATH_USE_SSE2
+                constexpr int simd_width = 4;
+
+                // same algorithm as fast_exp()
+                inline __m128 exp_ps(__m128 x) {
+                    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.33654f)),
+                                   _mm_set1_ps(88.f));
+
+                    __m128 one = _mm_set1_ps(1.f);
+                    __m128 log2e = _mm_set1_ps(1.44269504088896341f);
+                    __m128 fx =
+                      _mm_add_ps(_mm_mul_ps(x, log2e), _mm_set1_ps(0.5f));
+                    __m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+                    n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, fx), one));
+                    __m128 r =
+                      _mm_add_ps(_mm_sub_ps(x, _mm_mul_ps(
+                                                 n, _mm_set1_ps(0.693359375f))),
+                                 _mm_mul_ps(n, _mm_set1_ps(2.12194440e-4f)));
+
+                    __m128 p = _mm_set1_ps(1.9875691500e-4f);
+                    p = _mm_add_ps(_mm_mul_ps(p, r),
+                                   _mm_set1_ps(1.3981999507e-3f));
+                    p = _mm_add_ps(_mm_mul_ps(p, r),
+                                   _mm_set1_ps(8.3334519073e-3f));
+                    p = _mm_add_ps(_mm_mul_ps(p, r),
+                                   _mm_set1_ps(4.1665795894e-2f));
+                    p = _mm_add_ps(_mm_mul_ps(p, r),
+                                   _mm_set1_ps(1.6666665459e-1f));
+                    p = _mm_add_ps(_mm_mul_ps(p, r),
+                                   _mm_set1_ps(5.0000001201e-1f));
+                    p = _mm_add_ps(
+                      _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), one);
+
+                    __m128i bits = _mm_slli_epi32(
+                      _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)),
+                      23);
+                    return _mm_mul_ps(p, _mm_castsi128_ps(bits));
+                }
+
+                // same algorithm as fast_sigmoid()
+                inline __m128 sigmoid_ps(__m128 x) {
+                    __m128 one = _mm_set1_ps(1.f);
+                    return _mm_div_ps(
+                      one,
+                      _mm_add_ps(one, exp_ps(_mm_sub_ps(_mm_setzero_ps(), x))));
+                }
+
+                // same algorithm as fast_tanh()
+                inline __m128 tanh_ps(__m128 x) {
+                    __m128 sign_mask = _mm_set1_ps(-0.f);
+                    __m128 ax = _mm_andnot_ps(sign_mask, x);
+                    __m128 one = _mm_set1_ps(1.f);
+                    __m128 large = _mm_sub_ps(
+                      one, _mm_div_ps(_mm_set1_ps(2.f),
+                                      _mm_add_ps(exp_ps(_mm_add_ps(ax, ax)),
+                                                 one)));
+                    large = _mm_xor_ps(large, _mm_and_ps(sign_mask, x));
+
+                    __m128 z = _mm_mul_ps(x, x);
+                    __m128 small = _mm_set1_ps(-5.70498872745e-3f);
+                    small = _mm_add_ps(_mm_mul_ps(small, z),
+                                       _mm_set1_ps(2.06390887954e-2f));
+                    small = _mm_sub_ps(_mm_mul_ps(small, z),
+                                       _mm_set1_ps(5.37397155531e-2f));
+                    small = _mm_add_ps(_mm_mul_ps(small, z),
+                                       _mm_set1_ps(1.33314422036e-1f));
+                    small = _mm_sub_ps(_mm_mul_ps(small, z),
+                                       _mm_set1_ps(3.33332819422e-1f));
+                    small =
+                      _mm_add_ps(_mm_mul_ps(_mm_mul_ps(small, z), x), x);
+
+                    __m128 is_small = _mm_cmplt_ps(ax, _mm_set1_ps(0.625f));
+                    return _mm_or_ps(_mm_and_ps(is_small, small),
+                                     _mm_andnot_ps(is_small, large));
+                }
+
+                // apply the SIMD function to the head and the scalar
+                // function to the remaining tail
+                template <typename SimdF, typename ScalarF>
+                inline void apply_fast(float const* x, float* y, int size,
+                                       SimdF simd_f, ScalarF scalar_f) {
+                    int i = 0;
+                    for(; i + simd_width <= size; i += simd_width) {
+                        _mm_storeu_ps(y + i, simd_f(_mm_loadu_ps(x + i)));
+                    }
+                    for(; i < size; ++i) {
+                        y[i] = scalar_f(x[i]);
+                    }
+                }
+#else
+                template <typename SimdF, typename ScalarF>
+                inline void apply_fast(float const* x, float* y, int size,
+                                       SimdF, ScalarF scalar_f) {
+                    for(int i = 0; i < size; ++i) {
+                        y[i] = scalar_f(x[i]);
+                    }
+                }
+#endif
+
+#ifdef MENOH_GENERIC_MATH_USE_SSE2
+#define MENOH_GENERIC_MATH_SIMD_FUNCTION(f) f
+#else
+#define MENOH_GENERIC_MATH_SIMD_FUNCTION(f) nullptr
+#endif
+
+            } // namespace
+
+            void vexp(math_accuracy accuracy, float const* x, float* y,
+                      int size) {
+                if(accuracy == math_accuracy::fast) {
+                    apply_fast(x, y, size,
+                               MENOH_GENERIC_MATH_SIMD_FUNCTION(exp_ps),
+                               fast_exp);
+                    return;
+                }
+                for(int i = 0; i < size; ++i) {
+                    y[i] = std::exp(x[i]);
+                }
+            }
+
+            void vsigmoid(math_accuracy accuracy, float const* x, float* y,
+                          int size) {
+                if(accuracy == math_accuracy::fast) {
+                    apply_fast(x, y, size,
+                               MENOH_GENERIC_MATH_SIMD_FUNCTION(sigmoid_ps),
+                               fast_sigmoid);
+                    return;
+                }
+                for(int i = 0; i < size; ++i) {
+                    y[i] = 1.f / (1.f + std::exp(-x[i]));
+                }
+            }
+
+            void vtanh(math_accuracy accuracy, float const* x, float* y,
+                       int size) {
+                if(accuracy == math_accuracy::fast) {
+                    apply_fast(x, y, size,
+                               MENOH_GENERIC_MATH_SIMD_FUNCTION(tanh_ps),
+                               fast_tanh);
+                    return;
+                }
+                for(int i = 0; i < size; ++i) {
+                    y[i] = std::tanh(x[i]);
+                }
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
@@ -0,0 +1,111 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_MATH_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_MATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <menoh/exception.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // exact: use libm (same results as before)
+            // fast: use polynomial approximations (relative error < 1e-6)
+            //       which are computed with SIMD instructions if available
+            enum class math_accuracy { exact, fast };
+
+            inline math_accuracy
+            string_to_math_accuracy(std::string const& name) {
+                if(name == "exact") {
+                    return math_accuracy::exact;
+                }
+                if(name == "fast") {
+                    return math_accuracy::fast;
+                }
+                throw invalid_backend_config_error(
+                  "invalid value of \"math_accuracy\": " + name);
+            }
+
+            // Scalar versions of fast approximations. SIMD versions in
+            // math.cpp use the same algorithms
+            //
+            // Cephes style expf. x is clamped to [-87.33, 88.0] so the
+            // result is always a finite normal number
+            inline float fast_exp(float x) {
+                x = std::min(std::max(x, -87.33654f), 88.f);
+
+                // x = n * ln2 + r, |r| <= ln2 / 2
+                float fx = x * 1.44269504088896341f + 0.5f;
+                float n = static_cast<float>(static_cast<std::int32_t>(fx));
+                n = n > fx ? n - 1.f : n; // floor
+                float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+
+                float p = 1.9875691500e-4f;
+                p = p * r + 1.3981999507e-3f;
+                p = p * r + 8.3334519073e-3f;
+                p = p * r + 4.1665795894e-2f;
+                p = p * r + 1.6666665459e-1f;
+                p = p * r + 5.0000001201e-1f;
+                p = p * r * r + r + 1.f;
+
+                // 2^n
+                std::int32_t bits =
+                  (static_cast<std::int32_t>(n) + 127) << 23;
+                float scale;
+                std::memcpy(&scale, &bits, sizeof(scale));
+                return p * scale;
+            }
+
+            inline float fast_sigmoid(float x) {
+                return 1.f / (1.f + fast_exp(-x));
+            }
+
+            // Cephes style tanhf. A polynomial is used around 0 to avoid
+            // cancellation in 1 - 2 / (exp(2x) + 1)
+            inline float fast_tanh(float x) {
+                float ax = std::abs(x);
+                float large = 1.f - 2.f / (fast_exp(2.f * ax) + 1.f);
+                large = x < 0.f ? -large : large;
+                float z = x * x;
+                float small = -5.70498872745e-3f;
+                small = small * z + 2.06390887954e-2f;
+                small = small * z - 5.37397155531e-2f;
+                small = small * z + 1.33314422036e-1f;
+                small = small * z - 3.33332819422e-1f;
+                small = small * z * x + x;
+                return ax < 0.625f ? small : large;
+            }
+
+            // y[i] = f(x[i]) for i in [0, size). x and y can be the same
+            void vexp(math_accuracy accuracy, float const* x, float* y,
+                      int size);
+            void vsigmoid(math_accuracy accuracy, float const* x, float* y,
+                          int size);
+            void vtanh(math_accuracy accuracy, float const* x, float* y,
+                       int size);
+
+            // apply f(x, y, size) to [0, size) chunk by chunk by using all
+            // threads
+            template <typename F>
+            inline void parallel_apply(float const* x, float* y, int size,
+                                       F f) {
+                constexpr int chunk_size = 4096;
+                int chunk_num = (size + chunk_size - 1) / chunk_size;
+                parallel_for(0, chunk_num, [&](int c) {
+                    int offset = c * chunk_size;
+                    f(x + offset, y + offset,
+                      std::min(chunk_size, size - offset));
+                });
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_MATH_HPP
@@ -2,11 +2,19 @@
 #define MENOH_IMPL_COMPOSITE_BACKEND_GENERIC_OPERATOR_HPP
 
 #include <menoh/composite_backend/backend/generic/operator/constant.hpp>
+#include <menoh/composite_backend/backend/generic/operator/conv.hpp>
+#include <menoh/composite_backend/backend/generic/operator/exp.hpp>
+#include <menoh/composite_backend/backend/generic/operator/gemm.hpp>
 #include <menoh/composite_backend/backend/generic/operator/identity.hpp>
+#include <menoh/composite_backend/backend/generic/operator/matmul.hpp>
 #include <menoh/composite_backend/backend/generic/operator/mul.hpp>
+#include <menoh/composite_backend/backend/generic/operator/reduce.hpp>
 #include <menoh/composite_backend/backend/generic/operator/relu.hpp>
 #include <menoh/composite_backend/backend/generic/operator/reshape.hpp>
+#include <menoh/composite_backend/backend/generic/operator/resize.hpp>
 #include <menoh/composite_backend/backend/generic/operator/sigmoid.hpp>
+#include <menoh/composite_backend/backend/generic/operator/slice.hpp>
+#include <menoh/composite_backend/backend/generic/operator/tanh.hpp>
 #include <menoh/composite_backend/backend/generic/operator/transpose.hpp>
 
 #endif // MENOH_IMPL_COMPOSITE_BACKEND_GENERIC_OPERATOR_HPP
@@ -0,0 +1,258 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_CONV_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_CONV_HPP
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for unsupported_operator_attribute error
+#include <menoh/optional.hpp>
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+#include <menoh/composite_backend/backend/generic/sgemm.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            struct conv_2d_geometry {
+                int channel_num;
+                int input_h, input_w;
+                int kernel_h, kernel_w;
+                int stride_h, stride_w;
+                int pad_t, pad_l;
+                int dilation_h, dilation_w;
+                int output_h, output_w;
+            };
+
+            inline bool is_pointwise(conv_2d_geometry const& g) {
+                return g.kernel_h == 1 && g.kernel_w == 1 && g.stride_h == 1 &&
+                       g.stride_w == 1 && g.pad_t == 0 && g.pad_l == 0;
+            }
+
+            // col[(c, ky, kx), (oy, ox)] = x[c, iy, ix] (or 0 when padded)
+            inline void im2col(conv_2d_geometry const& g, float const* x,
+                               float* col) {
+                int output_size = g.output_h * g.output_w;
+                parallel_for(0, g.channel_num, [&](int c) {
+                    float const* xc = x + c * g.input_h * g.input_w;
+                    for(int ky = 0; ky < g.kernel_h; ++ky) {
+                        for(int kx = 0; kx < g.kernel_w; ++kx) {
+                            float* dst =
+                              col + ((c * g.kernel_h + ky) * g.kernel_w + kx) *
+                                      output_size;
+                            for(int oy = 0; oy < g.output_h; ++oy) {
+                                int iy =
+                                  oy * g.stride_h - g.pad_t + ky * g.dilation_h;
+                                float* dst_row = dst + oy * g.output_w;
+                                if(iy < 0 || g.input_h <= iy) {
+                                    std::fill(dst_row, dst_row + g.output_w,
+                                              0.f);
+                                    continue;
+                                }
+                                float const* src_row = xc + iy * g.input_w;
+                                int ix0 = kx * g.dilation_w - g.pad_l;
+                                for(int ox = 0; ox < g.output_w; ++ox) {
+                                    int ix = ix0 + ox * g.stride_w;
+                                    dst_row[ox] = (0 <= ix && ix < g.input_w)
+                                                    ? src_row[ix]
+                                                    : 0.f;
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+
+            // Depthwise convolution of `group` channels: each output channel
+            // oc is computed from the single input channel oc / multiplier
+            inline void depthwise_conv(conv_2d_geometry const& g, int group,
+                                       int multiplier, float const* x,
+                                       float const* weight, float const* bias,
+                                       float* y) {
+                assert(g.channel_num == 1);
+                int output_channel_num = group * multiplier;
+                int output_size = g.output_h * g.output_w;
+                parallel_for(0, output_channel_num, [&](int oc) {
+                    float const* xc =
+                      x + (oc / multiplier) * g.input_h * g.input_w;
+                    float const* w = weight + oc * g.kernel_h * g.kernel_w;
+                    float* yc = y + oc * output_size;
+                    std::fill(yc, yc + output_size, bias ? bias[oc] : 0.f);
+                    for(int oy = 0; oy < g.output_h; ++oy) {
+                        float* y_row = yc + oy * g.output_w;
+                        for(int ky = 0; ky < g.kernel_h; ++ky) {
+                            int iy =
+                              oy * g.stride_h - g.pad_t + ky * g.dilation_h;
+                            if(iy < 0 || g.input_h <= iy) {
+                                continue;
+                            }
+                            float const* src_row = xc + iy * g.input_w;
+                            for(int kx = 0; kx < g.kernel_w; ++kx) {
+                                float wv = w[ky * g.kernel_w + kx];
+                                int ix0 = kx * g.dilation_w - g.pad_l;
+                                // valid ox range where 0 <= ix < input_w
+                                int ox_begin = 0;
+                                while(ox_begin < g.output_w &&
+                                      ix0 + ox_begin * g.stride_w < 0) {
+                                    ++ox_begin;
+                                }
+                                int ox_end = g.output_w;
+                                while(ox_begin < ox_end &&
+                                      g.input_w <=
+                                        ix0 + (ox_end - 1) * g.stride_w) {
+                                    --ox_end;
+                                }
+                                // ix0 may be negative in the padded border,
+                                // so only valid indices are added to src_row
+                                for(int ox = ox_begin; ox < ox_end; ++ox) {
+                                    y_row[ox] +=
+                                      wv * src_row[ix0 + ox * g.stride_w];
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+
+            inline procedure make_conv(node const& node,
+                                       std::vector<array> const& input_list,
+                                       std::vector<array> const& output_list) {
+                assert(input_list.size() == 2 || input_list.size() == 3);
+                assert(output_list.size() == 1);
+
+                for(auto const& input : input_list) {
+                    if(input.dtype() != dtype_t::float_) {
+                        throw invalid_dtype(
+                          std::to_string(static_cast<int>(input.dtype())));
+                    }
+                }
+
+                auto input = input_list.at(0);
+                auto weight = input_list.at(1);
+                auto output = output_list.at(0);
+                if(input.dims().size() != 4) {
+                    throw unsupported_operator_attribute(
+                      node.op_type, node.output_name_list.front(),
+                      "input ndims", std::to_string(input.dims().size()),
+                      "4");
+                }
+
+                auto group = attribute_int(node, "group");
+
+                std::vector<int> strides, kernel_shape, pads;
+                std::tie(strides, kernel_shape, pads) =
+                  attributes_for_2d_data_processing(node);
+                auto dilations = attribute_ints(node, "dilations");
+
+                // g describes convolution of one group
+                conv_2d_geometry g;
+                g.channel_num = input.dims().at(1) / group;
+                g.input_h = input.dims().at(2);
+                g.input_w = input.dims().at(3);
+                g.kernel_h = kernel_shape.at(0);
+                g.kernel_w = kernel_shape.at(1);
+                g.stride_h = strides.at(0);
+                g.stride_w = strides.at(1);
+                g.pad_t = pads.at(0);
+                g.pad_l = pads.at(1);
+                g.dilation_h = dilations.at(0);
+                g.dilation_w = dilations.at(1);
+                g.output_h = output.dims().at(2);
+                g.output_w = output.dims().at(3);
+
+                int batch_size = input.dims().at(0);
+                int output_channel_num = weight.dims().at(0);
+                int group_output_channel_num = output_channel_num / group;
+                int col_rows = g.channel_num * g.kernel_h * g.kernel_w;
+                int input_size = g.input_h * g.input_w;
+                int output_size = g.output_h * g.output_w;
+                assert(weight.dims().at(1) == g.channel_num);
+                assert(output_channel_num % group == 0);
+
+                optional<array> bias;
+                if(input_list.size() == 3) {
+                    bias = input_list.at(2);
+                    assert(static_cast<int>(total_size(*bias)) ==
+                           output_channel_num);
+                }
+
+                if(g.channel_num == 1 && group != 1) {
+                    auto procedure = [input, weight, bias, output, g, group,
+                                      batch_size, group_output_channel_num,
+                                      input_size, output_size]() {
+                        for(int n = 0; n < batch_size; ++n) {
+                            depthwise_conv(
+                              g, group, group_output_channel_num,
+                              fbegin(input) +
+                                static_cast<std::size_t>(n) * group *
+                                  input_size,
+                              fbegin(weight), bias ? fbegin(*bias) : nullptr,
+                              fbegin(output) +
+                                static_cast<std::size_t>(n) * group *
+                                  group_output_channel_num * output_size);
+                        }
+                    };
+                    return procedure;
+                }
+
+                // im2col buffer is allocated once and reused in every run
+                std::shared_ptr<std::vector<float>> col_buffer;
+                if(!is_pointwise(g)) {
+                    col_buffer = std::make_shared<std::vector<float>>(
+                      static_cast<std::size_t>(col_rows) * output_size);
+                }
+
+                auto procedure = [input, weight, bias, output, g, group,
+                                  batch_size, output_channel_num,
+                                  group_output_channel_num, col_rows,
+                                  input_size, output_size, col_buffer]() {
+                    for(int n = 0; n < batch_size; ++n) {
+                        float* y = fbegin(output) +
+                                   static_cast<std::size_t>(n) *
+                                     output_channel_num * output_size;
+                        float beta = 0.f;
+                        if(bias) {
+                            float const* b = fbegin(*bias);
+                            parallel_for(0, output_channel_num, [=](int oc) {
+                                std::fill(y + oc * output_size,
+                                          y + (oc + 1) * output_size, b[oc]);
+                            });
+                            beta = 1.f;
+                        }
+                        for(int gi = 0; gi < group; ++gi) {
+                            float const* x =
+                              fbegin(input) +
+                              (static_cast<std::size_t>(n) * group + gi) *
+                                g.channel_num * input_size;
+                            float const* col = x;
+                            if(col_buffer) {
+                                im2col(g, x, col_buffer->data());
+                                col = col_buffer->data();
+                            }
+                            // y_g (oc/group x output_size) =
+                            //   W_g (oc/group x col_rows) * col
+                            sgemm(false, false, group_output_channel_num,
+                                  output_size, col_rows, 1.f,
+                                  fbegin(weight) +
+                                    static_cast<std::size_t>(gi) *
+                                      group_output_channel_num * col_rows,
+                                  col_rows, col, output_size, beta,
+                                  y + static_cast<std::size_t>(gi) *
+                                        group_output_channel_num *
+                                        output_size,
+                                  output_size);
+                        }
+                    }
+                };
+
+                return procedure;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_CONV_HPP
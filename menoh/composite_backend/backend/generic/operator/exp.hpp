@@ -0,0 +1,41 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_EXP_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_EXP_HPP
+
+#include <menoh/array.hpp>
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/math.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+            inline procedure
+            make_exp(node const&, std::vector<array> const& input_list,
+                     std::vector<array> const& output_list,
+                     math_accuracy accuracy) {
+                assert(input_list.size() == 1);
+                assert(output_list.size() == 1);
+
+                auto input = input_list.at(0);
+                if(input.dtype() != dtype_t::float_) {
+                    throw std::runtime_error("invalid dtype");
+                }
+
+                auto procedure = [input, output = output_list.at(0),
+                                  accuracy]() {
+                    parallel_apply(
+                      fbegin(input), fbegin(output),
+                      static_cast<int>(total_size(input)),
+                      [accuracy](float const* x, float* y, int size) {
+                          vexp(accuracy, x, y, size);
+                      });
+                };
+
+                return procedure;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_EXP_HPP
@@ -0,0 +1,118 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_GEMM_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_GEMM_HPP
+
+#include <numeric>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for dimension_mismatch error
+#include <menoh/optional.hpp>
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+#include <menoh/composite_backend/backend/generic/sgemm.hpp>
+#include <menoh/composite_backend/backend/generic/weight_expansion.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+            inline procedure make_gemm(node const& node,
+                                       std::vector<array> const& input_list,
+                                       std::vector<array> const& output_list) {
+                assert(input_list.size() == 2 || input_list.size() == 3);
+                assert(output_list.size() == 1);
+
+                // B may be kept in float16 or bfloat16
+                for(unsigned int i = 0; i < input_list.size(); ++i) {
+                    auto const& input = input_list.at(i);
+                    if(input.dtype() != dtype_t::float_ &&
+                       !(i == 1 && is_reduced_precision_float(input.dtype()))) {
+                        throw invalid_dtype(
+                          std::to_string(static_cast<int>(input.dtype())));
+                    }
+                }
+
+                auto alpha = attribute_float(node, "alpha");
+                auto beta = attribute_float(node, "beta");
+                auto trans_a = attribute_int(node, "transA");
+                auto trans_b = attribute_int(node, "transB");
+
+                auto a = input_list.at(0);
+                auto b = input_list.at(1);
+                auto output = output_list.at(0);
+
+                // A which has more than 2 dims is flattened into 2D
+                auto a_dims = a.dims();
+                int a_rows = a_dims.at(0);
+                int a_cols =
+                  std::accumulate(a_dims.begin() + 1, a_dims.end(), 1,
+                                  std::multiplies<int>());
+                int m = trans_a ? a_cols : a_rows;
+                int k = trans_a ? a_rows : a_cols;
+
+                auto b_dims = b.dims();
+                assert(b_dims.size() == 2);
+                int n = trans_b ? b_dims.at(0) : b_dims.at(1);
+                int b_k = trans_b ? b_dims.at(1) : b_dims.at(0);
+                if(k != b_k) {
+                    throw dimension_mismatch(
+                      node.op_type, node.output_name_list.front(),
+                      "trans(A)[1] and trans(B)[0])", std::to_string(k),
+                      std::to_string(b_k));
+                }
+                assert(static_cast<int>(total_size(output)) == m * n);
+
+                // C is unidirectionally broadcasted to (m, n)
+                int c_row_stride = 0;
+                int c_col_stride = 0;
+                optional<array> c;
+                if(input_list.size() == 3) {
+                    c = input_list.at(2);
+                    auto c_dims = c->dims();
+                    if(c_dims.size() > 2) {
+                        throw dimension_mismatch(
+                          node.op_type, node.output_name_list.front(),
+                          "C must be broadcastable to (M, N)",
+                          std::to_string(c_dims.size()), "2 or less");
+                    }
+                    c_dims.insert(c_dims.begin(), 2 - c_dims.size(), 1);
+                    if((c_dims.at(0) != 1 && c_dims.at(0) != m) ||
+                       (c_dims.at(1) != 1 && c_dims.at(1) != n)) {
+                        throw dimension_mismatch(
+                          node.op_type, node.output_name_list.front(),
+                          "C must be broadcastable to (M, N)",
+                          "(" + std::to_string(c_dims.at(0)) + ", " +
+                            std::to_string(c_dims.at(1)) + ")",
+                          "(" + std::to_string(m) + ", " + std::to_string(n) +
+                            ")");
+                    }
+                    c_row_stride = c_dims.at(0) == 1 ? 0 : c_dims.at(1);
+                    c_col_stride = c_dims.at(1) == 1 ? 0 : 1;
+                }
+
+                auto procedure = [a, b, c, output, alpha, beta, trans_a,
+                                  trans_b, m, n, k, a_cols, c_row_stride,
+                                  c_col_stride]() {
+                    float* y = fbegin(output);
+                    float gemm_beta = 0.f;
+                    if(c && beta != 0.f) {
+                        float const* cp = fbegin(*c);
+                        parallel_for(0, m, [=](int i) {
+                            for(int j = 0; j < n; ++j) {
+                                y[i * n + j] =
+                                  cp[i * c_row_stride + j * c_col_stride];
+                            }
+                        });
+                        gemm_beta = beta;
+                    }
+                    sgemm(trans_a, trans_b, m, n, k, alpha, fbegin(a), a_cols,
+                          expand_weight(b), b.dims().at(1), gemm_beta, y, n);
+                };
+
+                return procedure;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_GEMM_HPP
@@ -0,0 +1,166 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_MATMUL_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_MATMUL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for dimension_mismatch error
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+#include <menoh/composite_backend/backend/generic/sgemm.hpp>
+#include <menoh/composite_backend/backend/generic/weight_expansion.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            inline std::string dims_to_string(std::vector<int> const& dims) {
+                std::string str = "(";
+                for(auto d : dims) {
+                    str += std::to_string(d) + ",";
+                }
+                return str + ")";
+            }
+
+            // numpy.matmul compatible matrix product
+            //
+            // Each matrix product in the batch is computed by sgemm. When
+            // there are enough (or small enough) products, they are
+            // distributed over threads and each sgemm runs on one thread.
+            // Otherwise products run one by one and each sgemm uses all
+            // threads
+            inline procedure
+            make_matmul(node const& node, std::vector<array> const& input_list,
+                        std::vector<array> const& output_list) {
+                assert(input_list.size() == 2);
+                assert(output_list.size() == 1);
+
+                // B may be kept in float16 or bfloat16
+                for(unsigned int i = 0; i < input_list.size(); ++i) {
+                    auto const& input = input_list.at(i);
+                    if(input.dtype() != dtype_t::float_ &&
+                       !(i == 1 && is_reduced_precision_float(input.dtype()))) {
+                        throw invalid_dtype(
+                          std::to_string(static_cast<int>(input.dtype())));
+                    }
+                }
+
+                auto a = input_list.at(0);
+                auto b = input_list.at(1);
+                auto output = output_list.at(0);
+
+                // 1-D A is (1, K) and 1-D B is (K, 1)
+                auto a_dims = a.dims();
+                if(a_dims.size() == 1) {
+                    a_dims.insert(a_dims.begin(), 1);
+                }
+                auto b_dims = b.dims();
+                if(b_dims.size() == 1) {
+                    b_dims.push_back(1);
+                }
+
+                int m = a_dims.at(a_dims.size() - 2);
+                int k = a_dims.at(a_dims.size() - 1);
+                int n = b_dims.at(b_dims.size() - 1);
+                if(k != b_dims.at(b_dims.size() - 2)) {
+                    throw dimension_mismatch(
+                      node.op_type, node.output_name_list.front(),
+                      "A.dims[-1] and B.dims[-2]", std::to_string(k),
+                      std::to_string(b_dims.at(b_dims.size() - 2)));
+                }
+
+                // broadcast batch dims
+                std::vector<int> a_batch_dims(a_dims.begin(), a_dims.end() - 2);
+                std::vector<int> b_batch_dims(b_dims.begin(), b_dims.end() - 2);
+                auto batch_ndims =
+                  std::max(a_batch_dims.size(), b_batch_dims.size());
+                a_batch_dims.insert(a_batch_dims.begin(),
+                                    batch_ndims - a_batch_dims.size(), 1);
+                b_batch_dims.insert(b_batch_dims.begin(),
+                                    batch_ndims - b_batch_dims.size(), 1);
+                std::vector<int> batch_dims(batch_ndims);
+                for(std::size_t i = 0; i < batch_ndims; ++i) {
+                    auto ad = a_batch_dims.at(i);
+                    auto bd = b_batch_dims.at(i);
+                    if(ad != bd && ad != 1 && bd != 1) {
+                        throw dimension_mismatch(
+                          node.op_type, node.output_name_list.front(),
+                          "batch dims of A and B are not broadcastable",
+                          dims_to_string(a.dims()), dims_to_string(b.dims()));
+                    }
+                    batch_dims.at(i) = std::max(ad, bd);
+                }
+
+                // offsets of each matrix of A and B in the batch
+                int batch_num = 1;
+                for(auto d : batch_dims) {
+                    batch_num *= d;
+                }
+                std::vector<std::size_t> a_offset_list(batch_num);
+                std::vector<std::size_t> b_offset_list(batch_num);
+                for(int batch = 0; batch < batch_num; ++batch) {
+                    std::size_t a_index = 0;
+                    std::size_t b_index = 0;
+                    int rest = batch;
+                    std::size_t a_stride = 1;
+                    std::size_t b_stride = 1;
+                    for(int i = static_cast<int>(batch_ndims) - 1; 0 <= i;
+                        --i) {
+                        int index = rest % batch_dims.at(i);
+                        rest /= batch_dims.at(i);
+                        if(a_batch_dims.at(i) != 1) {
+                            a_index += index * a_stride;
+                        }
+                        if(b_batch_dims.at(i) != 1) {
+                            b_index += index * b_stride;
+                        }
+                        a_stride *= a_batch_dims.at(i);
+                        b_stride *= b_batch_dims.at(i);
+                    }
+                    a_offset_list.at(batch) =
+                      a_index * static_cast<std::size_t>(m) * k;
+                    b_offset_list.at(batch) =
+                      b_index * static_cast<std::size_t>(k) * n;
+                }
+                assert(total_size(output) ==
+                       static_cast<std::size_t>(batch_num) * m * n);
+
+                constexpr long small_matmul_size = 64 * 64 * 64;
+                bool is_batch_parallel =
+                  batch_num > 1 &&
+                  (batch_num >= get_max_thread_num() ||
+                   static_cast<long>(m) * n * k <= small_matmul_size);
+
+                auto procedure = [a, b, output, m, n, k, batch_num,
+                                  a_offset_list, b_offset_list,
+                                  is_batch_parallel]() {
+                    float const* b_data = expand_weight(b);
+                    auto matmul = [&](int batch) {
+                        sgemm(false, false, m, n, k, 1.f,
+                              fbegin(a) + a_offset_list[batch], k,
+                              b_data + b_offset_list[batch], n, 0.f,
+                              fbegin(output) +
+                                static_cast<std::size_t>(batch) * m * n,
+                              n);
+                    };
+                    if(is_batch_parallel) {
+                        parallel_for(0, batch_num, matmul);
+                    } else {
+                        for(int batch = 0; batch < batch_num; ++batch) {
+                            matmul(batch);
+                        }
+                    }
+                };
+
+                return procedure;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_MATMUL_HPP
@@ -0,0 +1,214 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_REDUCE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_REDUCE_HPP
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for unsupported_operator_attribute error
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+#include <menoh/composite_backend/backend/generic/reduction.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // one reduction pass over x viewed as (outer, r, inner)
+            struct reduction_pass {
+                int outer, r, inner;
+            };
+
+            // Split reduction over `axes` of `dims` into passes. Adjacent
+            // reduced (or kept) axes are merged so each pass reduces one
+            // contiguous block of axes. Passes run from the innermost block
+            inline std::vector<reduction_pass>
+            make_reduction_pass_list(std::vector<int> const& dims,
+                                     std::vector<int> const& axes) {
+                // merged blocks of (size, is_reduced)
+                std::vector<std::pair<int, bool>> blocks;
+                for(int i = 0; i < static_cast<int>(dims.size()); ++i) {
+                    // reducing an axis of size 1 is no-op
+                    bool is_reduced =
+                      dims.at(i) != 1 &&
+                      std::find(axes.begin(), axes.end(), i) != axes.end();
+                    if(!blocks.empty() && blocks.back().second == is_reduced) {
+                        blocks.back().first *= dims.at(i);
+                    } else {
+                        blocks.emplace_back(dims.at(i), is_reduced);
+                    }
+                }
+
+                std::vector<reduction_pass> pass_list;
+                for(int b = static_cast<int>(blocks.size()) - 1; 0 <= b;
+                    --b) {
+                    if(!blocks.at(b).second) {
+                        continue;
+                    }
+                    reduction_pass pass{1, blocks.at(b).first, 1};
+                    for(int i = 0; i < b; ++i) {
+                        pass.outer *= blocks.at(i).first;
+                    }
+                    for(int i = b + 1; i < static_cast<int>(blocks.size());
+                        ++i) {
+                        pass.inner *= blocks.at(i).first;
+                    }
+                    pass_list.push_back(pass);
+                    blocks.at(b).first = 1;
+                }
+                return pass_list;
+            }
+
+            inline procedure make_reduce_procedure(
+              node const& node, array const& input, array const& output,
+              std::vector<int> axes, reduction_type type, bool is_mean) {
+                if(input.dtype() != dtype_t::float_) {
+                    throw invalid_dtype(
+                      std::to_string(static_cast<int>(input.dtype())));
+                }
+
+                auto const& dims = input.dims();
+                int ndims = static_cast<int>(dims.size());
+                for(auto& axis : axes) {
+                    if(axis < -ndims || ndims <= axis) {
+                        throw unsupported_operator_attribute(
+                          node.op_type, node.output_name_list.front(), "axes",
+                          std::to_string(axis),
+                          "[" + std::to_string(-ndims) + ", " +
+                            std::to_string(ndims - 1) + "]");
+                    }
+                    if(axis < 0) {
+                        axis += ndims;
+                    }
+                }
+
+                float scale = 1.f;
+                if(is_mean) {
+                    int count = 1;
+                    for(int i = 0; i < ndims; ++i) {
+                        if(std::find(axes.begin(), axes.end(), i) !=
+                           axes.end()) {
+                            count *= dims.at(i);
+                        }
+                    }
+                    scale = 1.f / count;
+                }
+
+                auto pass_list = make_reduction_pass_list(dims, axes);
+
+                // buffers for intermediate results are allocated once
+                std::vector<std::shared_ptr<std::vector<float>>> buffer_list;
+                for(int i = 0; i + 1 < static_cast<int>(pass_list.size());
+                    ++i) {
+                    buffer_list.push_back(std::make_shared<std::vector<float>>(
+                      static_cast<std::size_t>(pass_list.at(i).outer) *
+                      pass_list.at(i).inner));
+                }
+
+                return [input, output, type, scale, pass_list, buffer_list]() {
+                    int size = static_cast<int>(total_size(output));
+                    float const* src = fbegin(input);
+                    float* y = fbegin(output);
+                    if(pass_list.empty()) {
+                        std::copy(src, src + size, y);
+                    }
+                    for(int i = 0; i < static_cast<int>(pass_list.size());
+                        ++i) {
+                        auto const& pass = pass_list.at(i);
+                        float* dst = i + 1 < static_cast<int>(pass_list.size())
+                                       ? buffer_list.at(i)->data()
+                                       : y;
+                        reduce(type, src, dst, pass.outer, pass.r,
+                               pass.inner);
+                        src = dst;
+                    }
+                    if(scale != 1.f) {
+                        parallel_for(0, size, [y, scale](int i) {
+                            y[i] *= scale;
+                        });
+                    }
+                };
+            }
+
+            inline procedure make_reduce(node const& node,
+                                         std::vector<array> const& input_list,
+                                         std::vector<array> const& output_list,
+                                         reduction_type type, bool is_mean) {
+                assert(input_list.size() == 1);
+                assert(output_list.size() == 1);
+                return make_reduce_procedure(
+                  node, input_list.at(0), output_list.at(0),
+                  attribute_ints(node, "axes"), type, is_mean);
+            }
+
+            inline procedure
+            make_reduce_max(node const& node,
+                            std::vector<array> const& input_list,
+                            std::vector<array> const& output_list) {
+                return make_reduce(node, input_list, output_list,
+                                   reduction_type::max, false);
+            }
+
+            inline procedure
+            make_reduce_mean(node const& node,
+                             std::vector<array> const& input_list,
+                             std::vector<array> const& output_list) {
+                return make_reduce(node, input_list, output_list,
+                                   reduction_type::sum, true);
+            }
+
+            inline procedure
+            make_reduce_min(node const& node,
+                            std::vector<array> const& input_list,
+                            std::vector<array> const& output_list) {
+                return make_reduce(node, input_list, output_list,
+                                   reduction_type::min, false);
+            }
+
+            inline procedure
+            make_reduce_sum(node const& node,
+                            std::vector<array> const& input_list,
+                            std::vector<array> const& output_list) {
+                return make_reduce(node, input_list, output_list,
+                                   reduction_type::sum, false);
+            }
+
+            // GlobalAveragePool and GlobalMaxPool reduce all spatial axes
+            inline std::vector<int> spatial_axes(array const& input) {
+                std::vector<int> axes;
+                for(int i = 2; i < static_cast<int>(input.dims().size());
+                    ++i) {
+                    axes.push_back(i);
+                }
+                return axes;
+            }
+
+            inline procedure
+            make_global_average_pool(node const& node,
+                                     std::vector<array> const& input_list,
+                                     std::vector<array> const& output_list) {
+                assert(input_list.size() == 1);
+                assert(output_list.size() == 1);
+                return make_reduce_procedure(
+                  node, input_list.at(0), output_list.at(0),
+                  spatial_axes(input_list.at(0)), reduction_type::sum, true);
+            }
+
+            inline procedure
+            make_global_max_pool(node const& node,
+                                 std::vector<array> const& input_list,
+                                 std::vector<array> const& output_list) {
+                assert(input_list.size() == 1);
+                assert(output_list.size() == 1);
+                return make_reduce_procedure(
+                  node, input_list.at(0), output_list.at(0),
+                  spatial_axes(input_list.at(0)), reduction_type::max, false);
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_REDUCE_HPP
@@ -0,0 +1,131 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_RESIZE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_RESIZE_HPP
+
+#include <string>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for unsupported_operator_attribute error
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/resize.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // Resize and Upsample of 4-D (N, C, H, W) input over H and W
+            struct resize_configuration {
+                resize_mode mode;
+                resize_axis_table height_table;
+                resize_axis_table width_table;
+            };
+
+            inline resize_configuration
+            make_resize_configuration(node const& node,
+                                      std::vector<int> const& input_dims,
+                                      std::vector<int> const& output_dims) {
+                auto unsupported = [&node](std::string const& name,
+                                           std::string const& value,
+                                           std::string const& valid_value) {
+                    return unsupported_operator_attribute(
+                      node.op_type, node.output_name_list.front(), name,
+                      value, valid_value);
+                };
+
+                auto const& mode_name = attribute_string(node, "mode");
+                resize_mode mode;
+                if(mode_name == "nearest") {
+                    mode = resize_mode::nearest;
+                } else if(mode_name == "linear" || mode_name == "bilinear") {
+                    mode = resize_mode::linear;
+                } else {
+                    throw unsupported("mode", mode_name,
+                                      "nearest, linear or bilinear");
+                }
+
+                auto const& coordinate_mode_name =
+                  attribute_string(node, "coordinate_transformation_mode");
+                resize_coordinate_mode coordinate_mode;
+                if(coordinate_mode_name == "asymmetric") {
+                    coordinate_mode = resize_coordinate_mode::asymmetric;
+                } else if(coordinate_mode_name == "half_pixel") {
+                    coordinate_mode = resize_coordinate_mode::half_pixel;
+                } else if(coordinate_mode_name == "align_corners") {
+                    coordinate_mode = resize_coordinate_mode::align_corners;
+                } else {
+                    throw unsupported("coordinate_transformation_mode",
+                                      coordinate_mode_name,
+                                      "asymmetric, half_pixel or "
+                                      "align_corners");
+                }
+
+                auto const& nearest_mode_name =
+                  attribute_string(node, "nearest_mode");
+                resize_nearest_mode nearest_mode;
+                if(nearest_mode_name == "floor") {
+                    nearest_mode = resize_nearest_mode::floor;
+                } else if(nearest_mode_name == "ceil") {
+                    nearest_mode = resize_nearest_mode::ceil;
+                } else if(nearest_mode_name == "round_prefer_floor") {
+                    nearest_mode = resize_nearest_mode::round_prefer_floor;
+                } else if(nearest_mode_name == "round_prefer_ceil") {
+                    nearest_mode = resize_nearest_mode::round_prefer_ceil;
+                } else {
+                    throw unsupported("nearest_mode", nearest_mode_name,
+                                      "floor, ceil, round_prefer_floor or "
+                                      "round_prefer_ceil");
+                }
+
+                auto const& scales = attribute_floats(node, "scales");
+                if(input_dims.size() != 4 || scales.at(0) != 1.f ||
+                   scales.at(1) != 1.f) {
+                    std::string scales_str;
+                    for(auto s : scales) {
+                        scales_str += std::to_string(s) + " ";
+                    }
+                    throw unsupported("scales", scales_str,
+                                      "(1, 1, scale_h, scale_w)");
+                }
+
+                return resize_configuration{
+                  mode,
+                  make_resize_axis_table(mode, coordinate_mode, nearest_mode,
+                                         input_dims.at(2), output_dims.at(2),
+                                         scales.at(2)),
+                  make_resize_axis_table(mode, coordinate_mode, nearest_mode,
+                                         input_dims.at(3), output_dims.at(3),
+                                         scales.at(3))};
+            }
+
+            inline procedure
+            make_resize(node const& node, std::vector<array> const& input_list,
+                        std::vector<array> const& output_list) {
+                assert(input_list.size() == 1);
+                assert(output_list.size() == 1);
+
+                auto input = input_list.at(0);
+                if(input.dtype() != dtype_t::float_) {
+                    throw invalid_dtype(
+                      std::to_string(static_cast<int>(input.dtype())));
+                }
+                auto output = output_list.at(0);
+                auto conf = make_resize_configuration(node, input.dims(),
+                                                      output.dims());
+
+                auto procedure = [input, output, conf]() {
+                    auto const& dims = input.dims();
+                    resize_2d(conf.mode, fbegin(input), fbegin(output),
+                              dims.at(0) * dims.at(1), 1, dims.at(2),
+                              dims.at(3), conf.height_table,
+                              conf.width_table);
+                };
+
+                return procedure;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_RESIZE_HPP
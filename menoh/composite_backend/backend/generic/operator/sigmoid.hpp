@@ -1,17 +1,18 @@
 #ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_SIGMOID_HPP
 #define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_SIGMOID_HPP
 
-#include <cmath>
-
 #include <menoh/array.hpp>
 #include <menoh/composite_backend/procedure.hpp>
 
+#include <menoh/composite_backend/backend/generic/math.hpp>
+
 namespace menoh_impl {
     namespace composite_backend {
         namespace generic_backend {
             inline procedure
             make_sigmoid(node const&, std::vector<array> const& input_list,
-                         std::vector<array> const& output_list) {
+                         std::vector<array> const& output_list,
+                         math_accuracy accuracy) {
                 assert(input_list.size() == 1);
                 assert(output_list.size() == 1);
 
@@ -20,11 +21,14 @@ namespace menoh_impl {
                     throw std::runtime_error("invalid dtype");
                 }
 
-                auto procedure = [input, output = output_list.at(0)]() {
-                    for(decltype(total_size(input)) i = 0;
-                        i < total_size(input); ++i) {
-                        fat(output, i) = 1 / (1 + std::exp(-fat(input, i)));
-                    }
+                auto procedure = [input, output = output_list.at(0),
+                                  accuracy]() {
+                    parallel_apply(
+                      fbegin(input), fbegin(output),
+                      static_cast<int>(total_size(input)),
+                      [accuracy](float const* x, float* y, int size) {
+                          vsigmoid(accuracy, x, y, size);
+                      });
                 };
 
                 return procedure;
@@ -0,0 +1,172 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_SLICE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_SLICE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/graph.hpp> // for unsupported_operator_attribute error
+#include <menoh/optional.hpp>
+#include <menoh/composite_backend/procedure.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // region of an output of Split or Slice in the input
+            struct slice_region {
+                std::vector<int> starts;
+                std::vector<int> dims;
+            };
+
+            inline int normalize_axis(int axis, int ndims) {
+                return axis < 0 ? axis + ndims : axis;
+            }
+
+            // one region for each output. Attributes are completed and
+            // validated by shape inference
+            inline std::vector<slice_region>
+            make_slice_region_list(node const& node,
+                                   std::vector<int> const& input_dims) {
+                int ndims = static_cast<int>(input_dims.size());
+                std::vector<slice_region> region_list;
+                if(node.op_type == "Split") {
+                    auto axis =
+                      normalize_axis(attribute_int(node, "axis"), ndims);
+                    int start = 0;
+                    for(auto s : attribute_ints(node, "split")) {
+                        slice_region region{std::vector<int>(ndims, 0),
+                                            input_dims};
+                        region.starts.at(axis) = start;
+                        region.dims.at(axis) = s;
+                        region_list.push_back(region);
+                        start += s;
+                    }
+                    return region_list;
+                }
+
+                assert(node.op_type == "Slice");
+                auto const& starts = attribute_ints(node, "starts");
+                auto const& ends = attribute_ints(node, "ends");
+                auto const& axes = attribute_ints(node, "axes");
+                auto const& steps = attribute_ints(node, "steps");
+                slice_region region{std::vector<int>(ndims, 0), input_dims};
+                for(unsigned int i = 0; i < starts.size(); ++i) {
+                    if(steps.at(i) != 1) {
+                        throw unsupported_operator_attribute(
+                          node.op_type, node.output_name_list.front(),
+                          "steps", std::to_string(steps.at(i)), "1");
+                    }
+                    auto axis = normalize_axis(axes.at(i), ndims);
+                    auto dim = input_dims.at(axis);
+                    auto start = std::max(
+                      0, std::min(normalize_axis(starts.at(i), dim), dim));
+                    auto end = std::max(
+                      0, std::min(normalize_axis(ends.at(i), dim), dim));
+                    region.starts.at(axis) = start;
+                    region.dims.at(axis) = std::max(0, end - start);
+                }
+                region_list.push_back(region);
+                return region_list;
+            }
+
+            // offset of the region in the row major input when the region
+            // is contiguous, i.e. the leading axes are 1 except one and the
+            // trailing axes are full
+            inline optional<std::size_t>
+            contiguous_region_offset(std::vector<int> const& input_dims,
+                                     slice_region const& region) {
+                int ndims = static_cast<int>(input_dims.size());
+                int first_partial_axis = 0;
+                while(first_partial_axis < ndims &&
+                      region.dims.at(first_partial_axis) == 1) {
+                    ++first_partial_axis;
+                }
+                for(int i = first_partial_axis + 1; i < ndims; ++i) {
+                    if(region.dims.at(i) != input_dims.at(i)) {
+                        return nullopt;
+                    }
+                }
+                std::size_t offset = 0;
+                for(int i = 0; i < ndims; ++i) {
+                    offset = offset * input_dims.at(i) + region.starts.at(i);
+                }
+                return offset;
+            }
+
+            // Split and Slice outputs which are contiguous in the input are
+            // views of the input and no procedure is needed. Returns nullopt
+            // when any output is not contiguous
+            inline optional<std::vector<array>>
+            make_slice_view(node const& node,
+                            std::vector<array> const& input_list) {
+                assert(input_list.size() == 1);
+                auto const& input = input_list.at(0);
+                auto element_size = get_size_in_bytes(input.dtype());
+                std::vector<array> output_list;
+                for(auto const& region :
+                    make_slice_region_list(node, input.dims())) {
+                    auto offset =
+                      contiguous_region_offset(input.dims(), region);
+                    if(!offset) {
+                        return nullopt;
+                    }
+                    output_list.emplace_back(
+                      input.dtype(), region.dims,
+                      static_cast<char*>(input.data()) +
+                        *offset * element_size);
+                }
+                return output_list;
+            }
+
+            // copy each output region row by row
+            inline procedure
+            make_slice(node const& node, std::vector<array> const& input_list,
+                       std::vector<array> const& output_list) {
+                assert(input_list.size() == 1);
+                auto input = input_list.at(0);
+                auto region_list = make_slice_region_list(node, input.dims());
+                assert(region_list.size() == output_list.size());
+
+                return [input, output_list, region_list]() {
+                    auto const& input_dims = input.dims();
+                    int ndims = static_cast<int>(input_dims.size());
+                    auto element_size = get_size_in_bytes(input.dtype());
+                    for(unsigned int o = 0; o < output_list.size(); ++o) {
+                        auto const& region = region_list.at(o);
+                        auto const* x = static_cast<char const*>(input.data());
+                        auto* y = static_cast<char*>(output_list.at(o).data());
+                        auto row_size =
+                          region.dims.back() * element_size;
+                        int row_num =
+                          static_cast<int>(calc_total_size(region.dims)) /
+                          std::max(region.dims.back(), 1);
+                        parallel_for(0, row_num, [&](int row) {
+                            std::size_t offset = 0;
+                            int rest = row;
+                            std::size_t stride = input_dims.back();
+                            for(int i = ndims - 2; 0 <= i; --i) {
+                                int index = rest % region.dims.at(i);
+                                rest /= region.dims.at(i);
+                                offset +=
+                                  (region.starts.at(i) + index) * stride;
+                                stride *= input_dims.at(i);
+                            }
+                            offset += region.starts.back();
+                            std::copy(x + offset * element_size,
+                                      x + offset * element_size + row_size,
+                                      y + row * row_size);
+                        });
+                    }
+                };
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_OPERATOR_SLICE_HPP
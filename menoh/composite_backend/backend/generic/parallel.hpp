@@ -0,0 +1,42 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_PARALLEL_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_PARALLEL_HPP
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            inline int get_max_thread_num() {
+#ifdef _OPENMP
+                return omp_get_max_threads();
+#else
+                return 1;
+#endif
+            }
+
+            // call f(i) for each i in [begin, end) by using all threads
+            // falls back to serial loop when OpenMP is not available
+            template <typename F>
+            inline void parallel_for(int begin, int end, F f) {
+#ifdef _OPENMP
+                if(end - begin > 1 && !omp_in_parallel()) {
+#pragma omp parallel for schedule(static)
+                    for(int i = begin; i < end; ++i) {
+                        f(i);
+                    }
+                    return;
+                }
+#endif
+                for(int i = begin; i < end; ++i) {
+                    f(i);
+                }
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_PARALLEL_HPP
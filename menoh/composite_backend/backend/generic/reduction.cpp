@@ -0,0 +1,178 @@
+#include <menoh/composite_backend/backend/generic/reduction.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MENOH_GENERIC_REDUCTION_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            namespace {
+
+                // elements per task of parallelized contiguous reduction
+                constexpr int contiguous_chunk_size = 16384;
+
+                // elements of inner axis per task of strided reduction.
+                // the partial result stays in L1
+                constexpr int strided_chunk_size = 1024;
+
+                struct sum_reducer {
+                    static float apply(float a, float b) { return a + b; }
+#ifdef MENOH_GENERIC_REDUCTION_USE_SSE2
+                    static __m128 apply(__m128 a, __m128 b) {
+                        return _mm_add_ps(a, b);
+                    }
+#endif
+                };
+
+                struct max_reducer {
+                    static float apply(float a, float b) {
+                        return std::max(a, b);
+                    }
+#ifdef MENOH_GENERIC_REDUCTION_USE_SSE2
+                    static __m128 apply(__m128 a, __m128 b) {
+                        return _mm_max_ps(a, b);
+                    }
+#endif
+                };
+
+                struct min_reducer {
+                    static float apply(float a, float b) {
+                        return std::min(a, b);
+                    }
+#ifdef MENOH_GENERIC_REDUCTION_USE_SSE2
+                    static __m128 apply(__m128 a, __m128 b) {
+                        return _mm_min_ps(a, b);
+                    }
+#endif
+                };
+
+                // reduce x[0:n] (n >= 1)
+                template <typename Reducer>
+                float reduce_contiguous(float const* x, int n) {
+                    float result = x[0];
+                    int i = 1;
+#ifdef MENOH_GENERIC_REDUCTION_USE_SSE2
+                    if(n >= 8) {
+                        // two accumulators to hide latency
+                        __m128 acc0 = _mm_loadu_ps(x);
+                        __m128 acc1 = _mm_loadu_ps(x + 4);
+                        for(i = 8; i + 8 <= n; i += 8) {
+                            acc0 =
+                              Reducer::apply(acc0, _mm_loadu_ps(x + i));
+                            acc1 =
+                              Reducer::apply(acc1, _mm_loadu_ps(x + i + 4));
+                        }
+                        float lanes[4];
+                        _mm_storeu_ps(lanes, Reducer::apply(acc0, acc1));
+                        result =
+                          Reducer::apply(Reducer::apply(lanes[0], lanes[1]),
+                                         Reducer::apply(lanes[2], lanes[3]));
+                    }
+#endif
+                    for(; i < n; ++i) {
+                        result = Reducer::apply(result, x[i]);
+                    }
+                    return result;
+                }
+
+                // y[i] = reduce(x[0 * stride + i], ..., x[(r-1) * stride + i])
+                // for i in [0, n)
+                template <typename Reducer>
+                void reduce_strided(float const* x, float* y, int r,
+                                    int stride, int n) {
+                    std::copy(x, x + n, y);
+                    for(int k = 1; k < r; ++k) {
+                        float const* xk =
+                          x + static_cast<std::size_t>(k) * stride;
+                        int i = 0;
+#ifdef MENOH_GENERIC_REDUCTION_USE_SSE2
+                        for(; i + 4 <= n; i += 4) {
+                            _mm_storeu_ps(
+                              y + i, Reducer::apply(_mm_loadu_ps(y + i),
+                                                    _mm_loadu_ps(xk + i)));
+                        }
+#endif
+                        for(; i < n; ++i) {
+                            y[i] = Reducer::apply(y[i], xk[i]);
+                        }
+                    }
+                }
+
+                template <typename Reducer>
+                void reduce_impl(float const* x, float* y, int outer, int r,
+                                 int inner) {
+                    if(inner == 1) {
+                        if(outer >= get_max_thread_num() ||
+                           r < 2 * contiguous_chunk_size) {
+                            parallel_for(0, outer, [&](int o) {
+                                y[o] = reduce_contiguous<Reducer>(
+                                  x + static_cast<std::size_t>(o) * r, r);
+                            });
+                            return;
+                        }
+
+                        // too few rows to use all threads. split each row
+                        // and combine partial results
+                        int chunk_num = (r + contiguous_chunk_size - 1) /
+                                        contiguous_chunk_size;
+                        std::vector<float> partial(
+                          static_cast<std::size_t>(outer) * chunk_num);
+                        parallel_for(0, outer * chunk_num, [&](int t) {
+                            int o = t / chunk_num;
+                            int offset = (t % chunk_num) * contiguous_chunk_size;
+                            partial[t] = reduce_contiguous<Reducer>(
+                              x + static_cast<std::size_t>(o) * r + offset,
+                              std::min(contiguous_chunk_size, r - offset));
+                        });
+                        for(int o = 0; o < outer; ++o) {
+                            y[o] = reduce_contiguous<Reducer>(
+                              partial.data() + o * chunk_num, chunk_num);
+                        }
+                        return;
+                    }
+
+                    int chunk_num =
+                      (inner + strided_chunk_size - 1) / strided_chunk_size;
+                    parallel_for(0, outer * chunk_num, [&](int t) {
+                        int o = t / chunk_num;
+                        int offset = (t % chunk_num) * strided_chunk_size;
+                        reduce_strided<Reducer>(
+                          x + static_cast<std::size_t>(o) * r * inner + offset,
+                          y + static_cast<std::size_t>(o) * inner + offset, r,
+                          inner, std::min(strided_chunk_size, inner - offset));
+                    });
+                }
+
+            } // namespace
+
+            void reduce(reduction_type type, float const* x, float* y,
+                        int outer, int r, int inner) {
+                if(outer <= 0 || r <= 0 || inner <= 0) {
+                    return;
+                }
+                switch(type) {
+                    case reduction_type::sum:
+                        reduce_impl<sum_reducer>(x, y, outer, r, inner);
+                        break;
+                    case reduction_type::max:
+                        reduce_impl<max_reducer>(x, y, outer, r, inner);
+                        break;
+                    case reduction_type::min:
+                        reduce_impl<min_reducer>(x, y, outer, r, inner);
+                        break;
+                }
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
@@ -0,0 +1,23 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_REDUCTION_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_REDUCTION_HPP
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            enum class reduction_type { sum, max, min };
+
+            // y[o, i] = reduce(x[o, 0, i], x[o, 1, i], ..., x[o, r-1, i])
+            //
+            // x is (outer, r, inner) and y is (outer, inner) in row major.
+            // Contiguous reductions (inner == 1) are vectorized along r and
+            // strided reductions are vectorized along inner. Both are
+            // parallelized over outer (and r or inner when outer is small).
+            void reduce(reduction_type type, float const* x, float* y,
+                        int outer, int r, int inner);
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_REDUCTION_HPP
@@ -0,0 +1,178 @@
+#include <menoh/composite_backend/backend/generic/resize.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MENOH_GENERIC_RESIZE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            namespace {
+
+                float to_input_coordinate(resize_coordinate_mode mode,
+                                          int input_size, int output_size,
+                                          float scale, int x) {
+                    switch(mode) {
+                        case resize_coordinate_mode::asymmetric:
+                            return x / scale;
+                        case resize_coordinate_mode::half_pixel:
+                            return (x + 0.5f) / scale - 0.5f;
+                        case resize_coordinate_mode::align_corners:
+                            return output_size == 1
+                                     ? 0.f
+                                     : static_cast<float>(x) *
+                                         (input_size - 1) / (output_size - 1);
+                    }
+                    return 0.f; // unreachable
+                }
+
+                int round_coordinate(resize_nearest_mode mode, float x) {
+                    switch(mode) {
+                        case resize_nearest_mode::floor:
+                            return static_cast<int>(std::floor(x));
+                        case resize_nearest_mode::ceil:
+                            return static_cast<int>(std::ceil(x));
+                        case resize_nearest_mode::round_prefer_floor:
+                            return static_cast<int>(std::ceil(x - 0.5f));
+                        case resize_nearest_mode::round_prefer_ceil:
+                            return static_cast<int>(std::floor(x + 0.5f));
+                    }
+                    return 0; // unreachable
+                }
+
+                // y[0:n] = x[0:n]
+                inline void copy_block(float const* x, float* y, int n) {
+                    int i = 0;
+#ifdef MENOH_GENERIC_RESIZE_USE_SSE2
+                    for(; i + 4 <= n; i += 4) {
+                        _mm_storeu_ps(y + i, _mm_loadu_ps(x + i));
+                    }
+#endif
+                    for(; i < n; ++i) {
+                        y[i] = x[i];
+                    }
+                }
+
+                // bilinear interpolation of blocks a (top left), b (top
+                // right), c (bottom left) and d (bottom right)
+                inline void lerp_block(float const* a, float const* b,
+                                       float const* c, float const* d,
+                                       float wx, float wy, float* y, int n) {
+                    int i = 0;
+#ifdef MENOH_GENERIC_RESIZE_USE_SSE2
+                    __m128 vwx = _mm_set1_ps(wx);
+                    __m128 vwy = _mm_set1_ps(wy);
+                    for(; i + 4 <= n; i += 4) {
+                        __m128 va = _mm_loadu_ps(a + i);
+                        __m128 vc = _mm_loadu_ps(c + i);
+                        __m128 top = _mm_add_ps(
+                          va,
+                          _mm_mul_ps(vwx, _mm_sub_ps(_mm_loadu_ps(b + i), va)));
+                        __m128 bottom = _mm_add_ps(
+                          vc,
+                          _mm_mul_ps(vwx, _mm_sub_ps(_mm_loadu_ps(d + i), vc)));
+                        _mm_storeu_ps(
+                          y + i,
+                          _mm_add_ps(top,
+                                     _mm_mul_ps(vwy, _mm_sub_ps(bottom, top))));
+                    }
+#endif
+                    for(; i < n; ++i) {
+                        float top = a[i] + wx * (b[i] - a[i]);
+                        float bottom = c[i] + wx * (d[i] - c[i]);
+                        y[i] = top + wy * (bottom - top);
+                    }
+                }
+
+            } // namespace
+
+            resize_axis_table
+            make_resize_axis_table(resize_mode mode,
+                                   resize_coordinate_mode coordinate_mode,
+                                   resize_nearest_mode nearest_mode,
+                                   int input_size, int output_size,
+                                   float scale) {
+                resize_axis_table table;
+                for(int i = 0; i < output_size; ++i) {
+                    auto x = to_input_coordinate(coordinate_mode, input_size,
+                                                 output_size, scale, i);
+                    if(mode == resize_mode::nearest) {
+                        auto index = round_coordinate(nearest_mode, x);
+                        table.index0.push_back(
+                          std::min(std::max(index, 0), input_size - 1));
+                        continue;
+                    }
+                    x = std::min(std::max(x, 0.f),
+                                 static_cast<float>(input_size - 1));
+                    auto index0 = static_cast<int>(x);
+                    table.index0.push_back(index0);
+                    table.index1.push_back(
+                      std::min(index0 + 1, input_size - 1));
+                    table.weight1.push_back(x - index0);
+                }
+                return table;
+            }
+
+            void resize_2d(resize_mode mode, float const* x, float* y,
+                           int plane_num, int block, int input_height,
+                           int input_width,
+                           resize_axis_table const& height_table,
+                           resize_axis_table const& width_table) {
+                int output_height =
+                  static_cast<int>(height_table.index0.size());
+                int output_width = static_cast<int>(width_table.index0.size());
+                auto input_row_size =
+                  static_cast<std::size_t>(input_width) * block;
+                auto output_row_size =
+                  static_cast<std::size_t>(output_width) * block;
+
+                parallel_for(0, plane_num * output_height, [&](int t) {
+                    int p = t / output_height;
+                    int oy = t % output_height;
+                    float const* x_plane =
+                      x + static_cast<std::size_t>(p) * input_height *
+                            input_row_size;
+                    float* y_row = y + static_cast<std::size_t>(t) *
+                                         output_row_size;
+                    float const* row0 =
+                      x_plane + height_table.index0[oy] * input_row_size;
+
+                    if(mode == resize_mode::nearest) {
+                        if(block == 1) {
+                            for(int ox = 0; ox < output_width; ++ox) {
+                                y_row[ox] = row0[width_table.index0[ox]];
+                            }
+                            return;
+                        }
+                        for(int ox = 0; ox < output_width; ++ox) {
+                            copy_block(row0 + width_table.index0[ox] * block,
+                                       y_row + ox * block, block);
+                        }
+                        return;
+                    }
+
+                    float const* row1 =
+                      x_plane + height_table.index1[oy] * input_row_size;
+                    float wy = height_table.weight1[oy];
+                    for(int ox = 0; ox < output_width; ++ox) {
+                        int i0 = width_table.index0[ox] * block;
+                        int i1 = width_table.index1[ox] * block;
+                        lerp_block(row0 + i0, row0 + i1, row1 + i0,
+                                   row1 + i1, width_table.weight1[ox], wy,
+                                   y_row + ox * block, block);
+                    }
+                });
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
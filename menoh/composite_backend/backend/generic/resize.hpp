@@ -0,0 +1,61 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_RESIZE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_RESIZE_HPP
+
+#include <vector>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            enum class resize_mode { nearest, linear };
+
+            // how output coordinate is mapped to input coordinate
+            enum class resize_coordinate_mode {
+                asymmetric,   // x_out / scale
+                half_pixel,   // (x_out + 0.5) / scale - 0.5
+                align_corners // x_out * (in - 1) / (out - 1)
+            };
+
+            // how input coordinate is rounded in nearest mode
+            enum class resize_nearest_mode {
+                floor,
+                ceil,
+                round_prefer_floor,
+                round_prefer_ceil
+            };
+
+            // Source indices of each output index along one axis. Nearest
+            // mode uses index0 only. Linear mode interpolates index0 and
+            // index1 by weight1
+            struct resize_axis_table {
+                std::vector<int> index0;
+                std::vector<int> index1;
+                std::vector<float> weight1;
+            };
+
+            resize_axis_table
+            make_resize_axis_table(resize_mode mode,
+                                   resize_coordinate_mode coordinate_mode,
+                                   resize_nearest_mode nearest_mode,
+                                   int input_size, int output_size,
+                                   float scale);
+
+            // y[p, oy, ox, b] = resize(x[p, :, :, b]) at (oy, ox)
+            //
+            // x is (plane_num, input_height, input_width, block) and y is
+            // (plane_num, output_height, output_width, block) in row major.
+            // Plain NCHW is block == 1 with plane_num == N * C. mkldnn
+            // nChw8c and nChw16c are block == 8 and 16 with plane_num ==
+            // N * ceil(C / block). Blocks are vectorized and (plane, output
+            // row) pairs are parallelized
+            void resize_2d(resize_mode mode, float const* x, float* y,
+                           int plane_num, int block, int input_height,
+                           int input_width,
+                           resize_axis_table const& height_table,
+                           resize_axis_table const& width_table);
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_RESIZE_HPP
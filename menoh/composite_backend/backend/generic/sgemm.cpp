@@ -0,0 +1,173 @@
+#include <menoh/composite_backend/backend/generic/sgemm.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            namespace {
+
+                // register block (micro tile) size
+                constexpr int mr = 4;
+                constexpr int nr = 16;
+
+                // cache block size
+                // packed B panel (kc x nr) stays in L1, packed A block
+                // (mc x kc) stays in L2
+                constexpr int mc = 256;
+                constexpr int kc = 256;
+                constexpr int nc = 4096;
+
+                inline int round_up(int x, int unit) {
+                    return (x + unit - 1) / unit * unit;
+                }
+
+                // pack op(A)[i0:i0+mcur, p0:p0+kcur] into mr-row panels
+                void pack_a_panel(bool trans_a, float const* a, int lda,
+                                  int i0, int p0, int mrcur, int kcur,
+                                  float* dst) {
+                    for(int p = 0; p < kcur; ++p) {
+                        for(int i = 0; i < mr; ++i) {
+                            float v = 0.f;
+                            if(i < mrcur) {
+                                v = trans_a ? a[(p0 + p) * lda + (i0 + i)]
+                                            : a[(i0 + i) * lda + (p0 + p)];
+                            }
+                            dst[p * mr + i] = v;
+                        }
+                    }
+                }
+
+                // pack op(B)[p0:p0+kcur, j0:j0+nrcur] into a nr-column panel
+                void pack_b_panel(bool trans_b, float const* b, int ldb,
+                                  int p0, int j0, int kcur, int nrcur,
+                                  float* dst) {
+                    for(int p = 0; p < kcur; ++p) {
+                        for(int j = 0; j < nr; ++j) {
+                            float v = 0.f;
+                            if(j < nrcur) {
+                                v = trans_b ? b[(j0 + j) * ldb + (p0 + p)]
+                                            : b[(p0 + p) * ldb + (j0 + j)];
+                            }
+                            dst[p * nr + j] = v;
+                        }
+                    }
+                }
+
+                // c[0:mrcur, 0:nrcur] = alpha * pa * pb + beta * c
+                // accumulators are kept in registers. The inner loop over
+                // nr is a fixed size loop so compilers can vectorize it
+                void micro_kernel(int kcur, float const* pa, float const* pb,
+                                  float alpha, float beta, float* c, int ldc,
+                                  int mrcur, int nrcur) {
+                    float acc[mr][nr] = {};
+                    for(int p = 0; p < kcur; ++p) {
+                        float const* ap = pa + p * mr;
+                        float const* bp = pb + p * nr;
+                        for(int i = 0; i < mr; ++i) {
+                            float av = ap[i];
+                            for(int j = 0; j < nr; ++j) {
+                                acc[i][j] += av * bp[j];
+                            }
+                        }
+                    }
+                    for(int i = 0; i < mrcur; ++i) {
+                        float* cp = c + i * ldc;
+                        if(beta == 0.f) {
+                            for(int j = 0; j < nrcur; ++j) {
+                                cp[j] = alpha * acc[i][j];
+                            }
+                        } else {
+                            for(int j = 0; j < nrcur; ++j) {
+                                cp[j] = alpha * acc[i][j] + beta * cp[j];
+                            }
+                        }
+                    }
+                }
+
+                void scale_c(int m, int n, float beta, float* c, int ldc) {
+                    parallel_for(0, m, [=](int i) {
+                        float* cp = c + i * ldc;
+                        if(beta == 0.f) {
+                            std::fill(cp, cp + n, 0.f);
+                        } else {
+                            for(int j = 0; j < n; ++j) {
+                                cp[j] *= beta;
+                            }
+                        }
+                    });
+                }
+
+            } // namespace
+
+            void sgemm(bool trans_a, bool trans_b, int m, int n, int k,
+                       float alpha, float const* a, int lda, float const* b,
+                       int ldb, float beta, float* c, int ldc) {
+                if(m <= 0 || n <= 0) {
+                    return;
+                }
+                if(k <= 0 || alpha == 0.f) {
+                    if(beta != 1.f) {
+                        scale_c(m, n, beta, c, ldc);
+                    }
+                    return;
+                }
+
+                // packing buffers are reused between calls on the same thread
+                thread_local std::vector<float> packed_a_buffer;
+                thread_local std::vector<float> packed_b_buffer;
+
+                for(int j0 = 0; j0 < n; j0 += nc) {
+                    int ncur = std::min(nc, n - j0);
+                    int b_panel_num = (ncur + nr - 1) / nr;
+                    for(int p0 = 0; p0 < k; p0 += kc) {
+                        int kcur = std::min(kc, k - p0);
+                        float beta_cur = p0 == 0 ? beta : 1.f;
+
+                        packed_b_buffer.resize(b_panel_num * nr * kcur);
+                        float* pb = packed_b_buffer.data();
+                        parallel_for(0, b_panel_num, [&](int jp) {
+                            int jr = jp * nr;
+                            pack_b_panel(trans_b, b, ldb, p0, j0 + jr, kcur,
+                                         std::min(nr, ncur - jr),
+                                         pb + jr * kcur);
+                        });
+
+                        for(int i0 = 0; i0 < m; i0 += mc) {
+                            int mcur = std::min(mc, m - i0);
+                            int a_panel_num = (mcur + mr - 1) / mr;
+
+                            packed_a_buffer.resize(round_up(mcur, mr) * kcur);
+                            float* pa = packed_a_buffer.data();
+                            parallel_for(0, a_panel_num, [&](int ip) {
+                                int ir = ip * mr;
+                                pack_a_panel(trans_a, a, lda, i0 + ir, p0,
+                                             std::min(mr, mcur - ir), kcur,
+                                             pa + ir * kcur);
+                            });
+
+                            // distribute micro tiles over threads. Tiles
+                            // sharing the same B panel are adjacent
+                            parallel_for(
+                              0, a_panel_num * b_panel_num, [&](int t) {
+                                  int jr = (t / a_panel_num) * nr;
+                                  int ir = (t % a_panel_num) * mr;
+                                  micro_kernel(
+                                    kcur, pa + ir * kcur, pb + jr * kcur,
+                                    alpha, beta_cur,
+                                    c + (i0 + ir) * ldc + (j0 + jr), ldc,
+                                    std::min(mr, mcur - ir),
+                                    std::min(nr, ncur - jr));
+                              });
+                        }
+                    }
+                }
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
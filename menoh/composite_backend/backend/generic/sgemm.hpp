@@ -0,0 +1,21 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_SGEMM_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_SGEMM_HPP
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // C = alpha * op(A) * op(B) + beta * C
+            //
+            // All matrices are row major. op(A) is m x k, op(B) is k x n and
+            // C is m x n. When beta is 0, C is not read (so it can be
+            // uninitialized).
+            void sgemm(bool trans_a, bool trans_b, int m, int n, int k,
+                       float alpha, float const* a, int lda, float const* b,
+                       int ldb, float beta, float* c, int ldc);
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_SGEMM_HPP
@@ -0,0 +1,57 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_WEIGHT_EXPANSION_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_WEIGHT_EXPANSION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <menoh/array.hpp>
+
+#include <menoh/composite_backend/backend/generic/parallel.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace generic_backend {
+
+            // Weight kept in float16 or bfloat16 is expanded into a buffer
+            // shared by all procedures on the calling thread just before it
+            // is used, so only one layer is expanded at once. The returned
+            // pointer is valid until next call. float array is returned as
+            // is
+            inline float const* expand_weight(array const& weight) {
+                if(weight.dtype() == dtype_t::float_) {
+                    return fbegin(weight);
+                }
+                if(!is_reduced_precision_float(weight.dtype())) {
+                    throw invalid_dtype(
+                      std::to_string(static_cast<int>(weight.dtype())));
+                }
+                static thread_local std::vector<float> buffer;
+                auto size = total_size(weight);
+                if(buffer.size() < size) {
+                    buffer.resize(size);
+                }
+
+                constexpr int chunk_size = 16384;
+                int chunk_num =
+                  static_cast<int>((size + chunk_size - 1) / chunk_size);
+                auto src = static_cast<std::uint16_t const*>(weight.data());
+                float* dst = buffer.data();
+                auto to_float = weight.dtype() == dtype_t::float16
+                                  ? float16_to_float
+                                  : bfloat16_to_float;
+                parallel_for(0, chunk_num, [=](int c) {
+                    auto first = static_cast<std::size_t>(c) * chunk_size;
+                    auto last = std::min<std::size_t>(size, first + chunk_size);
+                    std::transform(src + first, src + last, dst + first,
+                                   to_float);
+                });
+                return dst;
+            }
+
+        } // namespace generic_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_GENERIC_WEIGHT_EXPANSION_HPP
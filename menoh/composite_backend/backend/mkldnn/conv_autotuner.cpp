@@ -0,0 +1,146 @@
+#include <menoh/composite_backend/backend/mkldnn/conv_autotuner.hpp>
+
+#include <fstream>
+
+#include <menoh/exception.hpp>
+#include <menoh/json.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            namespace {
+
+                std::string algorithm_to_string(mkldnn::algorithm alg) {
+                    return alg == mkldnn::algorithm::convolution_winograd
+                             ? "winograd"
+                             : "direct";
+                }
+
+                mkldnn::algorithm string_to_algorithm(std::string const& str) {
+                    if(str == "winograd") {
+                        return mkldnn::algorithm::convolution_winograd;
+                    }
+                    if(str == "direct") {
+                        return mkldnn::algorithm::convolution_direct;
+                    }
+                    throw invalid_backend_config_error(
+                      "invalid algorithm in conv tuning cache: " + str);
+                }
+
+            } // namespace
+
+            std::vector<conv_choice> conv_choice_candidate_list() {
+                return {{mkldnn::algorithm::convolution_direct, false},
+                        {mkldnn::algorithm::convolution_direct, true},
+                        {mkldnn::algorithm::convolution_winograd, false},
+                        {mkldnn::algorithm::convolution_winograd, true}};
+            }
+
+            std::string cpu_isa_name() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+                __builtin_cpu_init();
+                if(__builtin_cpu_supports("avx512bw")) {
+                    return "avx512_core";
+                }
+                if(__builtin_cpu_supports("avx512f")) {
+                    return "avx512_common";
+                }
+                if(__builtin_cpu_supports("avx2")) {
+                    return "avx2";
+                }
+                if(__builtin_cpu_supports("avx")) {
+                    return "avx";
+                }
+                if(__builtin_cpu_supports("sse4.2")) {
+                    return "sse42";
+                }
+                return "x86";
+#else
+                return "unknown";
+#endif
+            }
+
+            conv_autotuner::conv_autotuner(
+              optional<std::string> const& cache_filename,
+              bool is_tuning_enabled)
+              : cache_filename_(cache_filename),
+                is_tuning_enabled_(is_tuning_enabled) {
+                if(!cache_filename_) {
+                    return;
+                }
+                std::ifstream ifs(*cache_filename_);
+                if(!ifs) {
+                    return; // created by save()
+                }
+                try {
+                    nlohmann::json j;
+                    ifs >> j;
+                    auto const& entries = j.at("entries");
+                    for(auto it = entries.begin(); it != entries.end();
+                        ++it) {
+                        auto const& choice = it.value();
+                        cache_.emplace(
+                          it.key(),
+                          conv_choice{
+                            string_to_algorithm(
+                              choice.at("algorithm").get<std::string>()),
+                            choice.at("layout").get<std::string>() ==
+                              "plain"});
+                    }
+                } catch(nlohmann::json::exception const& e) {
+                    throw json_parse_error(*cache_filename_ + ": " +
+                                           e.what());
+                }
+            }
+
+            conv_choice conv_autotuner::choose(
+              std::string const& layer_signature,
+              std::function<optional<double>(conv_choice const&)> const&
+                measure) {
+                auto key = cpu_isa_name() + "|" + layer_signature;
+                auto found = cache_.find(key);
+                if(found != cache_.end()) {
+                    return found->second;
+                }
+                if(!is_tuning_enabled_) {
+                    return default_conv_choice();
+                }
+
+                auto best_choice = default_conv_choice();
+                optional<double> best_time;
+                for(auto const& candidate : conv_choice_candidate_list()) {
+                    auto time = measure(candidate);
+                    if(time && (!best_time || *time < *best_time)) {
+                        best_choice = candidate;
+                        best_time = time;
+                    }
+                }
+                cache_.emplace(key, best_choice);
+                is_updated_ = true;
+                return best_choice;
+            }
+
+            void conv_autotuner::save() {
+                if(!cache_filename_ || !is_updated_) {
+                    return;
+                }
+                nlohmann::json entries = nlohmann::json::object();
+                for(auto const& p : cache_) {
+                    entries[p.first] = {
+                      {"algorithm", algorithm_to_string(p.second.algorithm)},
+                      {"layout",
+                       p.second.is_plain_layout ? "plain" : "blocked"}};
+                }
+                nlohmann::json j = {{"version", 1}, {"entries", entries}};
+                std::ofstream ofs(*cache_filename_);
+                if(!ofs) {
+                    throw invalid_filename(*cache_filename_);
+                }
+                ofs << j.dump(2) << std::endl;
+                is_updated_ = false;
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
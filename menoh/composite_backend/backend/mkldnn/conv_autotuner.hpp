@@ -0,0 +1,69 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_CONV_AUTOTUNER_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_CONV_AUTOTUNER_HPP
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <menoh/optional.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // algorithm and layout of convolution primitive
+            struct conv_choice {
+                mkldnn::algorithm algorithm;
+                // plain layout uses nchw input and output. Otherwise mkldnn
+                // chooses (maybe blocked) layout
+                bool is_plain_layout;
+            };
+
+            inline conv_choice default_conv_choice() {
+                return conv_choice{mkldnn::algorithm::convolution_direct,
+                                   false};
+            }
+
+            std::vector<conv_choice> conv_choice_candidate_list();
+
+            // name of the best instruction set of this CPU. Tuning results
+            // are reused only on CPUs with the same one
+            std::string cpu_isa_name();
+
+            // Choose the fastest conv_choice for each layer signature.
+            // Results are persisted in the tuning cache file (JSON) keyed by
+            // layer signature and cpu_isa_name() by save()
+            class conv_autotuner {
+            public:
+                // choices are loaded from `cache_filename` when it exists.
+                // When `is_tuning_enabled` is false, layers not in the cache
+                // use default_conv_choice() and nothing is timed
+                conv_autotuner(optional<std::string> const& cache_filename,
+                               bool is_tuning_enabled);
+
+                // `measure` returns elapsed time of given candidate or
+                // nullopt when the candidate is not available
+                conv_choice choose(
+                  std::string const& layer_signature,
+                  std::function<optional<double>(conv_choice const&)> const&
+                    measure);
+
+                // writes all choices to the cache file when new ones were
+                // chosen. Called once after all layers of a model are built
+                void save();
+
+            private:
+                optional<std::string> cache_filename_;
+                bool is_tuning_enabled_;
+                bool is_updated_ = false;
+                std::unordered_map<std::string, conv_choice> cache_;
+            };
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_CONV_AUTOTUNER_HPP
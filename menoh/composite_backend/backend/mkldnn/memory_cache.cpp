@@ -9,6 +9,7 @@ namespace menoh_impl {
             std::tuple<mkldnn::memory, optional<mkldnn::primitive>>
             memory_cache::get_memory(std::vector<int> const& dims,
                                      mkldnn::memory::format format) {
+                last_format_ = format;
                 {
                     // search matched memory
                     auto found = std::find_if(
@@ -58,11 +59,8 @@ namespace menoh_impl {
                         mkldnn::memory new_memory(
                           {{{dims}, extract_data_type(found_memory), format},
                            engine()});
-                        auto reorder_primitive =
-                          mkldnn::reorder(found_memory,
-                                          new_memory);
                         add_cached_memory(new_memory);
-                        return std::make_tuple(new_memory, reorder_primitive);
+                        return reorder(found_memory, new_memory);
                     }
                 }
 
@@ -91,10 +89,20 @@ namespace menoh_impl {
                 mkldnn::memory new_memory(
                   {{{dims}, original_dtype, format}, engine()});
                 add_cached_memory(new_memory);
+                return reorder(base_memory, new_memory);
+            }
 
-                auto reorder_primitive =
-                  mkldnn::reorder(base_memory, new_memory);
-                return std::make_tuple(new_memory, reorder_primitive);
+            std::tuple<mkldnn::memory, optional<mkldnn::primitive>>
+            memory_cache::reorder(mkldnn::memory const& from,
+                                  mkldnn::memory const& to) {
+                auto reorder_primitive = mkldnn::reorder(from, to);
+                if(is_constant_) {
+                    mkldnn::stream(mkldnn::stream::kind::eager)
+                      .submit({reorder_primitive})
+                      .wait();
+                    return std::make_tuple(to, nullopt);
+                }
+                return std::make_tuple(to, reorder_primitive);
             }
 
             mkldnn::memory memory_cache::get_data_memory() {
@@ -106,6 +114,7 @@ namespace menoh_impl {
 
                 // when found data format type memory
                 if(found != cached_memory_list_.end()) {
+                    last_format_ = extract_format(*found);
                     return *found;
                 }
 
@@ -119,6 +128,7 @@ namespace menoh_impl {
                    engine()},
                   const_cast<void*>(original_array_->data()));
                 add_cached_memory(base_memory);
+                last_format_ = extract_format(base_memory);
                 return base_memory;
             }
 
@@ -5,6 +5,7 @@
 #include <tuple>
 
 #include <menoh/array.hpp>
+#include <menoh/memory_stats.hpp>
 #include <menoh/optional.hpp>
 
 #include <menoh/composite_backend/backend/mkldnn/memory_conversion.hpp>
@@ -21,6 +22,14 @@ namespace menoh_impl {
 
                 memory_cache(array const& arr, mkldnn::engine const& engine)
                   : original_array_(arr), engine_(engine) {}
+                // Memories of a constant cache are reordered when they are
+                // got and no primitive is returned, so they are only read at
+                // run time
+                memory_cache(array const& arr, mkldnn::engine const& engine,
+                             bool is_constant)
+                  : original_array_(arr),
+                    engine_(engine),
+                    is_constant_(is_constant) {}
                 explicit memory_cache(mkldnn::memory const& mem)
                   : cached_memory_list_({mem}),
                     engine_(mem.get_primitive_desc().get_engine()) {}
@@ -53,6 +62,16 @@ namespace menoh_impl {
 
                 mkldnn::memory get_data_memory();
 
+                // the format last got from the cache, or the one it is made
+                // in when not got yet. format_undef when neither is known
+                mkldnn::memory::format last_format() const {
+                    if(last_format_ != mkldnn::memory::format::format_undef ||
+                       cached_memory_list_.empty()) {
+                        return last_format_;
+                    }
+                    return extract_format(cached_memory_list_.front());
+                }
+
                 void add_cached_memory(mkldnn::memory const& added_memory) {
                     // check format is different
                     // MEMO: dims may be different (eg FC's weight for 4d input
@@ -72,10 +91,33 @@ namespace menoh_impl {
                     cached_memory_list_.push_back(added_memory);
                 }
 
+                // the original array as `original_category` and memories in
+                // other formats as `cached_category`
+                void collect_memory_stats(std::string const& name,
+                                          memory_category original_category,
+                                          memory_category cached_category,
+                                          memory_stats& stats) const {
+                    if(original_array_) {
+                        stats.add(name, original_category, *original_array_);
+                    }
+                    for(auto const& cached_memory : cached_memory_list_) {
+                        stats.add(
+                          name, cached_category,
+                          cached_memory.get_data_handle(),
+                          cached_memory.get_primitive_desc().get_size());
+                    }
+                }
+
             private:
+                std::tuple<mkldnn::memory, optional<mkldnn::primitive>>
+                reorder(mkldnn::memory const& from, mkldnn::memory const& to);
+
                 optional<array> original_array_ = nullopt;
                 std::vector<mkldnn::memory> cached_memory_list_;
                 optional<mkldnn::engine> engine_;
+                bool is_constant_ = false;
+                mkldnn::memory::format last_format_ =
+                  mkldnn::memory::format::format_undef;
             };
 
             mkldnn::memory inline get_memory(
@@ -2,24 +2,83 @@
 #include <menoh/composite_backend/backend/mkldnn/mkldnn_context.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator.hpp>
 
-#include <menoh/graph.hpp> // for unsupported_operator error
+#include <menoh/graph.hpp> // for make_last_use_index_table
 
 namespace menoh_impl {
     namespace composite_backend {
         namespace mkldnn_backend {
 
-            mkldnn_context::mkldnn_context() : context() {
+            mkldnn_context::mkldnn_context()
+              : mkldnn_context(nullopt, nullptr) {}
+
+            mkldnn_context::mkldnn_context(
+              optional<calibration_table> const& calibration_table_opt,
+              std::shared_ptr<conv_autotuner> const& conv_autotuner_ptr,
+              std::shared_ptr<shared_weight_cache> const& weight_cache_ptr)
+              : context(),
+                weight_cache_(weight_cache_ptr
+                                ? weight_cache_ptr
+                                : std::make_shared<shared_weight_cache>()),
+                engine_(weight_cache_->engine()),
+                calibration_table_(calibration_table_opt),
+                conv_autotuner_(conv_autotuner_ptr) {
                 using namespace composite_backend::mkldnn_backend;
 
                 // BatchNormalization
                 procedure_factory_table_.emplace(
                   "BatchNormalization", mkldnn_backend::make_batch_norm);
 
-                // Conv
-                procedure_factory_table_.emplace("Conv", make_conv);
+                // Concat
+                procedure_factory_table_.emplace("Concat", make_concat);
+
+                // Conv and ConvTranspose
+                procedure_factory conv_factory = make_conv;
+                if(conv_autotuner_) {
+                    auto tuner = conv_autotuner_;
+                    conv_factory =
+                      [tuner](
+                        MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                          return make_tuned_conv(
+                            *tuner,
+                            MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                      };
+                }
+                if(calibration_table_) {
+                    // Conv falling back to f32 is reported to the logger of
+                    // the current do_process_node_list() call
+                    auto const& table = *calibration_table_;
+                    auto const& logger = logger_;
+                    conv_factory =
+                      [&table, &logger, conv_factory](
+                        MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                          return make_quantized_conv(
+                            table, conv_factory, logger,
+                            MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                      };
+                }
+                procedure_factory_table_.emplace("Conv", conv_factory);
+                // weights of ConvTranspose which are parameters are
+                // transposed at build time
+                auto const& parameter_name_set = parameter_name_set_;
+                procedure_factory_table_.emplace(
+                  "ConvTranspose",
+                  [&parameter_name_set](
+                    MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                      return make_conv_transpose(
+                        parameter_name_set.find(node.input_name_list.at(1)) !=
+                          parameter_name_set.end(),
+                        MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                  });
 
-                // Gemm
+                // Gemm and FC
                 procedure_factory_table_.emplace("Gemm", make_gemm);
+                procedure_factory_table_.emplace("FC", make_fc);
+
+                // LRN
+                procedure_factory_table_.emplace("LRN", make_lrn);
+
+                // MatMul
+                procedure_factory_table_.emplace("MatMul", make_matmul);
 
                 // Eltwise
                 procedure_factory_table_.emplace("Abs", make_abs);
@@ -33,6 +92,18 @@ namespace menoh_impl {
                 procedure_factory_table_.emplace("AveragePool",
                                                  make_average_pool);
                 procedure_factory_table_.emplace("MaxPool", make_max_pool);
+                procedure_factory_table_.emplace("GlobalAveragePool",
+                                                 make_global_average_pool);
+                procedure_factory_table_.emplace("GlobalMaxPool",
+                                                 make_global_max_pool);
+
+                // Resize and Upsample
+                procedure_factory_table_.emplace("Resize", make_resize);
+                procedure_factory_table_.emplace("Upsample", make_resize);
+
+                // Slice and Split
+                procedure_factory_table_.emplace("Slice", make_slice);
+                procedure_factory_table_.emplace("Split", make_slice);
 
                 // Softmax
                 procedure_factory_table_.emplace("Softmax", make_softmax);
@@ -40,12 +111,72 @@ namespace menoh_impl {
                 // Sum and Add
                 procedure_factory_table_.emplace("Sum", make_sum);
                 procedure_factory_table_.emplace("Add", make_sum);
+
+                // ops able to overwrite their input
+                inplace_op_type_set_ = {"Abs",  "Elu",  "LeakyRelu", "Relu",
+                                        "Sqrt", "Tanh", "Sum",       "Add"};
+
+                // ops whose outputs may share memory with their input
+                view_op_type_set_ = {"Slice", "Split"};
+            }
+
+            namespace {
+                procedure make_primitive_list_procedure(
+                  std::vector<mkldnn::primitive> const& primitive_list) {
+                    auto runner = std::make_shared<
+                      menoh_impl::mkldnn_backend::primitive_list_runner>(
+                      primitive_list);
+                    return [runner]() { runner->run(); };
+                }
+            } // namespace
+
+            optional<formatted_array> mkldnn_context::make_inplace_output(
+              node const& node, int node_index,
+              std::vector<std::reference_wrapper<memory_cache>> const&
+                input_memory_cache_list,
+              std::unordered_map<std::string, array> const&
+                required_output_table,
+              array_profile const& output_profile) {
+                if(inplace_op_type_set_.find(node.op_type) ==
+                     inplace_op_type_set_.end() ||
+                   node.input_name_list.size() > 2 ||
+                   node.output_name_list.size() != 1) {
+                    return nullopt;
+                }
+                // Sum writes its output in the format of the first input
+                auto first_input_format = extract_format(
+                  input_memory_cache_list.at(0).get().get_data_memory());
+                for(unsigned int i = 0; i < node.input_name_list.size();
+                    ++i) {
+                    auto const& input_name = node.input_name_list.at(i);
+                    if(produced_variable_name_set_.find(input_name) ==
+                         produced_variable_name_set_.end() ||
+                       required_output_table.find(input_name) !=
+                         required_output_table.end() ||
+                       last_use_index_table_opt_->at(input_name) !=
+                         node_index) {
+                        continue;
+                    }
+                    auto input_memory =
+                      input_memory_cache_list.at(i).get().get_data_memory();
+                    if(extract_format(input_memory) != first_input_format ||
+                       extract_dims(input_memory) != output_profile.dims() ||
+                       mkldnn_memory_data_type_to_dtype(
+                         extract_data_type(input_memory)) !=
+                         output_profile.dtype()) {
+                        continue;
+                    }
+                    return formatted_array(
+                      first_input_format,
+                      array(output_profile, input_memory.get_data_handle()));
+                }
+                return nullopt;
             }
 
             optional<std::tuple<std::vector<procedure>, int>>
             mkldnn_context::do_process_node_list(
               std::string const& context_name, int current_index,
-              std::vector<node> const& node_list,
+              int end_index, std::vector<node> const& node_list,
               std::unordered_map<std::string, array> const&
                 common_parameter_table,
               std::unordered_map<std::string, array> const& common_input_table,
@@ -59,13 +190,18 @@ namespace menoh_impl {
               logger_handle logger) {
                 static_cast<void>(output_profile_table); // maybe unused
 
+                logger_ = logger;
+                if(!last_use_index_table_opt_) {
+                    last_use_index_table_opt_ =
+                      make_last_use_index_table(node_list);
+                }
+
                 auto first_node_index = current_index;
                 std::vector<procedure> procedure_list;
 
                 std::vector<mkldnn::primitive> primitive_list;
 
-                for(; current_index < static_cast<int>(node_list.size());
-                    ++current_index) {
+                for(; current_index < end_index; ++current_index) {
                     auto const& node = node_list.at(current_index);
 
                     std::vector<procedure> new_copy_procedure_list;
@@ -73,6 +209,9 @@ namespace menoh_impl {
                     std::vector<memory_cache> new_output_memory_cache_list;
                     std::vector<std::pair<std::string, memory_cache>>
                       new_named_temp_memory_cache_list;
+                    std::vector<std::pair<std::string, memory_cache>>
+                      new_named_weight_memory_cache_list;
+                    std::vector<procedure> new_procedure_list;
 
                     try {
                         std::vector<std::reference_wrapper<memory_cache>>
@@ -96,7 +235,8 @@ namespace menoh_impl {
                                     }
                                 }
 
-                                // search in common parameter table
+                                // search in common parameter table. Its
+                                // memories are kept in the weight cache
                                 {
                                     auto found =
                                       common_parameter_table.find(input_name);
@@ -105,16 +245,12 @@ namespace menoh_impl {
                                                 << " is found from self common "
                                                    "parameter table"
                                                 << std::endl;
-                                        auto result_pair =
-                                          variable_memory_cache_table_.emplace(
-                                            input_name,
-                                            memory_cache(found->second,
-                                                         engine_));
-                                        assert(
-                                          result_pair.second &&
-                                          "already same named variable exist");
+                                        parameter_name_set_.insert(input_name);
                                         input_memory_cache_list.push_back(
-                                          std::ref(result_pair.first->second));
+                                          std::ref(
+                                            weight_cache_
+                                              ->get_parameter_memory_cache(
+                                                input_name, found->second)));
                                         break;
                                     }
                                 }
@@ -191,6 +327,19 @@ namespace menoh_impl {
                               "variable have not already exist");
                             if(found == required_output_table.end()) {
                                 // not required output
+                                auto inplace_output = make_inplace_output(
+                                  node, current_index, input_memory_cache_list,
+                                  required_output_table,
+                                  output_profile_table.at(output_name));
+                                if(inplace_output) {
+                                    *logger << output_name
+                                            << " shares memory with its input"
+                                            << std::endl;
+                                    output_formatted_array_list.push_back(
+                                      *inplace_output);
+                                    continue;
+                                }
+
                                 // add `any` format memory
                                 auto arr =
                                   array(output_profile_table.at(output_name));
@@ -224,6 +373,12 @@ namespace menoh_impl {
                           factory_return.output_memory_cache_list;
                         new_named_temp_memory_cache_list =
                           factory_return.named_temp_memory_cache_list;
+                        new_named_weight_memory_cache_list =
+                          factory_return.named_weight_memory_cache_list;
+                        new_procedure_list = factory_return.procedures;
+                    } catch(invalid_backend_config_error const&) {
+                        // other contexts can not fix the config
+                        throw;
                     } catch(std::exception const& e) {
                         *logger << e.what() << std::endl;
                         break;
@@ -239,16 +394,49 @@ namespace menoh_impl {
                       std::make_move_iterator(new_copy_procedure_list.begin()),
                       std::make_move_iterator(new_copy_procedure_list.end()));
 
-                    // update context
+                    // primitives so far run before non mkldnn kernels
+                    if(!new_procedure_list.empty()) {
+                        if(!primitive_list.empty()) {
+                            procedure_list.push_back(
+                              make_primitive_list_procedure(primitive_list));
+                            primitive_list.clear();
+                        }
+                        procedure_list.insert(
+                          procedure_list.end(),
+                          std::make_move_iterator(new_procedure_list.begin()),
+                          std::make_move_iterator(new_procedure_list.end()));
+                    }
+
+                    // update context. Views and their input are never
+                    // overwritten in place
+                    bool is_view_op = view_op_type_set_.find(node.op_type) !=
+                                      view_op_type_set_.end();
                     for(unsigned int i = 0; i < node.output_name_list.size();
                         ++i) {
                         variable_memory_cache_table_.emplace(
                           node.output_name_list.at(i),
                           new_output_memory_cache_list.at(i));
+                        if(!is_view_op) {
+                            produced_variable_name_set_.insert(
+                              node.output_name_list.at(i));
+                        }
+                    }
+                    if(is_view_op) {
+                        for(auto const& input_name : node.input_name_list) {
+                            produced_variable_name_set_.erase(input_name);
+                        }
                     }
                     temp_memory_cache_table_.insert(
                       new_named_temp_memory_cache_list.begin(),
                       new_named_temp_memory_cache_list.end());
+                    bool is_weight_parameter =
+                      1 < node.input_name_list.size() &&
+                      parameter_name_set_.find(node.input_name_list.at(1)) !=
+                        parameter_name_set_.end();
+                    (is_weight_parameter ? packed_weight_memory_cache_table_
+                                         : temp_memory_cache_table_)
+                      .insert(new_named_weight_memory_cache_list.begin(),
+                              new_named_weight_memory_cache_list.end());
                 }
 
                 // when no nodes are processed
@@ -256,11 +444,10 @@ namespace menoh_impl {
                     return nullopt;
                 }
 
-                procedure_list.emplace_back([this, primitive_list]() {
-                    mkldnn::stream(mkldnn::stream::kind::eager)
-                      .submit(primitive_list)
-                      .wait();
-                });
+                if(!primitive_list.empty()) {
+                    procedure_list.push_back(
+                      make_primitive_list_procedure(primitive_list));
+                }
 
                 return std::make_tuple(procedure_list, current_index);
             }
@@ -1,22 +1,27 @@
 #ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_MKLDNN_CONTEXT_HPP
 #define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_MKLDNN_CONTEXT_HPP
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <mkldnn.hpp>
 
 #include <menoh/any.hpp>
 #include <menoh/array.hpp>
+#include <menoh/calibration_table.hpp>
 #include <menoh/mkldnn/utility.hpp>
 #include <menoh/model_core.hpp>
 
 #include <menoh/composite_backend/context.hpp>
 
+#include <menoh/composite_backend/backend/mkldnn/conv_autotuner.hpp>
 #include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
 #include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
 #include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+#include <menoh/composite_backend/backend/mkldnn/shared_weight_cache.hpp>
 
 namespace menoh_impl {
     namespace composite_backend {
@@ -26,6 +31,16 @@ namespace menoh_impl {
             public:
                 mkldnn_context();
 
+                // Conv is computed in int8 with ranges in the table and its
+                // algorithm and layout are chosen by the autotuner.
+                // Parameters are got from the weight cache, which is shared
+                // with contexts of other models when given
+                mkldnn_context(
+                  optional<calibration_table> const& calibration_table_opt,
+                  std::shared_ptr<conv_autotuner> const& conv_autotuner_ptr,
+                  std::shared_ptr<shared_weight_cache> const&
+                    weight_cache_ptr = nullptr);
+
             private:
                 virtual optional<std::tuple<procedure, array>>
                 do_try_to_get_variable(std::string const& name) override {
@@ -33,6 +48,9 @@ namespace menoh_impl {
                     if(found == variable_memory_cache_table_.end()) {
                         return nullopt;
                     }
+                    // other contexts may keep views of the returned array
+                    // so it is never overwritten in place
+                    produced_variable_name_set_.erase(name);
                     auto& variable_memory_cache = found->second;
                     std::vector<mkldnn::primitive> primitives;
                     auto variable_memory =
@@ -44,14 +62,13 @@ namespace menoh_impl {
                              mkldnn::memory::format::nchw ||
                            extract_format(variable_memory) ==
                              mkldnn::memory::format::nc);
-                    procedure copy_proc =
-                      primitives.empty()
-                        ? procedure(nullptr)
-                        : procedure([primitives] {
-                              mkldnn::stream(mkldnn::stream::kind::eager)
-                                .submit(primitives)
-                                .wait();
-                          });
+                    procedure copy_proc = nullptr;
+                    if(!primitives.empty()) {
+                        auto runner = std::make_shared<
+                          menoh_impl::mkldnn_backend::primitive_list_runner>(
+                          std::move(primitives));
+                        copy_proc = [runner]() { runner->run(); };
+                    }
                     return std::make_tuple(
                       copy_proc, array(mkldnn_memory_data_type_to_dtype(
                                          extract_data_type(variable_memory)),
@@ -62,7 +79,7 @@ namespace menoh_impl {
                 virtual optional<std::tuple<std::vector<procedure>, int>>
                 do_process_node_list(
                   std::string const& context_name, int current_index,
-                  std::vector<node> const& node_list,
+                  int end_index, std::vector<node> const& node_list,
                   std::unordered_map<std::string, array> const&
                     common_parameter_table,
                   std::unordered_map<std::string, array> const&
@@ -82,14 +99,86 @@ namespace menoh_impl {
                     return variable_memory_cache_table_.at(name);
                 }
 
+                virtual std::string do_get_variable_format_name(
+                  std::string const& name) const override {
+                    auto found = variable_memory_cache_table_.find(name);
+                    if(found != variable_memory_cache_table_.end()) {
+                        return menoh_impl::mkldnn_backend::format_to_string(
+                          found->second.last_format());
+                    }
+                    if(parameter_name_set_.find(name) !=
+                       parameter_name_set_.end()) {
+                        return menoh_impl::mkldnn_backend::format_to_string(
+                          weight_cache_->find_parameter_memory_cache(name)
+                            ->last_format());
+                    }
+                    return "";
+                }
+
+                // other formats of parameters and weights made from them by
+                // factories are packed weights. Other temp memories are
+                // scratch
+                virtual void
+                do_collect_memory_stats(memory_stats& stats) const override {
+                    for(auto const& name : parameter_name_set_) {
+                        weight_cache_->find_parameter_memory_cache(name)
+                          ->collect_memory_stats(
+                            name, memory_category::parameter,
+                            memory_category::packed_weight, stats);
+                    }
+                    for(auto const& p : variable_memory_cache_table_) {
+                        p.second.collect_memory_stats(
+                          p.first, memory_category::activation,
+                          memory_category::activation, stats);
+                    }
+                    for(auto const& p : packed_weight_memory_cache_table_) {
+                        p.second.collect_memory_stats(
+                          p.first, memory_category::packed_weight,
+                          memory_category::packed_weight, stats);
+                    }
+                    for(auto const& p : temp_memory_cache_table_) {
+                        p.second.collect_memory_stats(
+                          p.first, memory_category::scratch,
+                          memory_category::scratch, stats);
+                    }
+                    // not added above when outputs are not made yet
+                    for(auto const& arr : allocated_array_list_) {
+                        stats.add("", memory_category::activation, arr);
+                    }
+                }
+
+                // Output of eltwise and 2-input Sum (Add) shares memory with
+                // its input when the input is made by this context and not
+                // used after the node. Returns nullopt when not possible
+                optional<formatted_array> make_inplace_output(
+                  node const& node, int node_index,
+                  std::vector<std::reference_wrapper<memory_cache>> const&
+                    input_memory_cache_list,
+                  std::unordered_map<std::string, array> const&
+                    required_output_table,
+                  array_profile const& output_profile);
+
+                std::shared_ptr<shared_weight_cache> weight_cache_;
                 mkldnn::engine engine_{mkldnn::engine::kind::cpu, 0}; // TODO
                 std::vector<array> allocated_array_list_;
                 std::unordered_map<std::string, memory_cache>
                   variable_memory_cache_table_;
                 std::unordered_map<std::string, memory_cache>
                   temp_memory_cache_table_;
+                std::unordered_map<std::string, memory_cache>
+                  packed_weight_memory_cache_table_;
                 std::unordered_map<std::string, procedure_factory>
                   procedure_factory_table_;
+                optional<calibration_table> calibration_table_;
+                std::shared_ptr<conv_autotuner> conv_autotuner_;
+                logger_handle logger_ = nullptr;
+
+                std::unordered_set<std::string> inplace_op_type_set_;
+                std::unordered_set<std::string> view_op_type_set_;
+                std::unordered_set<std::string> produced_variable_name_set_;
+                std::unordered_set<std::string> parameter_name_set_;
+                optional<std::unordered_map<std::string, int>>
+                  last_use_index_table_opt_;
             };
 
         } // namespace mkldnn_backend
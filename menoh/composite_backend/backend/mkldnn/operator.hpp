@@ -2,10 +2,17 @@
 #define MENOH_IMPL_MKLDNN_WITH_MKLDNN_FALLBACK_BACKEND_OPERATOR_OPERATOR_HPP
 
 #include <menoh/composite_backend/backend/mkldnn/operator/batch_norm.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/concat.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/conv.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/conv_transpose.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/eltwise.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/gemm.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/lrn.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/matmul.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/pool.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/quantized_conv.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/resize.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/slice.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/softmax.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/sum.hpp>
 
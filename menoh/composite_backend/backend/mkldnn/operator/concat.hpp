@@ -0,0 +1,66 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONCAT_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONCAT_HPP
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            inline procedure_factory_return_type
+            make_concat(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                auto output_dims =
+                  output_formatted_array_list.at(0).array().dims();
+                auto axis = attribute_int(node, "axis");
+                if(axis < 0) {
+                    axis += static_cast<int>(output_dims.size());
+                }
+
+                std::vector<mkldnn::memory> input_memory_list;
+                for(memory_cache& input_memory_cache :
+                    input_memory_cache_list) {
+                    input_memory_list.push_back(
+                      input_memory_cache.get_data_memory());
+                }
+                std::vector<mkldnn::memory::primitive_desc>
+                  input_memory_pd_list;
+                for(auto const& input_memory : input_memory_list) {
+                    input_memory_pd_list.push_back(
+                      input_memory.get_primitive_desc());
+                }
+
+                auto concat_output_md = mkldnn::memory::desc(
+                  {output_dims},
+                  dtype_to_mkldnn_memory_data_type(
+                    output_formatted_array_list.at(0).array().dtype()),
+                  mkldnn::memory::format::any);
+                mkldnn::concat::primitive_desc concat_pd(
+                  concat_output_md, axis, input_memory_pd_list);
+
+                auto output_memory_cache = manage_output(
+                  output_formatted_array_list.at(0),
+                  concat_pd.dst_primitive_desc(), engine, primitives,
+                  [&concat_pd,
+                   &input_memory_list](mkldnn::memory const& output_memory) {
+                      std::vector<mkldnn::primitive::at> inputs(
+                        input_memory_list.begin(), input_memory_list.end());
+                      return mkldnn::concat(concat_pd, inputs, output_memory);
+                  });
+
+                return procedure_factory_return_type{
+                  primitives, {output_memory_cache}, {}};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONCAT_HPP
@@ -1,6 +1,13 @@
 #ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONV_HPP
 #define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONV_HPP
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <menoh/composite_backend/backend/mkldnn/conv_autotuner.hpp>
 #include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
 #include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
 #include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
@@ -12,96 +19,196 @@ namespace menoh_impl {
     namespace composite_backend {
         namespace mkldnn_backend {
 
-            inline procedure_factory_return_type
-            make_conv(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+            inline mkldnn::convolution_forward::desc make_conv_desc(
+              mkldnn::algorithm algorithm,
+              mkldnn::memory::desc const& conv_input_md,
+              mkldnn::memory::desc const& conv_weight_md,
+              optional<mkldnn::memory::desc> const& bias_md_opt,
+              mkldnn::memory::desc const& conv_output_md,
+              std::vector<int> const& strides,
+              std::vector<int> const& dilations,
+              std::vector<int> const& padding_l,
+              std::vector<int> const& padding_r) {
+                auto is_no_dilations =
+                  std::all_of(dilations.begin(), dilations.end(),
+                              [](auto e) { return e == 1; });
+                if(is_no_dilations) {
+                    if(bias_md_opt) {
+                        return mkldnn::convolution_forward::desc(
+                          mkldnn::prop_kind::forward_inference, algorithm,
+                          conv_input_md, conv_weight_md, *bias_md_opt,
+                          conv_output_md, strides, padding_l, padding_r,
+                          mkldnn::padding_kind::zero);
+                    }
+                    return mkldnn::convolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference, algorithm,
+                      conv_input_md, conv_weight_md, conv_output_md, strides,
+                      padding_l, padding_r, mkldnn::padding_kind::zero);
+                }
 
-                std::vector<mkldnn::primitive> primitives;
+                // mkldnn counts dilations from 0 while ONNX does from 1
+                std::vector<int> mkldnn_dilations;
+                for(auto d : dilations) {
+                    mkldnn_dilations.push_back(d - 1);
+                }
+                if(bias_md_opt) {
+                    return mkldnn::convolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference, algorithm,
+                      conv_input_md, conv_weight_md, *bias_md_opt,
+                      conv_output_md, strides, mkldnn_dilations, padding_l,
+                      padding_r, mkldnn::padding_kind::zero);
+                }
+                return mkldnn::convolution_forward::desc(
+                  mkldnn::prop_kind::forward_inference, algorithm,
+                  conv_input_md, conv_weight_md, conv_output_md, strides,
+                  mkldnn_dilations, padding_l, padding_r,
+                  mkldnn::padding_kind::zero);
+            }
 
-                std::vector<int> strides, kernel_shape, pads;
-                std::tie(strides, kernel_shape, pads) =
+            // convolution configured by node attributes and input dims
+            struct conv_configuration {
+                std::vector<int> strides;
+                std::vector<int> dilations;
+                std::vector<int> padding_l;
+                std::vector<int> padding_r;
+                int group;
+                std::vector<int> input_dims;
+                std::vector<int> weight_dims;
+                // grouped (and depthwise) convolution takes 5-D weight
+                // (g, oc/g, ic, kh, kw) in goihw or its blocked formats
+                std::vector<int> conv_weight_dims;
+                std::vector<int> output_dims;
+                mkldnn::memory::data_type data_type;
+            };
+
+            inline conv_configuration make_conv_configuration(
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                static_cast<void>(engine); // unused
+
+                conv_configuration conf;
+                std::vector<int> kernel_shape, pads;
+                std::tie(conf.strides, kernel_shape, pads) =
                   attributes_for_2d_data_processing(node);
-                std::vector<int> padding_l{pads[0], pads[1]};
-                std::vector<int> padding_r{pads[2], pads[3]};
+                conf.padding_l = std::vector<int>{pads[0], pads[1]};
+                conf.padding_r = std::vector<int>{pads[2], pads[3]};
+                conf.dilations = attribute_ints(node, "dilations");
 
                 memory_cache& input_memory_cache =
                   input_memory_cache_list.at(0);
-                auto input_dims = input_memory_cache.dims();
+                conf.input_dims = input_memory_cache.dims();
+                conf.data_type = input_memory_cache.data_type();
 
                 memory_cache& weight_memory_cache =
                   input_memory_cache_list.at(1);
-                auto weight_dims = weight_memory_cache.dims();
+                conf.weight_dims = weight_memory_cache.dims();
+
+                conf.group = attribute_int(node, "group");
+                conf.conv_weight_dims = conf.weight_dims;
+                if(conf.group != 1) {
+                    if(conf.weight_dims.size() != 4) {
+                        throw failed_to_configure_operator(
+                          node.op_type, node.output_name_list.at(0),
+                          "grouped convolution supports only 4-D weight but "
+                          "given: " +
+                            std::to_string(conf.weight_dims.size()) + "-D");
+                    }
+                    conf.conv_weight_dims = std::vector<int>{
+                      conf.group, conf.weight_dims.at(0) / conf.group,
+                      conf.weight_dims.at(1), conf.weight_dims.at(2),
+                      conf.weight_dims.at(3)};
+                }
 
-                auto output_dims =
+                conf.output_dims =
                   output_formatted_array_list.at(0).array().dims();
-                assert(output_dims.at(0) == input_dims.at(0) &&
+                assert(conf.output_dims.at(0) == conf.input_dims.at(0) &&
                        "invalid shape inference");
+                return conf;
+            }
+
+            inline mkldnn::convolution_forward::primitive_desc
+            make_conv_primitive_desc(conv_configuration const& conf,
+                                     conv_choice const& choice,
+                                     optional<mkldnn::memory::desc> const&
+                                       bias_md_opt,
+                                     mkldnn::engine const& engine) {
+                auto data_format = choice.is_plain_layout
+                                     ? mkldnn::memory::format::nchw
+                                     : mkldnn::memory::format::any;
                 auto conv_input_md = mkldnn::memory::desc(
-                  {input_dims}, input_memory_cache.data_type(),
-                  mkldnn::memory::format::any);
+                  {conf.input_dims}, conf.data_type, data_format);
                 auto conv_weight_md = mkldnn::memory::desc(
-                  {weight_dims}, weight_memory_cache.data_type(),
+                  {conf.conv_weight_dims}, conf.data_type,
                   mkldnn::memory::format::any);
                 auto conv_output_md = mkldnn::memory::desc(
-                  {output_dims}, input_memory_cache.data_type(),
-                  mkldnn::memory::format::any);
+                  {conf.output_dims}, conf.data_type, data_format);
+                return mkldnn::convolution_forward::primitive_desc(
+                  make_conv_desc(choice.algorithm, conv_input_md,
+                                 conv_weight_md, bias_md_opt, conv_output_md,
+                                 conf.strides, conf.dilations, conf.padding_l,
+                                 conf.padding_r),
+                  engine);
+            }
 
-                optional<mkldnn::memory> bias_memory_opt;
-                menoh_impl::optional<mkldnn::convolution_forward::desc>
-                  conv_desc_opt;
-                auto dilations = attribute_ints(node, "dilations");
-                auto is_no_dilations =
-                  std::all_of(dilations.begin(), dilations.end(),
-                              [](auto e) { return e == 1; });
-                if(node.input_name_list.size() == 2) {
-                    if(is_no_dilations) {
-                        conv_desc_opt = mkldnn::convolution_forward::desc(
-                          mkldnn::prop_kind::forward_inference,
-                          mkldnn::algorithm::convolution_direct, conv_input_md,
-                          conv_weight_md, conv_output_md, strides, padding_l,
-                          padding_r, mkldnn::padding_kind::zero);
-                    } else {
-                        conv_desc_opt = mkldnn::convolution_forward::desc(
-                          mkldnn::prop_kind::forward_inference,
-                          mkldnn::algorithm::convolution_direct, conv_input_md,
-                          conv_weight_md, conv_output_md, strides, dilations,
-                          padding_l, padding_r, mkldnn::padding_kind::zero);
-                    }
-                } else {
-                    assert(node.input_name_list.size() == 3);
+            inline procedure_factory_return_type make_conv_impl(
+              conv_choice const& choice,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
 
+                auto conf = make_conv_configuration(
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                memory_cache& weight_memory_cache =
+                  input_memory_cache_list.at(1);
+
+                optional<mkldnn::memory> bias_memory_opt;
+                optional<mkldnn::memory::desc> bias_md_opt;
+                if(node.input_name_list.size() == 3) {
                     memory_cache& bias_memory_cache =
                       input_memory_cache_list.at(2);
                     bias_memory_opt = get_memory(
                       bias_memory_cache, mkldnn::memory::format::x, primitives);
-
-                    if(is_no_dilations) {
-                        conv_desc_opt = mkldnn::convolution_forward::desc(
-                          mkldnn::prop_kind::forward_inference,
-                          mkldnn::algorithm::convolution_direct, conv_input_md,
-                          conv_weight_md,
-                          bias_memory_opt->get_primitive_desc().desc(),
-                          conv_output_md, strides, padding_l, padding_r,
-                          mkldnn::padding_kind::zero);
-                    } else {
-                        conv_desc_opt = mkldnn::convolution_forward::desc(
-                          mkldnn::prop_kind::forward_inference,
-                          mkldnn::algorithm::convolution_direct, conv_input_md,
-                          conv_weight_md,
-                          bias_memory_opt->get_primitive_desc().desc(),
-                          conv_output_md, strides, dilations, padding_l,
-                          padding_r, mkldnn::padding_kind::zero);
-                    }
+                    bias_md_opt = bias_memory_opt->get_primitive_desc().desc();
+                } else {
+                    assert(node.input_name_list.size() == 2);
                 }
-                auto conv_desc = *conv_desc_opt;
-                auto conv_pd = mkldnn::convolution_forward::primitive_desc(
-                  conv_desc, engine);
+                auto conv_pd =
+                  make_conv_primitive_desc(conf, choice, bias_md_opt, engine);
 
                 auto input_memory = get_memory(
                   input_memory_cache,
                   extract_format(conv_pd.src_primitive_desc()), primitives);
-                auto weight_memory = get_memory(
-                  weight_memory_cache, weight_dims,
-                  extract_format(conv_pd.weights_primitive_desc()), primitives);
+                std::vector<std::pair<std::string, memory_cache>>
+                  named_weight_memory_cache_list;
+                optional<mkldnn::memory> weight_memory_opt;
+                if(conf.group == 1) {
+                    weight_memory_opt = get_memory(
+                      weight_memory_cache, conf.weight_dims,
+                      extract_format(conv_pd.weights_primitive_desc()),
+                      primitives);
+                } else {
+                    // view plain oihw weight as goihw and reorder it
+                    auto oihw_weight_memory =
+                      get_memory(weight_memory_cache, conf.weight_dims,
+                                 mkldnn::memory::format::oihw, primitives);
+                    memory_cache grouped_weight_memory_cache(mkldnn::memory(
+                      {{{conf.conv_weight_dims},
+                        weight_memory_cache.data_type(),
+                        mkldnn::memory::format::goihw},
+                       engine},
+                      oihw_weight_memory.get_data_handle()));
+                    weight_memory_opt = get_memory(
+                      grouped_weight_memory_cache, conf.conv_weight_dims,
+                      extract_format(conv_pd.weights_primitive_desc()),
+                      primitives);
+                    named_weight_memory_cache_list.emplace_back(
+                      "menoh_mkldnn_temp_memory_" + node.op_type + "_" +
+                        node.output_name_list.front() +
+                        "_grouped_weight_memory",
+                      grouped_weight_memory_cache);
+                }
+                auto weight_memory = *weight_memory_opt;
 
                 auto output_memory_cache = manage_output(
                   output_formatted_array_list.at(0),
@@ -120,7 +227,151 @@ namespace menoh_impl {
                   });
 
                 return procedure_factory_return_type{
-                  primitives, {output_memory_cache}, {}};
+                  primitives, {output_memory_cache}, {}, {},
+                  named_weight_memory_cache_list};
+            }
+
+            inline procedure_factory_return_type
+            make_conv(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                return make_conv_impl(
+                  default_conv_choice(),
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
+            // Elapsed seconds of convolution including reorders from
+            // `input_format` and to `output_format_opt` (when output format
+            // is fixed). Best of several runs on zero filled buffers
+            inline double measure_conv(
+              conv_configuration const& conf,
+              mkldnn::convolution_forward::primitive_desc const& conv_pd,
+              bool has_bias, mkldnn::memory::format input_format,
+              optional<mkldnn::memory::format> const& output_format_opt,
+              mkldnn::engine const& engine) {
+                auto make_zero_memory =
+                  [](mkldnn::memory::primitive_desc const& pd) {
+                      mkldnn::memory mem(pd);
+                      std::memset(mem.get_data_handle(), 0, pd.get_size());
+                      return mem;
+                  };
+                std::vector<mkldnn::memory> memory_list; // keep alive
+                std::vector<mkldnn::primitive> primitives;
+
+                auto input_memory =
+                  make_zero_memory(conv_pd.src_primitive_desc());
+                if(extract_format(input_memory) != input_format) {
+                    auto given_input_memory = make_zero_memory(
+                      {{{conf.input_dims}, conf.data_type, input_format},
+                       engine});
+                    memory_list.push_back(given_input_memory);
+                    primitives.push_back(
+                      mkldnn::reorder(given_input_memory, input_memory));
+                }
+                auto weight_memory =
+                  make_zero_memory(conv_pd.weights_primitive_desc());
+                auto output_memory =
+                  make_zero_memory(conv_pd.dst_primitive_desc());
+                if(has_bias) {
+                    auto bias_memory =
+                      make_zero_memory(conv_pd.bias_primitive_desc());
+                    memory_list.push_back(bias_memory);
+                    primitives.push_back(mkldnn::convolution_forward(
+                      conv_pd, input_memory, weight_memory, bias_memory,
+                      output_memory));
+                } else {
+                    primitives.push_back(mkldnn::convolution_forward(
+                      conv_pd, input_memory, weight_memory, output_memory));
+                }
+                if(output_format_opt &&
+                   extract_format(output_memory) != *output_format_opt) {
+                    auto required_output_memory = make_zero_memory(
+                      {{{conf.output_dims}, conf.data_type,
+                        *output_format_opt},
+                       engine});
+                    memory_list.push_back(required_output_memory);
+                    primitives.push_back(
+                      mkldnn::reorder(output_memory, required_output_memory));
+                }
+
+                auto run = [&primitives]() {
+                    mkldnn::stream(mkldnn::stream::kind::eager)
+                      .submit(primitives)
+                      .wait();
+                };
+                run(); // warm up
+                constexpr int measure_num = 5;
+                auto best_time = std::numeric_limits<double>::max();
+                for(int i = 0; i < measure_num; ++i) {
+                    auto start = std::chrono::steady_clock::now();
+                    run();
+                    std::chrono::duration<double> elapsed =
+                      std::chrono::steady_clock::now() - start;
+                    best_time = std::min(best_time, elapsed.count());
+                }
+                return best_time;
+            }
+
+            // Conv with algorithm and layout chosen by conv_autotuner. The
+            // layer signature contains shapes, attributes and whether the
+            // neighbour layouts are plain
+            inline procedure_factory_return_type make_tuned_conv(
+              conv_autotuner& tuner,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                auto conf = make_conv_configuration(
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                auto input_format =
+                  extract_format(input_memory_cache.get_data_memory());
+                optional<mkldnn::memory::format> output_format_opt;
+                if(!is_format_any(output_formatted_array_list.at(0))) {
+                    output_format_opt =
+                      output_formatted_array_list.at(0).format();
+                }
+                bool has_bias = node.input_name_list.size() == 3;
+                optional<mkldnn::memory::desc> bias_md_opt;
+                if(has_bias) {
+                    bias_md_opt = mkldnn::memory::desc(
+                      {conf.output_dims.at(1)}, conf.data_type,
+                      mkldnn::memory::format::x);
+                }
+
+                auto dims_to_string = [](std::vector<int> const& dims) {
+                    std::string str;
+                    for(auto d : dims) {
+                        str += std::to_string(d) + "x";
+                    }
+                    return str;
+                };
+                auto signature =
+                  node.op_type + " input=" + dims_to_string(conf.input_dims) +
+                  " weight=" + dims_to_string(conf.conv_weight_dims) +
+                  " output=" + dims_to_string(conf.output_dims) +
+                  " strides=" + dims_to_string(conf.strides) +
+                  " dilations=" + dims_to_string(conf.dilations) +
+                  " pads=" + dims_to_string(conf.padding_l) +
+                  dims_to_string(conf.padding_r) +
+                  " bias=" + std::to_string(has_bias) + " input_layout=" +
+                  (input_format == mkldnn::memory::format::nchw ? "plain"
+                                                                : "blocked") +
+                  " output_layout=" +
+                  (output_format_opt ? "plain" : "any");
+
+                auto choice = tuner.choose(
+                  signature,
+                  [&](conv_choice const& candidate) -> optional<double> {
+                      try {
+                          auto conv_pd = make_conv_primitive_desc(
+                            conf, candidate, bias_md_opt, engine);
+                          return measure_conv(conf, conv_pd, has_bias,
+                                              input_format, output_format_opt,
+                                              engine);
+                      } catch(mkldnn::error const&) {
+                          return nullopt; // not available
+                      }
+                  });
+                return make_conv_impl(
+                  choice, MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
             }
 
         } // namespace mkldnn_backend
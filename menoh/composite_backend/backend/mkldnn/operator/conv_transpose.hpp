@@ -0,0 +1,247 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONV_TRANSPOSE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONV_TRANSPOSE_HPP
+
+#include <algorithm>
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // ONNX weight (C_in, C_out/g, kh, kw) is (g, C_in/g, C_out/g, kh,
+            // kw) and mkldnn weight is (g, C_out/g, C_in/g, kh, kw), or
+            // (C_out, C_in, kh, kw) when group is 1. A weight which is a
+            // parameter is transposed once at build time. Otherwise it is
+            // transposed by reorders in each run, which supports only group 1
+            inline procedure_factory_return_type make_conv_transpose(
+              bool is_weight_parameter,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                auto group = attribute_int(node, "group");
+                auto dilations = attribute_ints(node, "dilations");
+                if(!std::all_of(dilations.begin(), dilations.end(),
+                                [](auto e) { return e == 1; })) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "dilations of ConvTranspose must be 1");
+                }
+
+                std::vector<int> strides, kernel_shape, pads;
+                std::tie(strides, kernel_shape, pads) =
+                  attributes_for_2d_data_processing(node);
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                auto input_dims = input_memory_cache.dims();
+
+                memory_cache& weight_memory_cache =
+                  input_memory_cache_list.at(1);
+                auto onnx_weight_dims = weight_memory_cache.dims();
+                if(onnx_weight_dims.size() != 4 ||
+                   weight_memory_cache.data_type() !=
+                     mkldnn::memory::data_type::f32) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "ConvTranspose supports only 4-D f32 weight");
+                }
+                if(group != 1 && !is_weight_parameter) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "weight of grouped ConvTranspose must be a parameter");
+                }
+                int group_input_channel_num = onnx_weight_dims.at(0) / group;
+                int group_output_channel_num = onnx_weight_dims.at(1);
+                std::vector<int> weight_dims{
+                  group, group_output_channel_num, group_input_channel_num,
+                  onnx_weight_dims.at(2), onnx_weight_dims.at(3)};
+                if(group == 1) {
+                    weight_dims.erase(weight_dims.begin());
+                }
+
+                auto output_dims =
+                  output_formatted_array_list.at(0).array().dims();
+                assert(output_dims.at(0) == input_dims.at(0) &&
+                       "invalid shape inference");
+                assert(output_dims.at(1) == group * group_output_channel_num &&
+                       "invalid shape inference");
+
+                // output_padding is added to the end side
+                std::vector<int> padding_l{pads[0], pads[1]};
+                std::vector<int> padding_r(2);
+                for(int i = 0; i < 2; ++i) {
+                    padding_r.at(i) =
+                      strides.at(i) * (input_dims.at(2 + i) - 1) +
+                      kernel_shape.at(i) - padding_l.at(i) -
+                      output_dims.at(2 + i);
+                }
+
+                auto deconv_input_md = mkldnn::memory::desc(
+                  {input_dims}, input_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+                auto deconv_weight_md = mkldnn::memory::desc(
+                  {weight_dims}, weight_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+                auto deconv_output_md = mkldnn::memory::desc(
+                  {output_dims}, input_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+
+                optional<mkldnn::memory> bias_memory_opt;
+                optional<mkldnn::deconvolution_forward::desc> deconv_desc_opt;
+                if(node.input_name_list.size() == 2) {
+                    deconv_desc_opt = mkldnn::deconvolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference,
+                      mkldnn::algorithm::deconvolution_direct, deconv_input_md,
+                      deconv_weight_md, deconv_output_md, strides, padding_l,
+                      padding_r, mkldnn::padding_kind::zero);
+                } else {
+                    assert(node.input_name_list.size() == 3);
+
+                    memory_cache& bias_memory_cache =
+                      input_memory_cache_list.at(2);
+                    bias_memory_opt = get_memory(
+                      bias_memory_cache, mkldnn::memory::format::x, primitives);
+
+                    deconv_desc_opt = mkldnn::deconvolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference,
+                      mkldnn::algorithm::deconvolution_direct, deconv_input_md,
+                      deconv_weight_md,
+                      bias_memory_opt->get_primitive_desc().desc(),
+                      deconv_output_md, strides, padding_l, padding_r,
+                      mkldnn::padding_kind::zero);
+                }
+                auto deconv_pd = mkldnn::deconvolution_forward::primitive_desc(
+                  *deconv_desc_opt, engine);
+
+                auto input_memory = get_memory(
+                  input_memory_cache,
+                  extract_format(deconv_pd.src_primitive_desc()), primitives);
+
+                auto temp_memory_name_prefix = "menoh_mkldnn_temp_memory_" +
+                                               node.op_type + "_" +
+                                               node.output_name_list.front();
+                std::vector<std::pair<std::string, memory_cache>>
+                  named_weight_memory_cache_list;
+                optional<mkldnn::memory> weight_memory_opt;
+                if(is_weight_parameter) {
+                    // plain memory of the parameter needs no reorder
+                    std::vector<mkldnn::primitive> weight_primitives;
+                    auto onnx_weight_memory = get_memory(
+                      weight_memory_cache, onnx_weight_dims,
+                      mkldnn::memory::format::nchw, weight_primitives);
+                    mkldnn::memory transposed_weight_memory(
+                      {{{weight_dims},
+                        weight_memory_cache.data_type(),
+                        group == 1 ? mkldnn::memory::format::oihw
+                                   : mkldnn::memory::format::goihw},
+                       engine});
+                    auto onnx_weight_data = static_cast<float const*>(
+                      onnx_weight_memory.get_data_handle());
+                    auto transposed_weight_data = static_cast<float*>(
+                      transposed_weight_memory.get_data_handle());
+                    int kernel_size =
+                      onnx_weight_dims.at(2) * onnx_weight_dims.at(3);
+                    for(int g = 0; g < group; ++g) {
+                        for(int i = 0; i < group_input_channel_num; ++i) {
+                            for(int o = 0; o < group_output_channel_num; ++o) {
+                                auto first =
+                                  onnx_weight_data +
+                                  ((g * group_input_channel_num + i) *
+                                     group_output_channel_num +
+                                   o) *
+                                    kernel_size;
+                                std::copy(
+                                  first, first + kernel_size,
+                                  transposed_weight_data +
+                                    ((g * group_output_channel_num + o) *
+                                       group_input_channel_num +
+                                     i) *
+                                      kernel_size);
+                            }
+                        }
+                    }
+                    if(mkldnn::memory::primitive_desc(
+                         deconv_pd.weights_primitive_desc()) ==
+                       transposed_weight_memory.get_primitive_desc()) {
+                        weight_memory_opt = transposed_weight_memory;
+                    } else {
+                        weight_memory_opt =
+                          mkldnn::memory(deconv_pd.weights_primitive_desc());
+                        weight_primitives.push_back(mkldnn::reorder(
+                          transposed_weight_memory, *weight_memory_opt));
+                    }
+                    if(!weight_primitives.empty()) {
+                        mkldnn::stream(mkldnn::stream::kind::eager)
+                          .submit(weight_primitives)
+                          .wait();
+                    }
+                } else {
+                    // Swap C_in and C_out by two reorders. The ONNX weight
+                    // seen as nchw data is reordered into chwn, whose buffer
+                    // is the mkldnn weight in nhwc (ohwi) layout
+                    weight_memory_opt =
+                      mkldnn::memory(deconv_pd.weights_primitive_desc());
+                    auto onnx_weight_memory =
+                      get_memory(weight_memory_cache, onnx_weight_dims,
+                                 mkldnn::memory::format::nchw, primitives);
+                    mkldnn::memory transposed_weight_memory(
+                      {{{onnx_weight_dims},
+                        weight_memory_cache.data_type(),
+                        mkldnn::memory::format::chwn},
+                       engine});
+                    primitives.push_back(mkldnn::reorder(
+                      onnx_weight_memory, transposed_weight_memory));
+                    mkldnn::memory transposed_weight_view_memory(
+                      {{{weight_dims},
+                        weight_memory_cache.data_type(),
+                        mkldnn::memory::format::nhwc},
+                       engine},
+                      transposed_weight_memory.get_data_handle());
+                    primitives.push_back(mkldnn::reorder(
+                      transposed_weight_view_memory, *weight_memory_opt));
+                    named_weight_memory_cache_list.emplace_back(
+                      temp_memory_name_prefix + "_transposed_weight_memory",
+                      memory_cache(transposed_weight_memory));
+                    named_weight_memory_cache_list.emplace_back(
+                      temp_memory_name_prefix +
+                        "_transposed_weight_view_memory",
+                      memory_cache(transposed_weight_view_memory));
+                }
+                auto weight_memory = *weight_memory_opt;
+                named_weight_memory_cache_list.emplace_back(
+                  temp_memory_name_prefix + "_weight_memory",
+                  memory_cache(weight_memory));
+
+                auto output_memory_cache = manage_output(
+                  output_formatted_array_list.at(0),
+                  deconv_pd.dst_primitive_desc(), engine, primitives,
+                  [&deconv_pd, &input_memory, &weight_memory,
+                   &bias_memory_opt](mkldnn::memory const& output_memory) {
+                      if(bias_memory_opt) {
+                          return mkldnn::deconvolution_forward(
+                            deconv_pd, input_memory, weight_memory,
+                            *bias_memory_opt, output_memory);
+                      } else {
+                          return mkldnn::deconvolution_forward(
+                            deconv_pd, input_memory, weight_memory,
+                            output_memory);
+                      }
+                  });
+
+                return procedure_factory_return_type{
+                  primitives, {output_memory_cache}, {}, {},
+                  named_weight_memory_cache_list};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_CONV_TRANSPOSE_HPP
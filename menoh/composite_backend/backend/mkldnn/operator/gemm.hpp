@@ -12,41 +12,12 @@ namespace menoh_impl {
     namespace composite_backend {
         namespace mkldnn_backend {
 
-            inline procedure_factory_return_type
-            make_gemm(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+            // y = x W^T + b by inner product. x is flattened to 2-D
+            inline procedure_factory_return_type make_inner_product_impl(
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
 
                 std::vector<mkldnn::primitive> primitives;
 
-                auto alpha = attribute_float(node, "alpha");
-                if(alpha != 1.f) {
-                    throw failed_to_configure_operator(
-                      node.op_type, node.output_name_list.at(0),
-                      "alpha of Gemm must be 1 but given: " +
-                        std::to_string(alpha));
-                }
-                auto beta = attribute_float(node, "beta");
-                if(beta != 1.f) {
-                    throw failed_to_configure_operator(
-                      node.op_type, node.output_name_list.at(0),
-                      "beta of Gemm must be 1 but given: " +
-                        std::to_string(beta));
-                }
-
-                auto trans_a = attribute_int(node, "transA");
-                if(trans_a) {
-                    throw failed_to_configure_operator(
-                      node.op_type, node.output_name_list.at(0),
-                      "transA of Gemm must be 0 but given: " +
-                        std::to_string(trans_a));
-                }
-                auto trans_b = attribute_int(node, "transB");
-                if(!trans_b) {
-                    throw failed_to_configure_operator(
-                      node.op_type, node.output_name_list.at(0),
-                      "transB of Gemm must be 0 but given: " +
-                        std::to_string(trans_b));
-                }
-
                 memory_cache& input_memory_cache =
                   input_memory_cache_list.at(0);
                 auto input_dims = input_memory_cache.dims();
@@ -116,6 +87,50 @@ namespace menoh_impl {
                   primitives, {output_memory_cache}, {}};
             }
 
+            inline procedure_factory_return_type
+            make_gemm(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                auto alpha = attribute_float(node, "alpha");
+                if(alpha != 1.f) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "alpha of Gemm must be 1 but given: " +
+                        std::to_string(alpha));
+                }
+                auto beta = attribute_float(node, "beta");
+                if(beta != 1.f) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "beta of Gemm must be 1 but given: " +
+                        std::to_string(beta));
+                }
+
+                auto trans_a = attribute_int(node, "transA");
+                if(trans_a) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "transA of Gemm must be 0 but given: " +
+                        std::to_string(trans_a));
+                }
+                auto trans_b = attribute_int(node, "transB");
+                if(!trans_b) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "transB of Gemm must be 0 but given: " +
+                        std::to_string(trans_b));
+                }
+
+                return make_inner_product_impl(
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
+            inline procedure_factory_return_type
+            make_fc(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                // FC is Gemm with transB=1 whose input is flattened
+                return make_inner_product_impl(
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
         } // namespace mkldnn_backend
     }     // namespace composite_backend
 } // namespace menoh_impl
@@ -0,0 +1,66 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_LRN_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_LRN_HPP
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            inline procedure_factory_return_type
+            make_lrn(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                auto alpha = attribute_float(node, "alpha");
+                auto beta = attribute_float(node, "beta");
+                auto bias = attribute_float(node, "bias");
+                auto size = attribute_int(node, "size");
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                auto input_dims = input_memory_cache.dims();
+                if(input_dims.size() != 4) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "only 4-D input is supported but given: " +
+                        std::to_string(input_dims.size()) + "-D");
+                }
+                auto input_memory = input_memory_cache.get_data_memory();
+
+                // mkldnn divides alpha by size as ONNX does
+                mkldnn::lrn_forward::desc lrn_desc(
+                  mkldnn::prop_kind::forward_scoring,
+                  mkldnn::algorithm::lrn_across_channels,
+                  input_memory.get_primitive_desc().desc(), size, alpha, beta,
+                  bias);
+                auto lrn_pd =
+                  mkldnn::lrn_forward::primitive_desc(lrn_desc, engine);
+
+                auto lrn_input_memory = get_memory(
+                  input_memory_cache,
+                  extract_format(lrn_pd.src_primitive_desc()), primitives);
+
+                auto output_memory_cache = manage_output(
+                  output_formatted_array_list.at(0),
+                  lrn_pd.dst_primitive_desc(), engine, primitives,
+                  [&lrn_pd,
+                   &lrn_input_memory](mkldnn::memory const& output_memory) {
+                      return mkldnn::lrn_forward(lrn_pd, lrn_input_memory,
+                                                 output_memory);
+                  });
+
+                return procedure_factory_return_type{
+                  primitives, {output_memory_cache}, {}};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_LRN_HPP
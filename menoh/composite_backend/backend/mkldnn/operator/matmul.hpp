@@ -0,0 +1,102 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_MATMUL_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_MATMUL_HPP
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // 2-D MatMul is computed as inner product without bias.
+            // Batched (N-D) MatMul is left to other contexts
+            inline procedure_factory_return_type
+            make_matmul(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                memory_cache& a_memory_cache = input_memory_cache_list.at(0);
+                auto a_dims = a_memory_cache.dims();
+                memory_cache& b_memory_cache = input_memory_cache_list.at(1);
+                auto b_dims = b_memory_cache.dims();
+                if(a_dims.size() != 2 || b_dims.size() != 2) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "only 2-D MatMul is supported but given: " +
+                        std::to_string(a_dims.size()) + "-D and " +
+                        std::to_string(b_dims.size()) + "-D");
+                }
+                int k = b_dims.at(0);
+                int n = b_dims.at(1);
+                assert(a_dims.at(1) == k && "invalid shape inference");
+
+                auto output_dims =
+                  output_formatted_array_list.at(0).array().dims();
+                assert(output_dims.at(0) == a_dims.at(0) &&
+                       "invalid shape inference");
+                assert(output_dims.at(1) == n && "invalid shape inference");
+
+                auto matmul_input_md = mkldnn::memory::desc(
+                  {a_dims}, a_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+                auto matmul_weight_md = mkldnn::memory::desc(
+                  {n, k}, b_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+                auto matmul_output_md = mkldnn::memory::desc(
+                  {output_dims}, a_memory_cache.data_type(),
+                  mkldnn::memory::format::any);
+
+                mkldnn::inner_product_forward::desc matmul_desc(
+                  mkldnn::prop_kind::forward_inference, matmul_input_md,
+                  matmul_weight_md, matmul_output_md);
+                auto matmul_pd =
+                  mkldnn::inner_product_forward::primitive_desc(matmul_desc,
+                                                                engine);
+
+                auto input_memory =
+                  get_memory(a_memory_cache,
+                             extract_format(matmul_pd.src_primitive_desc()),
+                             primitives);
+
+                // B (K x N, row major) is the same memory as inner product
+                // weight (N x K) in io format
+                auto b_memory =
+                  get_memory(b_memory_cache, mkldnn::memory::format::nc,
+                             primitives);
+                memory_cache weight_memory_cache(mkldnn::memory(
+                  {{{n, k}, b_memory_cache.data_type(),
+                    mkldnn::memory::format::io},
+                   engine},
+                  b_memory.get_data_handle()));
+                auto weight_memory = get_memory(
+                  weight_memory_cache, {n, k},
+                  extract_format(matmul_pd.weights_primitive_desc()),
+                  primitives);
+
+                auto output_memory_cache = manage_output(
+                  output_formatted_array_list.at(0),
+                  matmul_pd.dst_primitive_desc(), engine, primitives,
+                  [&matmul_pd, &input_memory,
+                   &weight_memory](mkldnn::memory const& output_memory) {
+                      return mkldnn::inner_product_forward(
+                        matmul_pd, input_memory, weight_memory,
+                        output_memory);
+                  });
+
+                return procedure_factory_return_type{
+                  primitives,
+                  {output_memory_cache},
+                  {{"menoh_mkldnn_temp_memory_" + node.op_type + "_" +
+                      node.output_name_list.front() + "_weight_memory",
+                    weight_memory_cache}}};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_MATMUL_HPP
@@ -13,7 +13,9 @@ namespace menoh_impl {
         namespace mkldnn_backend {
 
             inline procedure_factory_return_type make_pool_impl(
-              mkldnn::algorithm pooling_alg,
+              mkldnn::algorithm pooling_alg, std::vector<int> const& strides,
+              std::vector<int> const& kernel_shape,
+              std::vector<int> const& pads,
               MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
 
                 assert(pooling_alg == mkldnn::pooling_max ||
@@ -24,9 +26,6 @@ namespace menoh_impl {
                 std::vector<std::pair<std::string, memory_cache>>
                   output_memory_cache_list;
 
-                std::vector<int> strides, kernel_shape, pads;
-                std::tie(strides, kernel_shape, pads) =
-                  attributes_for_2d_data_processing(node);
                 std::vector<int> padding_l{pads[0], pads[1]};
                 std::vector<int> padding_r{pads[2], pads[3]};
 
@@ -64,6 +63,38 @@ namespace menoh_impl {
                   primitives, {output_memory_cache}, {}};
             }
 
+            inline procedure_factory_return_type make_pool_impl(
+              mkldnn::algorithm pooling_alg,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                std::vector<int> strides, kernel_shape, pads;
+                std::tie(strides, kernel_shape, pads) =
+                  attributes_for_2d_data_processing(node);
+                return make_pool_impl(
+                  pooling_alg, strides, kernel_shape, pads,
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
+            // global pooling is pooling whose kernel covers whole spatial
+            // axes
+            inline procedure_factory_return_type make_global_pool_impl(
+              mkldnn::algorithm pooling_alg,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                auto input_dims = input_memory_cache_list.at(0).get().dims();
+                if(input_dims.size() != 4) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "only 4-D input is supported but given: " +
+                        std::to_string(input_dims.size()) + "-D");
+                }
+                std::vector<int> strides{1, 1};
+                std::vector<int> kernel_shape{input_dims.at(2),
+                                              input_dims.at(3)};
+                std::vector<int> pads{0, 0, 0, 0};
+                return make_pool_impl(
+                  pooling_alg, strides, kernel_shape, pads,
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
             inline procedure_factory_return_type make_average_pool(
               MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
                 auto pooling_alg =
@@ -86,6 +117,20 @@ namespace menoh_impl {
                   MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
             }
 
+            inline procedure_factory_return_type make_global_average_pool(
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                return make_global_pool_impl(
+                  mkldnn::algorithm::pooling_avg_include_padding,
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
+            inline procedure_factory_return_type make_global_max_pool(
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                return make_global_pool_impl(
+                  mkldnn::algorithm::pooling_max,
+                  MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+            }
+
         } // namespace mkldnn_backend
     }     // namespace composite_backend
 } // namespace menoh_impl
@@ -0,0 +1,330 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_QUANTIZED_CONV_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_QUANTIZED_CONV_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <menoh/calibration_table.hpp>
+#include <menoh/exception.hpp>
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/conv.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+#include <menoh/composite_backend/logger.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // configurations which int8 convolution does not cover. Conv
+            // is computed in f32 then
+            class unsupported_int8_conv : public failed_to_configure_operator {
+            public:
+                unsupported_int8_conv(node const& node,
+                                      std::string const& message)
+                  : failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0), message) {}
+            };
+
+            // u8s8 convolution. input is quantized with the calibrated range
+            // and weight with its per output channel absolute max. The
+            // primitive dequantizes the result, so output stays f32
+            inline procedure_factory_return_type make_quantized_conv_impl(
+              variable_range const& input_range,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                std::vector<int> strides, kernel_shape, pads;
+                std::tie(strides, kernel_shape, pads) =
+                  attributes_for_2d_data_processing(node);
+                std::vector<int> padding_l{pads[0], pads[1]};
+                std::vector<int> padding_r{pads[2], pads[3]};
+
+                auto dilations = attribute_ints(node, "dilations");
+                if(!std::all_of(dilations.begin(), dilations.end(),
+                                [](auto e) { return e == 1; })) {
+                    throw unsupported_int8_conv(
+                      node, "dilated int8 convolution is not supported");
+                }
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                auto input_dims = input_memory_cache.dims();
+
+                memory_cache& weight_memory_cache =
+                  input_memory_cache_list.at(1);
+                auto weight_dims = weight_memory_cache.dims();
+                if(weight_memory_cache.data_type() !=
+                     mkldnn::memory::data_type::f32 ||
+                   weight_dims.size() != 4) {
+                    throw unsupported_int8_conv(
+                      node, "int8 convolution needs 4-D f32 weight");
+                }
+
+                auto group = attribute_int(node, "group");
+                auto conv_weight_dims = weight_dims;
+                if(group != 1) {
+                    conv_weight_dims = std::vector<int>{
+                      group, weight_dims.at(0) / group, weight_dims.at(1),
+                      weight_dims.at(2), weight_dims.at(3)};
+                }
+
+                // weight is a parameter so its plain memory is available
+                // at build time
+                auto weight_memory =
+                  get_memory(weight_memory_cache, weight_dims,
+                             mkldnn::memory::format::oihw, primitives);
+                if(!primitives.empty()) {
+                    throw unsupported_int8_conv(
+                      node, "weight of int8 convolution must be a parameter");
+                }
+                int output_channel_num = weight_dims.at(0);
+                int weight_channel_size =
+                  weight_dims.at(1) * weight_dims.at(2) * weight_dims.at(3);
+                auto weight_data =
+                  static_cast<float const*>(weight_memory.get_data_handle());
+
+                std::vector<float> weight_scale_list(output_channel_num);
+                array quantized_weight(dtype_t::int8, weight_dims);
+                auto quantized_weight_data =
+                  static_cast<std::int8_t*>(quantized_weight.data());
+                for(int oc = 0; oc < output_channel_num; ++oc) {
+                    auto first = weight_data + oc * weight_channel_size;
+                    float abs_max = 0.f;
+                    for(int i = 0; i < weight_channel_size; ++i) {
+                        abs_max = std::max(abs_max, std::abs(first[i]));
+                    }
+                    auto scale = abs_max == 0.f ? 1.f : 127.f / abs_max;
+                    weight_scale_list.at(oc) = scale;
+                    for(int i = 0; i < weight_channel_size; ++i) {
+                        quantized_weight_data[oc * weight_channel_size + i] =
+                          static_cast<std::int8_t>(std::max(
+                            -127.f,
+                            std::min(127.f, std::round(first[i] * scale))));
+                    }
+                }
+
+                // u8 covers [0, max] of the input
+                auto input_scale = 255.f / input_range.max;
+
+                // s32 accumulator is scaled by input_scale * weight_scale
+                std::vector<float> output_scale_list(output_channel_num);
+                for(int oc = 0; oc < output_channel_num; ++oc) {
+                    output_scale_list.at(oc) =
+                      1.f / (input_scale * weight_scale_list.at(oc));
+                }
+
+                optional<memory_cache> quantized_bias_memory_cache_opt;
+                if(node.input_name_list.size() == 3) {
+                    memory_cache& bias_memory_cache =
+                      input_memory_cache_list.at(2);
+                    auto bias_memory = get_memory(
+                      bias_memory_cache, mkldnn::memory::format::x, primitives);
+                    if(!primitives.empty()) {
+                        throw unsupported_int8_conv(
+                          node, "bias of int8 convolution must be a parameter");
+                    }
+                    auto bias_data =
+                      static_cast<float const*>(bias_memory.get_data_handle());
+                    array quantized_bias(dtype_t::int32, {output_channel_num});
+                    auto quantized_bias_data =
+                      static_cast<std::int32_t*>(quantized_bias.data());
+                    for(int oc = 0; oc < output_channel_num; ++oc) {
+                        quantized_bias_data[oc] =
+                          static_cast<std::int32_t>(std::round(
+                            bias_data[oc] * input_scale *
+                            weight_scale_list.at(oc)));
+                    }
+                    quantized_bias_memory_cache_opt =
+                      memory_cache(quantized_bias, engine);
+                }
+
+                auto output_dims =
+                  output_formatted_array_list.at(0).array().dims();
+                assert(output_dims.at(0) == input_dims.at(0) &&
+                       "invalid shape inference");
+                auto conv_input_md = mkldnn::memory::desc(
+                  {input_dims}, mkldnn::memory::data_type::u8,
+                  mkldnn::memory::format::any);
+                auto conv_weight_md = mkldnn::memory::desc(
+                  {conv_weight_dims}, mkldnn::memory::data_type::s8,
+                  mkldnn::memory::format::any);
+                auto conv_output_md = mkldnn::memory::desc(
+                  {output_dims}, mkldnn::memory::data_type::f32,
+                  mkldnn::memory::format::any);
+
+                optional<mkldnn::memory> bias_memory_opt;
+                menoh_impl::optional<mkldnn::convolution_forward::desc>
+                  conv_desc_opt;
+                if(quantized_bias_memory_cache_opt) {
+                    bias_memory_opt =
+                      get_memory(*quantized_bias_memory_cache_opt,
+                                 mkldnn::memory::format::x, primitives);
+                    conv_desc_opt = mkldnn::convolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference,
+                      mkldnn::algorithm::convolution_direct, conv_input_md,
+                      conv_weight_md,
+                      bias_memory_opt->get_primitive_desc().desc(),
+                      conv_output_md, strides, padding_l, padding_r,
+                      mkldnn::padding_kind::zero);
+                } else {
+                    conv_desc_opt = mkldnn::convolution_forward::desc(
+                      mkldnn::prop_kind::forward_inference,
+                      mkldnn::algorithm::convolution_direct, conv_input_md,
+                      conv_weight_md, conv_output_md, strides, padding_l,
+                      padding_r, mkldnn::padding_kind::zero);
+                }
+
+                // per output channel (axis 1 of output) scales
+                mkldnn::primitive_attr conv_attr;
+                conv_attr.set_int_output_round_mode(
+                  mkldnn::round_mode::round_nearest);
+                conv_attr.set_output_scales(1 << 1, output_scale_list);
+                auto conv_pd = mkldnn::convolution_forward::primitive_desc(
+                  *conv_desc_opt, conv_attr, engine);
+
+                std::vector<std::pair<std::string, memory_cache>>
+                  named_temp_memory_cache_list;
+                std::vector<std::pair<std::string, memory_cache>>
+                  named_weight_memory_cache_list;
+                auto temp_memory_name_prefix = "menoh_mkldnn_temp_memory_" +
+                                               node.op_type + "_" +
+                                               node.output_name_list.front();
+
+                // f32 input is quantized by reorder at every run
+                auto input_data_memory = input_memory_cache.get_data_memory();
+                mkldnn::memory input_memory(conv_pd.src_primitive_desc());
+                mkldnn::primitive_attr input_attr;
+                input_attr.set_int_output_round_mode(
+                  mkldnn::round_mode::round_nearest);
+                input_attr.set_output_scales(0, {input_scale});
+                primitives.push_back(mkldnn::reorder(
+                  mkldnn::reorder::primitive_desc(
+                    input_data_memory.get_primitive_desc(),
+                    input_memory.get_primitive_desc(), input_attr),
+                  input_data_memory, input_memory));
+                named_temp_memory_cache_list.emplace_back(
+                  temp_memory_name_prefix + "_quantized_input_memory",
+                  memory_cache(input_memory));
+
+                memory_cache quantized_weight_memory_cache(quantized_weight,
+                                                           engine);
+                optional<mkldnn::memory> conv_weight_memory_opt;
+                if(group == 1) {
+                    conv_weight_memory_opt = get_memory(
+                      quantized_weight_memory_cache, weight_dims,
+                      extract_format(conv_pd.weights_primitive_desc()),
+                      primitives);
+                } else {
+                    // view plain oihw weight as goihw and reorder it
+                    auto oihw_weight_memory = get_memory(
+                      quantized_weight_memory_cache, weight_dims,
+                      mkldnn::memory::format::oihw, primitives);
+                    memory_cache grouped_weight_memory_cache(mkldnn::memory(
+                      {{{conv_weight_dims},
+                        mkldnn::memory::data_type::s8,
+                        mkldnn::memory::format::goihw},
+                       engine},
+                      oihw_weight_memory.get_data_handle()));
+                    conv_weight_memory_opt = get_memory(
+                      grouped_weight_memory_cache, conv_weight_dims,
+                      extract_format(conv_pd.weights_primitive_desc()),
+                      primitives);
+                    named_weight_memory_cache_list.emplace_back(
+                      temp_memory_name_prefix + "_grouped_weight_memory",
+                      grouped_weight_memory_cache);
+                }
+                auto conv_weight_memory = *conv_weight_memory_opt;
+                named_weight_memory_cache_list.emplace_back(
+                  temp_memory_name_prefix + "_quantized_weight_memory",
+                  quantized_weight_memory_cache);
+                if(quantized_bias_memory_cache_opt) {
+                    named_weight_memory_cache_list.emplace_back(
+                      temp_memory_name_prefix + "_quantized_bias_memory",
+                      *quantized_bias_memory_cache_opt);
+                }
+
+                auto output_memory_cache = manage_output(
+                  output_formatted_array_list.at(0),
+                  conv_pd.dst_primitive_desc(), engine, primitives,
+                  [&conv_pd, &input_memory, &conv_weight_memory,
+                   &bias_memory_opt](mkldnn::memory const& output_memory) {
+                      if(bias_memory_opt) {
+                          return mkldnn::convolution_forward(
+                            conv_pd, input_memory, conv_weight_memory,
+                            *bias_memory_opt, output_memory);
+                      } else {
+                          return mkldnn::convolution_forward(
+                            conv_pd, input_memory, conv_weight_memory,
+                            output_memory);
+                      }
+                  });
+
+                return procedure_factory_return_type{
+                  primitives, {output_memory_cache},
+                  named_temp_memory_cache_list, {},
+                  named_weight_memory_cache_list};
+            }
+
+            // Conv is computed in int8 when the calibration table has a non
+            // negative range of its input. Otherwise, or when mkldnn has no
+            // int8 kernel for this configuration, f32 `make_f32_conv` is used
+            // and the reason is written to `logger`. Invalid ranges in the
+            // table are errors
+            inline procedure_factory_return_type make_quantized_conv(
+              calibration_table const& table,
+              procedure_factory const& make_f32_conv, logger_handle logger,
+              MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+                auto const& input_name = node.input_name_list.at(0);
+                auto fall_back = [&](std::string const& reason) {
+                    if(logger) {
+                        *logger << node.output_name_list.at(0)
+                                << " is computed in f32: " << reason
+                                << std::endl;
+                    }
+                    return make_f32_conv(
+                      MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                };
+                auto found = table.find(input_name);
+                if(found == table.end()) {
+                    return fall_back("no range of " + input_name +
+                                     " in calibration table");
+                }
+                auto const& range = found->second;
+                if(!std::isfinite(range.min) || !std::isfinite(range.max) ||
+                   range.max < range.min) {
+                    throw invalid_backend_config_error(
+                      "invalid range of " + input_name +
+                      " in int8 calibration table: [" +
+                      std::to_string(range.min) + ", " +
+                      std::to_string(range.max) + "]");
+                }
+                if(range.min < 0.f || range.max == 0.f) {
+                    return fall_back("range of " + input_name +
+                                     " is not positive");
+                }
+                try {
+                    return make_quantized_conv_impl(
+                      range,
+                      MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_ARGUMENT_LIST);
+                } catch(unsupported_int8_conv const& e) {
+                    return fall_back(e.what());
+                } catch(mkldnn::error const& e) {
+                    if(e.status != mkldnn_unimplemented) {
+                        throw;
+                    }
+                    return fall_back("no int8 kernel in mkldnn: " + e.message);
+                }
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_QUANTIZED_CONV_HPP
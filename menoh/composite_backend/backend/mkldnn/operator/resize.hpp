@@ -0,0 +1,96 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_RESIZE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_RESIZE_HPP
+
+#include <menoh/composite_backend/backend/generic/operator/resize.hpp>
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // mkldnn has no resize primitive. The generic kernel runs on the
+            // input layout (nchw, nChw8c or nChw16c) as is so no reorder is
+            // needed around it unless the output is required in nchw
+            inline procedure_factory_return_type
+            make_resize(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                if(input_memory_cache.data_type() !=
+                   mkldnn::memory::data_type::f32) {
+                    throw failed_to_configure_operator(
+                      node.op_type, node.output_name_list.at(0),
+                      "only float input is supported");
+                }
+                auto input_dims = input_memory_cache.dims();
+                auto const& output_formatted_array =
+                  output_formatted_array_list.at(0);
+                auto output_dims = output_formatted_array.array().dims();
+                auto conf = generic_backend::make_resize_configuration(
+                  node, input_dims, output_dims);
+
+                auto input_memory = input_memory_cache.get_data_memory();
+                auto format = extract_format(input_memory);
+                if(!is_format_any(output_formatted_array) &&
+                   output_formatted_array.format() != format) {
+                    format = output_formatted_array.format();
+                    input_memory =
+                      get_memory(input_memory_cache, format, primitives);
+                }
+                int block = 0;
+                if(format == mkldnn::memory::format::nchw) {
+                    block = 1;
+                } else if(format == mkldnn::memory::format::nChw8c) {
+                    block = 8;
+                } else if(format == mkldnn::memory::format::nChw16c) {
+                    block = 16;
+                } else {
+                    input_memory = get_memory(input_memory_cache,
+                                              mkldnn::memory::format::nchw,
+                                              primitives);
+                    format = mkldnn::memory::format::nchw;
+                    block = 1;
+                }
+
+                // allocates (channel padded) memory when output is not
+                // required
+                auto output_memory =
+                  is_format_any(output_formatted_array)
+                    ? mkldnn::memory(
+                        {{{output_dims}, mkldnn::memory::data_type::f32,
+                          format},
+                         engine})
+                    : make_memory(output_formatted_array, engine);
+
+                int plane_num =
+                  input_dims.at(0) * ((input_dims.at(1) + block - 1) / block);
+                auto procedure = [conf, input_memory, output_memory,
+                                  plane_num, block, input_dims]() {
+                    generic_backend::resize_2d(
+                      conf.mode,
+                      static_cast<float const*>(
+                        input_memory.get_data_handle()),
+                      static_cast<float*>(output_memory.get_data_handle()),
+                      plane_num, block, input_dims.at(2), input_dims.at(3),
+                      conf.height_table, conf.width_table);
+                };
+
+                return procedure_factory_return_type{
+                  primitives,
+                  {memory_cache(output_memory)},
+                  {},
+                  {procedure}};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_RESIZE_HPP
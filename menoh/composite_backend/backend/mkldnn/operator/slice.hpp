@@ -0,0 +1,154 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_SLICE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_SLICE_HPP
+
+#include <menoh/composite_backend/backend/generic/operator/slice.hpp>
+
+#include <menoh/composite_backend/backend/mkldnn/formatted_array.hpp>
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+#include <menoh/composite_backend/backend/mkldnn/operator/output_management.hpp>
+#include <menoh/composite_backend/backend/mkldnn/procedure_factory.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // channel block size of nChw8c and nChw16c. 1 for plain formats
+            inline optional<int>
+            data_format_block_size(mkldnn::memory::format format) {
+                if(format == mkldnn::memory::format::x ||
+                   format == mkldnn::memory::format::nc ||
+                   format == mkldnn::memory::format::nchw) {
+                    return 1;
+                }
+                if(format == mkldnn::memory::format::nChw8c) {
+                    return 8;
+                }
+                if(format == mkldnn::memory::format::nChw16c) {
+                    return 16;
+                }
+                return nullopt;
+            }
+
+            // offset (in elements) of the region in the memory of the format
+            // when the region is one contiguous block of it. In nChw8c and
+            // nChw16c it is a range of batch or, with batch size 1, a range
+            // of channel blocks
+            inline optional<std::size_t>
+            sub_memory_offset(mkldnn::memory::format format,
+                              std::vector<int> const& dims,
+                              generic_backend::slice_region const& region) {
+                auto block = data_format_block_size(format);
+                if(!block) {
+                    return nullopt;
+                }
+                if(*block == 1) {
+                    return generic_backend::contiguous_region_offset(dims,
+                                                                     region);
+                }
+                if(region.dims.at(2) != dims.at(2) ||
+                   region.dims.at(3) != dims.at(3)) {
+                    return nullopt;
+                }
+                std::size_t spatial_size =
+                  static_cast<std::size_t>(dims.at(2)) * dims.at(3);
+                int padded_c = (dims.at(1) + *block - 1) / *block * *block;
+                std::size_t batch_offset =
+                  region.starts.at(0) * padded_c * spatial_size;
+                if(region.dims.at(1) == dims.at(1)) {
+                    return batch_offset;
+                }
+                auto c_start = region.starts.at(1);
+                auto c_end = c_start + region.dims.at(1);
+                if(region.dims.at(0) == 1 && c_start % *block == 0 &&
+                   (c_end % *block == 0 || c_end == dims.at(1))) {
+                    return batch_offset + c_start * spatial_size;
+                }
+                return nullopt;
+            }
+
+            // Outputs contiguous in the input memory are sub-memories of it
+            // and need no primitive. Others are copied from views of the
+            // input by reorder
+            inline procedure_factory_return_type
+            make_slice(MENOH_MKLDNN_CONTEXT_PROCEDURE_FACTORY_PARAMETER_LIST) {
+
+                std::vector<mkldnn::primitive> primitives;
+
+                memory_cache& input_memory_cache =
+                  input_memory_cache_list.at(0);
+                auto input_dims = input_memory_cache.dims();
+                auto input_memory = input_memory_cache.get_data_memory();
+                auto format = extract_format(input_memory);
+                auto block = data_format_block_size(format);
+                if(!block) {
+                    format = ndims_to_data_memory_format(input_dims.size());
+                    input_memory =
+                      get_memory(input_memory_cache, format, primitives);
+                    block = 1;
+                }
+                auto data_type = extract_data_type(input_memory);
+                auto element_size = get_size_in_bytes(
+                  mkldnn_memory_data_type_to_dtype(data_type));
+
+                auto region_list =
+                  generic_backend::make_slice_region_list(node, input_dims);
+                assert(region_list.size() ==
+                       output_formatted_array_list.size());
+
+                std::vector<memory_cache> output_memory_cache_list;
+                for(unsigned int i = 0; i < region_list.size(); ++i) {
+                    auto const& region = region_list.at(i);
+                    auto const& output_formatted_array =
+                      output_formatted_array_list.at(i);
+
+                    if(is_format_any(output_formatted_array)) {
+                        auto offset =
+                          sub_memory_offset(format, input_dims, region);
+                        if(offset) {
+                            output_memory_cache_list.emplace_back(
+                              mkldnn::memory(
+                                {{{region.dims}, data_type, format}, engine},
+                                static_cast<char*>(
+                                  input_memory.get_data_handle()) +
+                                  *offset * element_size));
+                            continue;
+                        }
+                    }
+
+                    // blocked output is used only when no channel padding
+                    // is added
+                    auto output_format =
+                      !is_format_any(output_formatted_array)
+                        ? output_formatted_array.format()
+                        : *block == 1 || region.dims.at(1) % *block == 0
+                            ? format
+                            : ndims_to_data_memory_format(input_dims.size());
+                    mkldnn::view::primitive_desc view_pd(
+                      input_memory.get_primitive_desc(), region.dims,
+                      region.starts);
+                    auto output_memory_cache = manage_output(
+                      output_formatted_array,
+                      {{{region.dims}, data_type, output_format}, engine},
+                      engine, primitives,
+                      [&view_pd,
+                       &input_memory](mkldnn::memory const& output_memory) {
+                          return mkldnn::reorder(
+                            mkldnn::reorder::primitive_desc(
+                              view_pd.dst_primitive_desc(),
+                              output_memory.get_primitive_desc()),
+                            input_memory, output_memory);
+                      });
+                    output_memory_cache_list.push_back(output_memory_cache);
+                }
+
+                return procedure_factory_return_type{
+                  primitives, output_memory_cache_list, {}};
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_OPERATOR_SLICE_HPP
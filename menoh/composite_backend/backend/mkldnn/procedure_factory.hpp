@@ -5,6 +5,8 @@
 #include <utility>
 #include <vector>
 
+#include <menoh/composite_backend/procedure.hpp>
+
 #include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
 #include <mkldnn.hpp>
 
@@ -27,6 +29,13 @@ namespace menoh_impl {
                 std::vector<memory_cache> output_memory_cache_list;
                 std::vector<std::pair<std::string, memory_cache>>
                   named_temp_memory_cache_list;
+                // non mkldnn kernels which run after primitives
+                std::vector<procedure> procedures;
+                // temp memories made from weight inputs (e.g. reordered,
+                // transposed or quantized weights). They are packed weights
+                // when the weight is a parameter
+                std::vector<std::pair<std::string, memory_cache>>
+                  named_weight_memory_cache_list;
             };
 
             using procedure_factory =
@@ -0,0 +1,36 @@
+#include <menoh/composite_backend/backend/mkldnn/shared_weight_cache.hpp>
+
+#include <cassert>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            memory_cache& shared_weight_cache::get_parameter_memory_cache(
+              std::string const& name, array const& arr) {
+                auto found = parameter_memory_cache_table_.find(name);
+                if(found != parameter_memory_cache_table_.end()) {
+                    // models may have their own copies of the parameter,
+                    // e.g. expanded from float16
+                    assert(found->second.dims() == arr.dims() &&
+                           "parameters of the same name differ");
+                    return found->second;
+                }
+                return parameter_memory_cache_table_
+                  .emplace(name, memory_cache(arr, engine_, true))
+                  .first->second;
+            }
+
+            memory_cache const*
+            shared_weight_cache::find_parameter_memory_cache(
+              std::string const& name) const {
+                auto found = parameter_memory_cache_table_.find(name);
+                if(found == parameter_memory_cache_table_.end()) {
+                    return nullptr;
+                }
+                return &found->second;
+            }
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
@@ -0,0 +1,49 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_SHARED_WEIGHT_CACHE_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_SHARED_WEIGHT_CACHE_HPP
+
+#include <string>
+#include <unordered_map>
+
+#include <menoh/array.hpp>
+
+#include <menoh/composite_backend/backend/mkldnn/memory_cache.hpp>
+
+#include <mkldnn.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+        namespace mkldnn_backend {
+
+            // Parameters and their packed weights (memories in formats
+            // chosen by primitives) shared by mkldnn contexts of models
+            // built from the same parameters, e.g. streams of a model.
+            // Weights are reordered once when the first model using the
+            // format is built and are only read at run time, so the models
+            // can run concurrently. Models are built one by one
+            class shared_weight_cache {
+            public:
+                // primitives of all contexts sharing the cache are made on
+                // this engine
+                mkldnn::engine const& engine() const { return engine_; }
+
+                // the cache of the parameter. It is made from `arr` when the
+                // parameter is got first
+                memory_cache&
+                get_parameter_memory_cache(std::string const& name,
+                                           array const& arr);
+
+                // nullptr when the parameter is not got yet
+                memory_cache const*
+                find_parameter_memory_cache(std::string const& name) const;
+
+            private:
+                mkldnn::engine engine_{mkldnn::engine::kind::cpu, 0};
+                std::unordered_map<std::string, memory_cache>
+                  parameter_memory_cache_table_;
+            };
+
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_BACKEND_MKLDNN_SHARED_WEIGHT_CACHE_HPP
@@ -2,9 +2,11 @@
 #define MENOH_MKLDNN_WITH_FALLBACK_CONTEXT_HPP
 
 #include <iosfwd>
+#include <string>
 
 #include <menoh/any.hpp>
 #include <menoh/array.hpp>
+#include <menoh/memory_stats.hpp>
 #include <menoh/node.hpp>
 #include <menoh/optional.hpp>
 
@@ -23,9 +25,12 @@ namespace menoh_impl {
                 return do_try_to_get_variable(name);
             }
 
+            // process nodes in [current_index, end_index) from the head as
+            // many as possible. Returns procedures and the index of the first
+            // unprocessed node
             optional<std::tuple<std::vector<procedure>, int>> process_node_list(
               std::string const& context_name, int current_index,
-              std::vector<node> const& node_list,
+              int end_index, std::vector<node> const& node_list,
               std::unordered_map<std::string, array> const&
                 common_parameter_table,
               std::unordered_map<std::string, array> const& common_input_table,
@@ -38,7 +43,7 @@ namespace menoh_impl {
                 context_list,
               logger_handle logger) {
                 return do_process_node_list(
-                  context_name, current_index, node_list,
+                  context_name, current_index, end_index, node_list,
                   common_parameter_table, common_input_table,
                   required_output_table, output_profile_table, context_list,
                   logger);
@@ -49,6 +54,19 @@ namespace menoh_impl {
                 return do_take_variable_handle(name);
             }
 
+            // memory format of the variable as the last processed node
+            // read or wrote it, e.g. "nChw8c". Empty for plain arrays and
+            // variables the context does not have
+            std::string
+            get_variable_format_name(std::string const& name) const {
+                return do_get_variable_format_name(name);
+            }
+
+            // adds memory held by the context
+            void collect_memory_stats(memory_stats& stats) const {
+                do_collect_memory_stats(stats);
+            }
+
         private:
             virtual optional<std::tuple<procedure, array>>
             do_try_to_get_variable(std::string const& name) = 0;
@@ -56,7 +74,7 @@ namespace menoh_impl {
             virtual optional<std::tuple<std::vector<procedure>, int>>
             do_process_node_list(
               std::string const& context_name, int current_index,
-              std::vector<node> const& node_list,
+              int end_index, std::vector<node> const& node_list,
               std::unordered_map<std::string, array> const&
                 common_parameter_table,
               std::unordered_map<std::string, array> const& common_input_table,
@@ -71,6 +89,14 @@ namespace menoh_impl {
 
             // for specialized optimization across backends
             virtual any do_take_variable_handle(std::string const& name) = 0;
+
+            virtual void
+            do_collect_memory_stats(memory_stats& /*stats*/) const {}
+
+            virtual std::string
+            do_get_variable_format_name(std::string const& /*name*/) const {
+                return "";
+            }
         };
         inline context::~context(){}
 
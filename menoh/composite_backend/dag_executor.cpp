@@ -0,0 +1,192 @@
+#include <menoh/composite_backend/dag_executor.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace menoh_impl {
+    namespace composite_backend {
+
+        dag_executor::dag_executor(
+          std::vector<procedure> procedure_list,
+          std::vector<std::vector<int>> successor_list_list, int worker_num)
+          : procedure_list_(std::move(procedure_list)),
+            successor_list_list_(std::move(successor_list_list)),
+            predecessor_num_list_(procedure_list_.size(), 0),
+            waiting_num_list_(
+              std::make_unique<std::atomic<int>[]>(procedure_list_.size())) {
+            assert(procedure_list_.size() == successor_list_list_.size());
+            assert(0 < worker_num);
+            for(int i = 0; i < static_cast<int>(successor_list_list_.size());
+                ++i) {
+                for(auto successor : successor_list_list_.at(i)) {
+                    assert(i < successor);
+                    ++predecessor_num_list_.at(successor);
+                }
+            }
+
+            // threads of each worker for kernels parallelized by OpenMP
+            int intra_op_thread_num = 1;
+#ifdef _OPENMP
+            intra_op_thread_num =
+              std::max(1, omp_get_max_threads() / worker_num);
+#endif
+            for(int i = 0; i < worker_num; ++i) {
+                worker_queue_list_.push_back(std::make_unique<worker_queue>());
+            }
+            for(int i = 0; i < worker_num; ++i) {
+                worker_list_.emplace_back([this, i, intra_op_thread_num]() {
+#ifdef _OPENMP
+                    omp_set_num_threads(intra_op_thread_num);
+#else
+                    static_cast<void>(intra_op_thread_num);
+#endif
+                    work(i);
+                });
+            }
+        }
+
+        dag_executor::~dag_executor() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                is_stopped_ = true;
+            }
+            work_cv_.notify_all();
+            for(auto& worker : worker_list_) {
+                worker.join();
+            }
+        }
+
+        void dag_executor::run(run_control const* control) {
+            if(procedure_list_.empty()) {
+                return;
+            }
+            exception_ = nullptr;
+            control_ = control;
+            for(unsigned int i = 0; i < procedure_list_.size(); ++i) {
+                waiting_num_list_[i] = predecessor_num_list_.at(i);
+            }
+            remaining_num_ = static_cast<int>(procedure_list_.size());
+
+            // procedures without predecessors are distributed over workers
+            int worker_index = 0;
+            for(unsigned int i = 0; i < procedure_list_.size(); ++i) {
+                if(predecessor_num_list_.at(i) == 0) {
+                    push(worker_index, i);
+                    worker_index =
+                      (worker_index + 1) % worker_queue_list_.size();
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [this]() { return remaining_num_ == 0; });
+            if(exception_) {
+                std::rethrow_exception(exception_);
+            }
+        }
+
+        void dag_executor::push(int worker_index, int procedure_index) {
+            {
+                auto& wq = *worker_queue_list_.at(worker_index);
+                std::lock_guard<std::mutex> lock(wq.mutex);
+                wq.queue.push_back(procedure_index);
+            }
+            ++ready_num_;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            work_cv_.notify_one();
+        }
+
+        bool dag_executor::try_to_pop(int worker_index, int& procedure_index) {
+            int worker_num = static_cast<int>(worker_queue_list_.size());
+            for(int i = 0; i < worker_num; ++i) {
+                auto& wq =
+                  *worker_queue_list_.at((worker_index + i) % worker_num);
+                std::lock_guard<std::mutex> lock(wq.mutex);
+                if(wq.queue.empty()) {
+                    continue;
+                }
+                // own queue from the back and others' from the front
+                if(i == 0) {
+                    procedure_index = wq.queue.back();
+                    wq.queue.pop_back();
+                } else {
+                    procedure_index = wq.queue.front();
+                    wq.queue.pop_front();
+                }
+                --ready_num_;
+                return true;
+            }
+            return false;
+        }
+
+        void dag_executor::set_profiler(
+          profiler* profiler,
+          std::vector<profile_event_info const*> event_info_list) {
+            profiler_ = profiler;
+            event_info_list_ = std::move(event_info_list);
+        }
+
+        void dag_executor::execute(int worker_index, int procedure_index) {
+            // after an exception, remaining procedures are skipped
+            bool is_failed = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                is_failed = static_cast<bool>(exception_);
+            }
+            if(!is_failed) {
+                try {
+                    if(control_) {
+                        control_->check();
+                    }
+                    if(profiler_) {
+                        auto start = profiler::clock::now();
+                        procedure_list_.at(procedure_index)();
+                        profiler_->record(
+                          *event_info_list_.at(procedure_index), start,
+                          profiler::clock::now());
+                    } else {
+                        procedure_list_.at(procedure_index)();
+                    }
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if(!exception_) {
+                        exception_ = std::current_exception();
+                    }
+                }
+            }
+            for(auto successor : successor_list_list_.at(procedure_index)) {
+                if(--waiting_num_list_[successor] == 0) {
+                    push(worker_index, successor);
+                }
+            }
+            if(--remaining_num_ == 0) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                }
+                done_cv_.notify_all();
+            }
+        }
+
+        void dag_executor::work(int worker_index) {
+            while(true) {
+                int procedure_index = 0;
+                if(try_to_pop(worker_index, procedure_index)) {
+                    execute(worker_index, procedure_index);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_cv_.wait(
+                  lock, [this]() { return 0 < ready_num_ || is_stopped_; });
+                if(is_stopped_) {
+                    return;
+                }
+            }
+        }
+
+    } // namespace composite_backend
+} // namespace menoh_impl
@@ -0,0 +1,85 @@
+#ifndef MENOH_IMPL_COMPOSITE_BACKEND_DAG_EXECUTOR_HPP
+#define MENOH_IMPL_COMPOSITE_BACKEND_DAG_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <menoh/model_core.hpp>
+#include <menoh/profiler.hpp>
+
+#include <menoh/composite_backend/procedure.hpp>
+
+namespace menoh_impl {
+    namespace composite_backend {
+
+        // Runs procedures of a dependency DAG on a pool of worker threads.
+        // Each worker has its own queue. It runs procedures released by
+        // itself first (LIFO) and steals from the other queues (FIFO) when
+        // its own queue is empty
+        class dag_executor {
+        public:
+            // `successor_list_list[i]` is the list of procedures which must
+            // run after procedure i. Indices of successors must be larger
+            // than i
+            dag_executor(std::vector<procedure> procedure_list,
+                         std::vector<std::vector<int>> successor_list_list,
+                         int worker_num);
+            ~dag_executor();
+
+            dag_executor(dag_executor const&) = delete;
+            dag_executor& operator=(dag_executor const&) = delete;
+
+            // blocks until all procedures finish. The first exception thrown
+            // by procedures is rethrown after that. `control`, if not null,
+            // is checked before each procedure
+            void run(run_control const* control = nullptr);
+
+            // procedure i is recorded to `profiler` as
+            // `event_info_list[i]`. Null `profiler` stops recording. Must
+            // not be called while running
+            void set_profiler(
+              profiler* profiler,
+              std::vector<profile_event_info const*> event_info_list);
+
+        private:
+            struct worker_queue {
+                std::mutex mutex;
+                std::deque<int> queue;
+            };
+
+            void push(int worker_index, int procedure_index);
+            bool try_to_pop(int worker_index, int& procedure_index);
+            void execute(int worker_index, int procedure_index);
+            void work(int worker_index);
+
+            std::vector<procedure> procedure_list_;
+            std::vector<std::vector<int>> successor_list_list_;
+            std::vector<int> predecessor_num_list_;
+            std::unique_ptr<std::atomic<int>[]> waiting_num_list_;
+
+            std::vector<std::unique_ptr<worker_queue>> worker_queue_list_;
+            std::vector<std::thread> worker_list_;
+
+            std::mutex mutex_;
+            std::condition_variable work_cv_;
+            std::condition_variable done_cv_;
+            std::atomic<int> ready_num_{0};
+            std::atomic<int> remaining_num_{0};
+            bool is_stopped_ = false;
+            std::exception_ptr exception_;
+            run_control const* control_ = nullptr; // of the current run
+
+            profiler* profiler_ = nullptr;
+            std::vector<profile_event_info const*> event_info_list_;
+        };
+
+    } // namespace composite_backend
+} // namespace menoh_impl
+
+#endif // MENOH_IMPL_COMPOSITE_BACKEND_DAG_EXECUTOR_HPP
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <memory>
 
 #include <menoh/composite_backend/backend/generic/generic_context.hpp>
@@ -9,6 +10,7 @@
 
 #include <menoh/mkldnn/utility.hpp>
 
+#include <menoh/calibration_table.hpp>
 #include <menoh/exception.hpp>
 #include <menoh/json.hpp>
 #include <menoh/optional.hpp>
@@ -26,10 +28,46 @@ namespace menoh_impl {
           std::unordered_map<std::string, array_profile> const&
             output_profile_table,
           menoh_impl::model_data const& model_data,
-          backend_config const& config) {
+          backend_config const& config,
+          std::shared_ptr<mkldnn_backend::shared_weight_cache> const&
+            weight_cache) {
             std::vector<std::pair<std::string, std::unique_ptr<context>>>
               context_list;
+            std::vector<std::shared_ptr<mkldnn_backend::conv_autotuner>>
+              conv_autotuner_list;
             auto c = nlohmann::json::parse(config);
+
+            // accuracy of transcendental functions in generic backend.
+            // "exact" (default) or "fast". Can be overridden in each backend
+            auto default_accuracy = generic_backend::math_accuracy::exact;
+            if(c.find("math_accuracy") != c.end()) {
+                default_accuracy = generic_backend::string_to_math_accuracy(
+                  c["math_accuracy"].get<std::string>());
+            }
+
+            // int8 inference in mkldnn backend with the calibration table
+            // file made by menoh_calibration_table_save(). Can be
+            // overridden in each backend
+            optional<std::string> default_calibration_table_filename;
+            if(c.find("int8_calibration_table") != c.end()) {
+                default_calibration_table_filename =
+                  c["int8_calibration_table"].get<std::string>();
+            }
+
+            // Conv algorithm and layout in mkldnn backend are chosen by
+            // measurement when "conv_autotune" is true. Chosen ones are
+            // stored to (and reused from) "conv_tuning_cache" file. Both can
+            // be overridden in each backend
+            bool default_conv_autotune = false;
+            if(c.find("conv_autotune") != c.end()) {
+                default_conv_autotune = c["conv_autotune"].get<bool>();
+            }
+            optional<std::string> default_conv_tuning_cache_filename;
+            if(c.find("conv_tuning_cache") != c.end()) {
+                default_conv_tuning_cache_filename =
+                  c["conv_tuning_cache"].get<std::string>();
+            }
+
             if(c.find("backends") != c.end()) {
                 auto backends = c["backends"];
                 for(auto backend : backends) {
@@ -37,21 +75,63 @@ namespace menoh_impl {
                         throw invalid_backend_config_error("type not found");
                     }
                     if(backend["type"].get<std::string>() == "mkldnn") {
+                        auto calibration_table_filename =
+                          default_calibration_table_filename;
+                        if(backend.find("int8_calibration_table") !=
+                           backend.end()) {
+                            calibration_table_filename =
+                              backend["int8_calibration_table"]
+                                .get<std::string>();
+                        }
+                        optional<calibration_table> table;
+                        if(calibration_table_filename) {
+                            table = load_calibration_table(
+                              *calibration_table_filename);
+                        }
+                        auto conv_autotune = default_conv_autotune;
+                        if(backend.find("conv_autotune") != backend.end()) {
+                            conv_autotune =
+                              backend["conv_autotune"].get<bool>();
+                        }
+                        auto conv_tuning_cache_filename =
+                          default_conv_tuning_cache_filename;
+                        if(backend.find("conv_tuning_cache") != backend.end()) {
+                            conv_tuning_cache_filename =
+                              backend["conv_tuning_cache"].get<std::string>();
+                        }
+                        std::shared_ptr<mkldnn_backend::conv_autotuner> tuner;
+                        if(conv_autotune || conv_tuning_cache_filename) {
+                            tuner =
+                              std::make_shared<mkldnn_backend::conv_autotuner>(
+                                conv_tuning_cache_filename, conv_autotune);
+                            conv_autotuner_list.push_back(tuner);
+                        }
                         context_list.emplace_back(
                           "mkldnn",
                           std::make_unique<composite_backend::mkldnn_backend::
-                                             mkldnn_context>());
+                                             mkldnn_context>(table, tuner,
+                                                             weight_cache));
                     } else if(backend["type"].get<std::string>() == "generic") {
+                        auto accuracy = default_accuracy;
+                        if(backend.find("math_accuracy") != backend.end()) {
+                            accuracy = generic_backend::string_to_math_accuracy(
+                              backend["math_accuracy"].get<std::string>());
+                        }
                         context_list.emplace_back(
                           "generic", std::make_unique<
                                        composite_backend::generic_backend::
-                                         generic_context>());
+                                         generic_context>(accuracy));
                     }
                 }
             }
-            return model_core(std::move(context_list), input_table,
-                              output_table, output_profile_table, model_data,
-                              config);
+            auto core = model_core(std::move(context_list), input_table,
+                                   output_table, output_profile_table,
+                                   model_data, config);
+            // choices of all layers are written at once
+            for(auto const& tuner : conv_autotuner_list) {
+                tuner->save();
+            }
+            return core;
         }
 
         model_core::model_core(
@@ -88,6 +168,113 @@ namespace menoh_impl {
                 }
             }
 
+            // independent nodes run concurrently on "inter_op_thread_num"
+            // workers when it is larger than 1. Then each node is processed
+            // separately and becomes a task of the dependency DAG
+            int inter_op_thread_num = 1;
+            if(!config.empty()) {
+                auto c = nlohmann::json::parse(config);
+                if(c.find("inter_op_thread_num") != c.end()) {
+                    inter_op_thread_num = c["inter_op_thread_num"].get<int>();
+                    if(inter_op_thread_num < 1) {
+                        throw invalid_backend_config_error(
+                          "invalid value of \"inter_op_thread_num\": " +
+                          std::to_string(inter_op_thread_num));
+                    }
+                }
+            }
+            bool is_dag_mode = 1 < inter_op_thread_num;
+
+            // a profiler is attached at build with "profiling": true
+            bool is_profiling_mode = false;
+            if(!config.empty()) {
+                auto c = nlohmann::json::parse(config);
+                if(c.find("profiling") != c.end()) {
+                    is_profiling_mode = c["profiling"].get<bool>();
+                }
+            }
+
+            auto dims_of = [&](std::string const& name) {
+                auto found = output_profile_table.find(name);
+                if(found != output_profile_table.end()) {
+                    return found->second.dims();
+                }
+                for(auto table :
+                    {&common_input_table_, &common_parameter_table_}) {
+                    auto found_array = table->find(name);
+                    if(found_array != table->end()) {
+                        return found_array->second.dims();
+                    }
+                }
+                return std::vector<int>();
+            };
+            // formats are taken just after the context processed the node
+            auto make_event_info = [&](std::string const& context_name,
+                                       context const& node_context,
+                                       node const& node) {
+                auto info = std::make_unique<profile_event_info>();
+                info->name = node.output_name_list.at(0);
+                info->op_type = node.op_type;
+                info->context_name = context_name;
+                for(auto const& name : node.input_name_list) {
+                    info->input_dims_list.push_back(dims_of(name));
+                    info->input_format_list.push_back(
+                      node_context.get_variable_format_name(name));
+                }
+                for(auto const& name : node.output_name_list) {
+                    info->output_dims_list.push_back(dims_of(name));
+                    info->output_format_list.push_back(
+                      node_context.get_variable_format_name(name));
+                }
+                return info;
+            };
+            std::vector<procedure> task_list;
+            std::vector<std::vector<int>> successor_list_list;
+            std::unordered_map<std::string, int> producer_task_table;
+            std::unordered_map<std::string, int> last_reader_task_table;
+
+            // A task depends on the producers of its inputs and on the
+            // previous reader of each input. Readers are ordered because
+            // contexts share format conversions of a variable among its
+            // readers and an input may be overwritten in place at its last
+            // use
+            auto add_task = [&](node const& node,
+                                std::vector<procedure> procedure_list) {
+                procedure_list.erase(
+                  std::remove_if(
+                    procedure_list.begin(), procedure_list.end(),
+                    [](auto const& e) { return !static_cast<bool>(e); }),
+                  procedure_list.end());
+                int task_index = static_cast<int>(task_list.size());
+                task_list.push_back([procedure_list]() {
+                    for(auto const& procedure : procedure_list) {
+                        procedure.operator()();
+                    }
+                });
+                successor_list_list.emplace_back();
+                std::vector<int> predecessor_list;
+                for(auto const& input_name : node.input_name_list) {
+                    for(auto table :
+                        {&producer_task_table, &last_reader_task_table}) {
+                        auto found = table->find(input_name);
+                        if(found != table->end()) {
+                            predecessor_list.push_back(found->second);
+                        }
+                    }
+                    last_reader_task_table[input_name] = task_index;
+                }
+                for(auto const& output_name : node.output_name_list) {
+                    producer_task_table[output_name] = task_index;
+                }
+                std::sort(predecessor_list.begin(), predecessor_list.end());
+                predecessor_list.erase(std::unique(predecessor_list.begin(),
+                                                   predecessor_list.end()),
+                                       predecessor_list.end());
+                for(auto predecessor : predecessor_list) {
+                    successor_list_list.at(predecessor).push_back(task_index);
+                }
+            };
+
             auto graph = make_graph(model_data.node_list);
 
             for(decltype(graph.node_list().size()) current_index = 0;
@@ -102,10 +289,13 @@ namespace menoh_impl {
                     auto const& context_name = context_pair.first;
                     auto context = context_pair.second.get();
 
-                    // try to process nodes
+                    // Try to process the node. Nodes are processed one by
+                    // one so that the profiler records each node as its own
+                    // event and the DAG executor runs it as its own task
                     optional<std::tuple<std::vector<procedure>, int>> result =
                       context->process_node_list(
-                        context_name, current_index, graph.node_list(),
+                        context_name, current_index, current_index + 1,
+                        graph.node_list(),
                         common_parameter_table_, common_input_table_,
                         required_output_table_, output_profile_table,
                         context_list_, logger_.get());
@@ -122,12 +312,24 @@ namespace menoh_impl {
                         std::vector<procedure> additional_procedure_list;
                         std::tie(additional_procedure_list, current_index) =
                           *result;
-                        procedure_list_.insert(
-                          procedure_list_.end(),
-                          std::make_move_iterator(
-                            additional_procedure_list.begin()),
-                          std::make_move_iterator(
-                            additional_procedure_list.end()));
+                        event_info_list_.push_back(
+                          make_event_info(context_name, *context, node));
+                        if(is_dag_mode) {
+                            add_task(node, additional_procedure_list);
+                        } else {
+                            // delete useless procedures
+                            std::copy_if(
+                              std::make_move_iterator(
+                                additional_procedure_list.begin()),
+                              std::make_move_iterator(
+                                additional_procedure_list.end()),
+                              std::back_inserter(procedure_list_),
+                              [](auto const& e) {
+                                  return static_cast<bool>(e);
+                              });
+                            segment_end_list_.push_back(
+                              static_cast<int>(procedure_list_.size()));
+                        }
                         is_found = true;
                         break;
                     } else {
@@ -145,14 +347,88 @@ namespace menoh_impl {
                 }
             }
 
-            // delete useless procedures
-            auto end_iter = std::remove_if(
-              procedure_list_.begin(), procedure_list_.end(),
-              [](auto const& e) { return !static_cast<bool>(e); });
-            procedure_list_.erase(end_iter, procedure_list_.end());
+            if(is_dag_mode) {
+                *logger_ << "run " << task_list.size() << " tasks on "
+                         << inter_op_thread_num << " inter-op workers"
+                         << std::endl;
+                dag_executor_ = std::make_unique<dag_executor>(
+                  std::move(task_list), std::move(successor_list_list),
+                  inter_op_thread_num);
+            }
+            if(is_profiling_mode) {
+                set_profiler(std::make_shared<profiler>());
+            }
+        }
+
+        void model_core::do_set_profiler(
+          std::shared_ptr<menoh_impl::profiler> const& profiler) {
+            profiler_ = profiler;
+            if(dag_executor_) {
+                std::vector<profile_event_info const*> info_list;
+                for(auto const& info : event_info_list_) {
+                    info_list.push_back(info.get());
+                }
+                dag_executor_->set_profiler(profiler_.get(),
+                                            std::move(info_list));
+            }
+        }
+
+        std::shared_ptr<menoh_impl::profiler>
+        model_core::do_get_profiler() const {
+            return profiler_;
         }
 
-        void model_core::do_run() {
+        void model_core::do_collect_memory_stats(memory_stats& stats) const {
+            // contexts may wrap external buffers in their own memories
+            for(auto table : {&common_parameter_table_, &common_input_table_,
+                              &required_output_table_}) {
+                for(auto const& p : *table) {
+                    if(!p.second.has_ownership()) {
+                        stats.exclude(p.second.data());
+                    }
+                }
+            }
+            for(auto const& p : common_parameter_table_) {
+                stats.add(p.first, memory_category::parameter, p.second);
+            }
+            for(auto table : {&common_input_table_, &required_output_table_}) {
+                for(auto const& p : *table) {
+                    stats.add(p.first, memory_category::io, p.second);
+                }
+            }
+            for(auto const& context_pair : context_list_) {
+                context_pair.second->collect_memory_stats(stats);
+            }
+        }
+
+        void model_core::do_run(run_control const* control) {
+            if(dag_executor_) {
+                dag_executor_->run(control);
+                return;
+            }
+            if(profiler_) {
+                // procedures of each node are timed together
+                int first = 0;
+                for(unsigned int i = 0; i < segment_end_list_.size(); ++i) {
+                    auto start = profiler::clock::now();
+                    for(; first < segment_end_list_[i]; ++first) {
+                        if(control) {
+                            control->check();
+                        }
+                        procedure_list_[first].operator()();
+                    }
+                    profiler_->record(*event_info_list_[i], start,
+                                      profiler::clock::now());
+                }
+                return;
+            }
+            if(control) {
+                for(auto const& procedure : procedure_list_) {
+                    control->check();
+                    procedure.operator()();
+                }
+                return;
+            }
             for(auto const& procedure : procedure_list_) {
                 procedure.operator()();
             }
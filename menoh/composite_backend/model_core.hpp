@@ -10,13 +10,19 @@
 #include <menoh/backend_config.hpp>
 #include <menoh/model_core.hpp>
 #include <menoh/model_data.hpp>
+#include <menoh/profiler.hpp>
 
 #include <menoh/composite_backend/context.hpp>
+#include <menoh/composite_backend/dag_executor.hpp>
 #include <menoh/composite_backend/logger.hpp>
 
 namespace menoh_impl {
     namespace composite_backend {
 
+        namespace mkldnn_backend {
+            class shared_weight_cache;
+        } // namespace mkldnn_backend
+
         class model_core final : public menoh_impl::model_core {
         public:
             model_core(
@@ -30,7 +36,13 @@ namespace menoh_impl {
               backend_config const& config);
 
         private:
-            virtual void do_run() override;
+            virtual void do_run(run_control const* control) override;
+            virtual void do_set_profiler(
+              std::shared_ptr<menoh_impl::profiler> const& profiler) override;
+            virtual std::shared_ptr<menoh_impl::profiler>
+            do_get_profiler() const override;
+            virtual void
+            do_collect_memory_stats(memory_stats& stats) const override;
 
             std::unordered_map<std::string, array> common_parameter_table_;
             std::unordered_map<std::string, array> common_input_table_;
@@ -40,15 +52,29 @@ namespace menoh_impl {
             logger logger_;
 
             std::vector<procedure> procedure_list_;
+
+            // what each node runs. In sequential mode procedures of the i-th
+            // node end at segment_end_list_[i]. In DAG mode the i-th node is
+            // the i-th task
+            std::vector<std::unique_ptr<profile_event_info>> event_info_list_;
+            std::vector<int> segment_end_list_;
+            std::shared_ptr<menoh_impl::profiler> profiler_;
+
+            // used instead of procedure_list_ when nodes run concurrently
+            std::unique_ptr<dag_executor> dag_executor_;
         };
 
+        // mkldnn contexts keep parameters in `weight_cache`, which is shared
+        // with other models built with it
         model_core make_model_core(
           std::unordered_map<std::string, array> const& input_table,
           std::unordered_map<std::string, array> const& output_table,
           std::unordered_map<std::string, array_profile> const&
             output_profile_table,
           menoh_impl::model_data const& model_data,
-          backend_config const& config);
+          backend_config const& config,
+          std::shared_ptr<mkldnn_backend::shared_weight_cache> const&
+            weight_cache = nullptr);
 
     } // namespace composite_backend
 } // namespace menoh_impl
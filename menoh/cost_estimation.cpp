@@ -0,0 +1,207 @@
+#include <menoh/cost_estimation.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <unordered_set>
+
+#include <menoh/node.hpp>
+#include <menoh/utility.hpp>
+
+namespace menoh_impl {
+
+    double arithmetic_intensity(node_cost const& cost) {
+        auto bytes = cost.parameter_bytes + cost.activation_read_bytes +
+                     cost.activation_written_bytes;
+        return bytes == 0 ? 0.
+                          : static_cast<double>(cost.flop_num) /
+                              static_cast<double>(bytes);
+    }
+
+    namespace {
+        std::int64_t product(std::vector<int>::const_iterator first,
+                             std::vector<int>::const_iterator last) {
+            return std::accumulate(first, last, std::int64_t(1),
+                                   std::multiplies<std::int64_t>());
+        }
+
+        std::int64_t element_num(std::vector<int> const& dims) {
+            return product(dims.begin(), dims.end());
+        }
+
+        // flops per element of the output of elementwise operators
+        std::unordered_map<std::string, int> const&
+        elementwise_flop_num_table() {
+            static const std::unordered_map<std::string, int> table = {
+              {"Abs", 1},     {"Add", 1},       {"BatchNormalization", 2},
+              {"Clip", 2},    {"Div", 1},       {"Elu", 2},
+              {"Exp", 1},     {"LeakyRelu", 2}, {"Log", 1},
+              {"Mul", 1},     {"Neg", 1},       {"Relu", 1},
+              {"Sigmoid", 3}, {"Softmax", 4},   {"Sqrt", 1},
+              {"Sub", 1},     {"Tanh", 1}};
+            return table;
+        }
+
+        std::int64_t estimate_flop_num(
+          node const& n,
+          std::unordered_map<std::string, array_profile> const&
+            profile_table) {
+            auto dims_of = [&profile_table](std::string const& name) {
+                auto found = profile_table.find(name);
+                if(found == profile_table.end()) {
+                    throw variable_not_found(name);
+                }
+                return found->second.dims();
+            };
+            auto output_num = element_num(dims_of(n.output_name_list.at(0)));
+            auto const& op_type = n.op_type;
+
+            if(op_type == "Conv") {
+                // weight is (m, c / group, kh, kw)
+                auto weight_dims = dims_of(n.input_name_list.at(1));
+                auto flop_num =
+                  2 * output_num *
+                  product(weight_dims.begin() + 1, weight_dims.end());
+                if(2 < n.input_name_list.size()) {
+                    flop_num += output_num; // bias
+                }
+                return flop_num;
+            }
+            if(op_type == "ConvTranspose") {
+                // weight is (c, m / group, kh, kw). Each input element is
+                // scattered to the output
+                auto input_num = element_num(dims_of(n.input_name_list.at(0)));
+                auto weight_dims = dims_of(n.input_name_list.at(1));
+                auto flop_num =
+                  2 * input_num *
+                  product(weight_dims.begin() + 1, weight_dims.end());
+                if(2 < n.input_name_list.size()) {
+                    flop_num += output_num;
+                }
+                return flop_num;
+            }
+            if(op_type == "Gemm" || op_type == "FC") {
+                auto a_dims = dims_of(n.input_name_list.at(0));
+                // FC flattens the input to (batch, k)
+                auto k =
+                  op_type == "FC" || !optional_attribute_int(n, "transA", 0)
+                    ? product(a_dims.begin() + 1, a_dims.end())
+                    : std::int64_t(a_dims.at(0));
+                auto flop_num = 2 * output_num * k;
+                if(2 < n.input_name_list.size()) {
+                    flop_num += output_num;
+                }
+                return flop_num;
+            }
+            if(op_type == "MatMul") {
+                return 2 * output_num *
+                       dims_of(n.input_name_list.at(0)).back();
+            }
+            if(op_type == "MaxPool" || op_type == "AveragePool") {
+                auto kernel_shape = attribute_ints(n, "kernel_shape");
+                return output_num *
+                       product(kernel_shape.begin(), kernel_shape.end());
+            }
+            if(op_type == "GlobalMaxPool" || op_type == "GlobalAveragePool" ||
+               op_type.compare(0, 6, "Reduce") == 0) {
+                return element_num(dims_of(n.input_name_list.at(0)));
+            }
+            if(op_type == "LRN") {
+                // sum of squares over the window, then scale
+                return output_num * (2 * attribute_int(n, "size") + 3);
+            }
+            if(op_type == "Sum" || op_type == "Max" || op_type == "Min" ||
+               op_type == "Mean") {
+                // the binary operation is applied n - 1 times
+                return output_num *
+                       std::max<std::int64_t>(
+                         1, static_cast<std::int64_t>(
+                              n.input_name_list.size()) - 1);
+            }
+            auto found = elementwise_flop_num_table().find(op_type);
+            if(found != elementwise_flop_num_table().end()) {
+                return output_num * found->second;
+            }
+
+            // operators moving data (Reshape, Transpose, Concat, ...) and
+            // unknown operators
+            return 0;
+        }
+    } // namespace
+
+    std::vector<node_cost>
+    estimate_node_cost_list(menoh_impl::model_data const& model_data,
+                            std::unordered_map<std::string, array_profile> const&
+                              profile_table) {
+        std::unordered_set<std::string> parameter_name_set;
+        for(auto const& p : model_data.parameter_name_and_array_list) {
+            parameter_name_set.insert(p.first);
+        }
+        auto bytes_of = [&profile_table](std::string const& name) {
+            auto found = profile_table.find(name);
+            if(found == profile_table.end()) {
+                throw variable_not_found(name);
+            }
+            return element_num(found->second.dims()) *
+                   get_size_in_bytes(found->second.dtype());
+        };
+
+        std::vector<node_cost> cost_list;
+        for(auto const& n : model_data.node_list) {
+            node_cost cost;
+            cost.name = n.output_name_list.at(0);
+            cost.op_type = n.op_type;
+            cost.flop_num = estimate_flop_num(n, profile_table);
+            for(auto const& name : n.input_name_list) {
+                if(name.empty()) { // omitted optional input
+                    continue;
+                }
+                if(parameter_name_set.count(name)) {
+                    cost.parameter_bytes += bytes_of(name);
+                } else {
+                    cost.activation_read_bytes += bytes_of(name);
+                }
+            }
+            for(auto const& name : n.output_name_list) {
+                if(!name.empty()) {
+                    cost.activation_written_bytes += bytes_of(name);
+                }
+            }
+            cost_list.push_back(cost);
+        }
+        return cost_list;
+    }
+
+    node_cost total_cost(std::vector<node_cost> const& cost_list) {
+        node_cost total;
+        total.name = "total";
+        total.op_type = "total";
+        for(auto const& cost : cost_list) {
+            total.flop_num += cost.flop_num;
+            total.parameter_bytes += cost.parameter_bytes;
+            total.activation_read_bytes += cost.activation_read_bytes;
+            total.activation_written_bytes += cost.activation_written_bytes;
+        }
+        return total;
+    }
+
+    std::string to_cost_table_string(std::vector<node_cost> const& cost_list) {
+        std::ostringstream oss;
+        oss << "name\top_type\tflops\tparameter_bytes\tactivation_read_bytes"
+               "\tactivation_written_bytes\tarithmetic_intensity\n";
+        auto write_row = [&oss](node_cost const& cost) {
+            oss << cost.name << "\t" << cost.op_type << "\t" << cost.flop_num
+                << "\t" << cost.parameter_bytes << "\t"
+                << cost.activation_read_bytes << "\t"
+                << cost.activation_written_bytes << "\t"
+                << arithmetic_intensity(cost) << "\n";
+        };
+        for(auto const& cost : cost_list) {
+            write_row(cost);
+        }
+        write_row(total_cost(cost_list));
+        return oss.str();
+    }
+
+} // namespace menoh_impl
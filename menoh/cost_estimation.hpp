@@ -0,0 +1,47 @@
+#ifndef MENOH_COST_ESTIMATION_HPP
+#define MENOH_COST_ESTIMATION_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/model_data.hpp>
+
+namespace menoh_impl {
+
+    // static cost of a node. A multiply-add is counted as 2 flops. Inputs
+    // which are parameters of the model are counted as parameter bytes and
+    // others as activation bytes read
+    struct node_cost {
+        std::string name; // first output name, same as profiler events
+        std::string op_type;
+        std::int64_t flop_num = 0;
+        std::int64_t parameter_bytes = 0;
+        std::int64_t activation_read_bytes = 0;
+        std::int64_t activation_written_bytes = 0;
+    };
+
+    // flops per byte moved. 0 when no byte is moved
+    double arithmetic_intensity(node_cost const& cost);
+
+    // Costs of nodes in order of `model_data`. `profile_table` must have
+    // profiles of all variables, as returned by
+    // complete_attribute_and_infer_shape(). Flops of operators which only
+    // move data or are not known are 0
+    std::vector<node_cost>
+    estimate_node_cost_list(menoh_impl::model_data const& model_data,
+                            std::unordered_map<std::string, array_profile> const&
+                              profile_table);
+
+    // sum of costs. name and op_type are "total"
+    node_cost total_cost(std::vector<node_cost> const& cost_list);
+
+    // tab separated table of costs and arithmetic intensity of each node
+    // followed by the total
+    std::string to_cost_table_string(std::vector<node_cost> const& cost_list);
+
+} // namespace menoh_impl
+
+#endif // MENOH_COST_ESTIMATION_HPP
@@ -0,0 +1,289 @@
+#include <menoh/cpu_placement.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+#include <menoh/json.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace menoh_impl {
+
+    namespace {
+
+#ifdef __linux__
+        bool set_current_thread_cpu_list(std::vector<int> const& cpu_list) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for(auto cpu : cpu_list) {
+                if(cpu < 0 || CPU_SETSIZE <= cpu) {
+                    return false;
+                }
+                CPU_SET(cpu, &set);
+            }
+            return sched_setaffinity(0, sizeof(set), &set) == 0;
+        }
+#endif
+
+        std::string cpu_list_to_string(std::vector<int> const& cpu_list) {
+            std::string str;
+            for(auto cpu : cpu_list) {
+                str += (str.empty() ? "" : ",") + std::to_string(cpu);
+            }
+            return str;
+        }
+
+    } // namespace
+
+    std::vector<int> current_thread_cpu_list() {
+        std::vector<int> cpu_list;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if(sched_getaffinity(0, sizeof(set), &set) != 0) {
+            return cpu_list;
+        }
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if(CPU_ISSET(cpu, &set)) {
+                cpu_list.push_back(cpu);
+            }
+        }
+#endif
+        return cpu_list;
+    }
+
+    std::vector<int> parse_cpu_list_string(std::string const& str) {
+        std::vector<int> cpu_list;
+        std::stringstream ss(str);
+        std::string range;
+        while(std::getline(ss, range, ',')) {
+            if(range.empty() || range == "\n") {
+                continue;
+            }
+            auto hyphen = range.find('-');
+            try {
+                if(hyphen == std::string::npos) {
+                    cpu_list.push_back(std::stoi(range));
+                } else {
+                    auto first = std::stoi(range.substr(0, hyphen));
+                    auto last = std::stoi(range.substr(hyphen + 1));
+                    for(int cpu = first; cpu <= last; ++cpu) {
+                        cpu_list.push_back(cpu);
+                    }
+                }
+            } catch(std::logic_error const&) {
+                throw invalid_backend_config_error("invalid cpu list: " +
+                                                   str);
+            }
+        }
+        return cpu_list;
+    }
+
+    std::vector<int> numa_node_cpu_list(int numa_node) {
+        auto filename = "/sys/devices/system/node/node" +
+                        std::to_string(numa_node) + "/cpulist";
+        std::ifstream ifs(filename);
+        std::string str;
+        if(!ifs || !std::getline(ifs, str)) {
+            throw invalid_backend_config_error(
+              "NUMA node not found: " + std::to_string(numa_node));
+        }
+        auto cpu_list = parse_cpu_list_string(str);
+        if(cpu_list.empty()) {
+            throw invalid_backend_config_error(
+              "NUMA node has no cpus: " + std::to_string(numa_node));
+        }
+        return cpu_list;
+    }
+
+    optional<cpu_placement> parse_cpu_placement(std::string const& config) {
+        if(config.empty()) {
+            return nullopt;
+        }
+        auto c = nlohmann::json::parse(config);
+        if(c.find("thread_num") == c.end() && c.find("cpu_list") == c.end() &&
+           c.find("numa_node") == c.end()) {
+            return nullopt;
+        }
+        cpu_placement placement;
+        if(c.find("thread_num") != c.end()) {
+            placement.thread_num = c["thread_num"].get<int>();
+            if(*placement.thread_num < 1) {
+                throw invalid_backend_config_error(
+                  "invalid value of \"thread_num\": " +
+                  std::to_string(*placement.thread_num));
+            }
+        }
+        if(c.find("cpu_list") != c.end()) {
+            placement.cpu_list = c["cpu_list"].get<std::vector<int>>();
+            for(auto cpu : placement.cpu_list) {
+                if(cpu < 0) {
+                    throw invalid_backend_config_error(
+                      "invalid value of \"cpu_list\": " +
+                      cpu_list_to_string(placement.cpu_list));
+                }
+            }
+        }
+        if(c.find("numa_node") != c.end()) {
+            placement.numa_node = c["numa_node"].get<int>();
+            if(placement.cpu_list.empty()) {
+                placement.cpu_list = numa_node_cpu_list(*placement.numa_node);
+            }
+        }
+        return placement;
+    }
+
+    namespace {
+
+        // Pins the calling thread to `cpu_list` and the i-th OpenMP thread
+        // it starts to one of them, and sets the number of OpenMP threads.
+        // OpenMP threads are reused by later parallel regions started by the
+        // calling thread, so they stay pinned. The calling thread keeps all
+        // cpus and mostly takes the first one, which no other thread is
+        // pinned to. Previous masks of OpenMP threads are stored to
+        // `saved_worker_cpu_list_list` when it is not null
+        void pin_threads(cpu_placement const& placement,
+                         std::vector<std::vector<int>>*
+                           saved_worker_cpu_list_list) {
+            auto const& cpu_list = placement.cpu_list;
+#ifdef __linux__
+            if(!cpu_list.empty() && !set_current_thread_cpu_list(cpu_list)) {
+                throw invalid_backend_config_error(
+                  "failed to pin threads to cpus: " +
+                  cpu_list_to_string(cpu_list));
+            }
+#endif
+#ifdef _OPENMP
+            int thread_num = placement.thread_num
+                               ? *placement.thread_num
+                               : cpu_list.empty()
+                                   ? omp_get_max_threads()
+                                   : static_cast<int>(cpu_list.size());
+            omp_set_num_threads(thread_num);
+#ifdef __linux__
+            if(!cpu_list.empty()) {
+                if(saved_worker_cpu_list_list) {
+                    saved_worker_cpu_list_list->assign(thread_num, {});
+                }
+#pragma omp parallel num_threads(thread_num)
+                {
+                    int i = omp_get_thread_num();
+                    if(i != 0) {
+                        if(saved_worker_cpu_list_list) {
+                            saved_worker_cpu_list_list->at(i) =
+                              current_thread_cpu_list();
+                        }
+                        set_current_thread_cpu_list(
+                          {cpu_list.at(i % cpu_list.size())});
+                    }
+                }
+            }
+#else
+            static_cast<void>(saved_worker_cpu_list_list);
+#endif
+#else
+            static_cast<void>(saved_worker_cpu_list_list);
+#endif
+        }
+
+    } // namespace
+
+    void apply_cpu_placement(cpu_placement const& placement) {
+        pin_threads(placement, nullptr);
+    }
+
+    cpu_placement_guard::cpu_placement_guard(cpu_placement const& placement) {
+#ifdef __linux__
+        if(!placement.cpu_list.empty()) {
+            saved_cpu_list_ = current_thread_cpu_list();
+        }
+#endif
+#ifdef _OPENMP
+        saved_thread_num_ = omp_get_max_threads();
+#endif
+        pin_threads(placement, &saved_worker_cpu_list_list_);
+    }
+
+    cpu_placement_guard::~cpu_placement_guard() {
+#if defined(_OPENMP) && defined(__linux__)
+        // the same team is reused, so each thread gets back its own mask
+        if(!saved_worker_cpu_list_list_.empty()) {
+            int thread_num =
+              static_cast<int>(saved_worker_cpu_list_list_.size());
+#pragma omp parallel num_threads(thread_num)
+            {
+                auto i = static_cast<std::size_t>(omp_get_thread_num());
+                if(i < saved_worker_cpu_list_list_.size() &&
+                   !saved_worker_cpu_list_list_.at(i).empty()) {
+                    set_current_thread_cpu_list(
+                      saved_worker_cpu_list_list_.at(i));
+                }
+            }
+        }
+#endif
+#ifdef _OPENMP
+        omp_set_num_threads(saved_thread_num_);
+#endif
+#ifdef __linux__
+        if(!saved_cpu_list_.empty()) {
+            set_current_thread_cpu_list(saved_cpu_list_);
+        }
+#endif
+    }
+
+    void move_memory_to_numa_node(void const* data, std::size_t size,
+                                  int numa_node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        if(size == 0 || numa_node < 0) {
+            return;
+        }
+        constexpr int mpol_bind = 2;
+        constexpr unsigned mpol_mf_move = 1u << 1;
+        constexpr int bit_num = sizeof(unsigned long) * 8;
+        std::vector<unsigned long> node_mask(numa_node / bit_num + 1, 0);
+        node_mask.at(numa_node / bit_num) |= 1ul << (numa_node % bit_num);
+
+        // mbind takes page aligned range
+        auto page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+        auto address = reinterpret_cast<std::uintptr_t>(data);
+        auto first = address / page_size * page_size;
+        auto last = (address + size + page_size - 1) / page_size * page_size;
+        syscall(SYS_mbind, first, last - first, mpol_bind, node_mask.data(),
+                node_mask.size() * bit_num + 1, mpol_mf_move);
+#else
+        static_cast<void>(data);
+        static_cast<void>(size);
+        static_cast<void>(numa_node);
+#endif
+    }
+
+    void prefault_memory(void* data, std::size_t size) {
+        if(size == 0) {
+            return;
+        }
+        std::size_t page_size = 4096;
+#ifdef __linux__
+        page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto address = reinterpret_cast<std::uintptr_t>(data);
+        auto first = address / page_size * page_size;
+        madvise(reinterpret_cast<void*>(first), address + size - first,
+                MADV_WILLNEED);
+#endif
+        auto p = static_cast<volatile char*>(data);
+        for(std::size_t i = 0; i < size; i += page_size) {
+            p[i] = p[i];
+        }
+        p[size - 1] = p[size - 1];
+    }
+
+} // namespace menoh_impl
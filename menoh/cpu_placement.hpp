@@ -0,0 +1,70 @@
+#ifndef MENOH_CPU_PLACEMENT_HPP
+#define MENOH_CPU_PLACEMENT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <menoh/exception.hpp>
+#include <menoh/optional.hpp>
+
+namespace menoh_impl {
+
+    // threads, cores and NUMA node on which a model runs. They are given by
+    // "thread_num", "cpu_list" and "numa_node" in backend config
+    struct cpu_placement {
+        optional<int> thread_num;
+        std::vector<int> cpu_list; // empty when threads are not pinned
+        optional<int> numa_node;
+    };
+
+    // cpus the calling thread can run on. Empty when it is unknown
+    std::vector<int> current_thread_cpu_list();
+
+    // parse Linux cpu list format such as "0-3,8,10-11"
+    std::vector<int> parse_cpu_list_string(std::string const& str);
+
+    // cpus of the NUMA node read from sysfs
+    std::vector<int> numa_node_cpu_list(int numa_node);
+
+    // Returns nullopt when none of the keys is in the config. When only
+    // "numa_node" is given, threads are pinned to the cpus of the node
+    optional<cpu_placement> parse_cpu_placement(std::string const& config);
+
+    // Pins the calling thread to the cpus of the placement and each OpenMP
+    // thread it starts to one of them, and sets the number of OpenMP
+    // threads. They stay pinned until another placement is applied on the
+    // calling thread
+    void apply_cpu_placement(cpu_placement const& placement);
+
+    // Applies the placement like apply_cpu_placement(). Affinity of the
+    // calling thread and its OpenMP threads and the number of threads are
+    // restored on destruction, so the guard must be destroyed on the thread
+    // which created it
+    class cpu_placement_guard {
+    public:
+        explicit cpu_placement_guard(cpu_placement const& placement);
+        ~cpu_placement_guard();
+
+        cpu_placement_guard(cpu_placement_guard const&) = delete;
+        cpu_placement_guard& operator=(cpu_placement_guard const&) = delete;
+
+    private:
+        std::vector<int> saved_cpu_list_;
+        std::vector<std::vector<int>> saved_worker_cpu_list_list_;
+        int saved_thread_num_ = 0;
+    };
+
+    // Moves pages of the memory to the NUMA node and allocates its
+    // untouched pages there. Best effort: nothing is done when the system
+    // does not support it
+    void move_memory_to_numa_node(void const* data, std::size_t size,
+                                  int numa_node);
+
+    // Maps all pages of the memory by writing back a byte of each page, so
+    // later accesses cause no page faults. Contents are not changed
+    void prefault_memory(void* data, std::size_t size);
+
+} // namespace menoh_impl
+
+#endif // MENOH_CPU_PLACEMENT_HPP
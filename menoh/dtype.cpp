@@ -1,5 +1,7 @@
 #include <menoh/dtype.hpp>
 
+#include <cstring>
+
 namespace menoh_impl {
 
     std::string dtype_to_string(dtype_t dtype) {
@@ -7,6 +9,10 @@ namespace menoh_impl {
             return "undefined";
         } else if(dtype == dtype_t::float_) {
             return "float";
+        } else if(dtype == dtype_t::float16) {
+            return "float16";
+        } else if(dtype == dtype_t::bfloat16) {
+            return "bfloat16";
         }
         throw invalid_dtype(std::to_string(static_cast<int>(dtype)));
     }
@@ -32,8 +38,87 @@ namespace menoh_impl {
         } else
         if(d == dtype_t::int64) {
             return size_in_bytes<dtype_t::int64>;
+        } else
+        if(d == dtype_t::bfloat16) {
+            return size_in_bytes<dtype_t::bfloat16>;
         }
         throw invalid_dtype(std::to_string(static_cast<int>(d)));
     }
 
+    float float16_to_float(std::uint16_t h) {
+        std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+        std::uint32_t exponent = (h >> 10) & 0x1fu;
+        std::uint32_t mantissa = h & 0x3ffu;
+        std::uint32_t bits;
+        if(exponent == 0x1fu) { // inf and nan
+            bits = sign | 0x7f800000u | (mantissa << 13);
+        } else if(exponent != 0) {
+            bits = sign | ((exponent + (127 - 15)) << 23) | (mantissa << 13);
+        } else if(mantissa == 0) {
+            bits = sign;
+        } else { // subnormal half is normal float
+            exponent = 127 - 15 + 1;
+            while(!(mantissa & 0x400u)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        }
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    std::uint16_t float_to_float16(float f) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+        std::uint32_t abs = bits & 0x7fffffffu;
+        if(abs >= 0x7f800000u) { // inf and nan
+            return sign | 0x7c00u | (abs > 0x7f800000u ? 0x200u : 0u);
+        }
+        if(abs >= 0x477ff000u) { // rounded to inf
+            return sign | 0x7c00u;
+        }
+        // round to nearest even
+        auto round = [](std::uint32_t value, int shift) {
+            std::uint32_t result = value >> shift;
+            std::uint32_t rest = value & ((1u << shift) - 1);
+            std::uint32_t half = 1u << (shift - 1);
+            if(rest > half || (rest == half && (result & 1u))) {
+                ++result;
+            }
+            return result;
+        };
+        if(abs < 0x38800000u) { // subnormal half
+            if(abs < 0x33000000u) {
+                return sign;
+            }
+            std::uint32_t exponent = abs >> 23;
+            std::uint32_t mantissa = (abs & 0x7fffffu) | 0x800000u;
+            return sign | static_cast<std::uint16_t>(
+                            round(mantissa, 126 - exponent));
+        }
+        return sign |
+               static_cast<std::uint16_t>(round(abs - 0x38000000u, 13));
+    }
+
+    float bfloat16_to_float(std::uint16_t b) {
+        std::uint32_t bits = static_cast<std::uint32_t>(b) << 16;
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    std::uint16_t float_to_bfloat16(float f) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        if((bits & 0x7fffffffu) > 0x7f800000u) { // keep nan quiet
+            return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+        }
+        // round to nearest even
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+        return static_cast<std::uint16_t>(bits >> 16);
+    }
+
 } // namespace menoh_impl
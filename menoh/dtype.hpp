@@ -28,6 +28,7 @@ namespace menoh_impl {
         int16 = menoh_dtype_int16,
         int32 = menoh_dtype_int32,
         int64 = menoh_dtype_int64,
+        bfloat16 = menoh_dtype_bfloat16,
         // TODO more types
     };
     static_assert(dtype_t::undefined != dtype_t::float_, "");
@@ -49,6 +50,11 @@ namespace menoh_impl {
         using type = std::int16_t;
     };
 
+    template <>
+    struct dtype_to_type<dtype_t::bfloat16> {
+        using type = std::uint16_t;
+    };
+
     template <>
     struct dtype_to_type<dtype_t::float32> { // including dtype_t::float_
         using type = float;
@@ -87,6 +93,17 @@ namespace menoh_impl {
 
     int get_size_in_bytes(dtype_t d);
 
+    // float16 (IEEE 754 binary16) and bfloat16 are reduced precision
+    // storage of float. They are expanded to float before computation
+    inline bool is_reduced_precision_float(dtype_t d) {
+        return d == dtype_t::float16 || d == dtype_t::bfloat16;
+    }
+
+    float float16_to_float(std::uint16_t h);
+    std::uint16_t float_to_float16(float f);
+    float bfloat16_to_float(std::uint16_t b);
+    std::uint16_t float_to_bfloat16(float f);
+
 } // namespace menoh_impl
 
 #endif // MENOH_DTYPE_HPP
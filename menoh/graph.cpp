@@ -72,6 +72,17 @@ namespace menoh_impl {
         return all_output_name_set;
     }
 
+    std::unordered_map<std::string, int>
+    make_last_use_index_table(std::vector<node> const& node_list) {
+        std::unordered_map<std::string, int> last_use_index_table;
+        for(int i = 0; i < static_cast<int>(node_list.size()); ++i) {
+            for(auto const& input_name : node_list.at(i).input_name_list) {
+                last_use_index_table[input_name] = i;
+            }
+        }
+        return last_use_index_table;
+    }
+
     std::vector<std::string>
     name_set_difference(std::set<std::string> const& name_set_left,
                         std::set<std::string> const& name_set_right) {
@@ -3,6 +3,7 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -23,6 +24,10 @@ namespace menoh_impl {
     std::set<std::string>
     extract_all_output_name_set(std::vector<node> const& node_list);
 
+    // index of the last node which takes each variable as its input
+    std::unordered_map<std::string, int>
+    make_last_use_index_table(std::vector<node> const& node_list);
+
     class graph {
     public:
         graph() = default;
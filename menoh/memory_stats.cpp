@@ -0,0 +1,40 @@
+#include <menoh/memory_stats.hpp>
+
+namespace menoh_impl {
+
+    void memory_stats::add(std::string const& name, memory_category category,
+                           void const* data, std::size_t bytes) {
+        if(!data || !counted_data_set_.insert(data).second) {
+            return;
+        }
+        entry_list_.push_back(entry{name, category, bytes});
+    }
+
+    void memory_stats::add(std::string const& name, memory_category category,
+                           array const& arr) {
+        if(!arr.has_ownership()) {
+            return;
+        }
+        add(name, category, arr.data(),
+            total_size(arr) * get_size_in_bytes(arr.dtype()));
+    }
+
+    std::size_t memory_stats::total_bytes(memory_category category) const {
+        std::size_t bytes = 0;
+        for(auto const& e : entry_list_) {
+            if(e.category == category) {
+                bytes += e.bytes;
+            }
+        }
+        return bytes;
+    }
+
+    std::size_t memory_stats::total_bytes() const {
+        std::size_t bytes = 0;
+        for(auto const& e : entry_list_) {
+            bytes += e.bytes;
+        }
+        return bytes;
+    }
+
+} // namespace menoh_impl
@@ -0,0 +1,58 @@
+#ifndef MENOH_MEMORY_STATS_HPP
+#define MENOH_MEMORY_STATS_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <menoh/array.hpp>
+
+namespace menoh_impl {
+
+    enum class memory_category {
+        parameter,     // parameters of the model as given
+        packed_weight, // parameters reordered or quantized by backends
+        activation,    // variables computed by the model
+        scratch,       // temporary memory of primitives
+        io             // input and output buffers allocated by menoh
+    };
+
+    // Memory held by a model. Each block of memory is counted once, as the
+    // category with which it is added first, so the owner of memory which
+    // is shared (e.g. inputs which are also read by backends) should add it
+    // first
+    class memory_stats {
+    public:
+        struct entry {
+            std::string name; // variable name, empty if unknown
+            memory_category category;
+            std::size_t bytes;
+        };
+
+        // ignored when `data` is already counted
+        void add(std::string const& name, memory_category category,
+                 void const* data, std::size_t bytes);
+
+        // ignored when `arr` does not own its data (e.g. external buffers
+        // and views)
+        void add(std::string const& name, memory_category category,
+                 array const& arr);
+
+        // memory not held by the model (e.g. external buffers) is never
+        // counted
+        void exclude(void const* data) { counted_data_set_.insert(data); }
+
+        std::size_t total_bytes(memory_category category) const;
+        std::size_t total_bytes() const;
+
+        std::vector<entry> const& entry_list() const { return entry_list_; }
+
+    private:
+        std::unordered_set<void const*> counted_data_set_;
+        std::vector<entry> entry_list_;
+    };
+
+} // namespace menoh_impl
+
+#endif // MENOH_MEMORY_STATS_HPP
@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iterator>
 #include <new>
 #include <stdexcept>
@@ -12,11 +15,16 @@
 
 #include <menoh/array.hpp>
 #include <menoh/attribute_completion_and_shape_inference.hpp>
+#include <menoh/calibration_table.hpp>
+#include <menoh/cost_estimation.hpp>
 #include <menoh/exception.hpp>
 #include <menoh/model_core.hpp>
 #include <menoh/model_core_factory.hpp>
 #include <menoh/model_data.hpp>
+#include <menoh/multi_stream.hpp>
 #include <menoh/onnx.hpp>
+#include <menoh/profiler.hpp>
+#include <menoh/session.hpp>
 #include <menoh/utility.hpp>
 
 namespace menoh_impl {
@@ -108,6 +116,7 @@ menoh_error_code MENOH_API menoh_dtype_size(menoh_dtype dtype,
         MENOH_DTYPE_SIZE_CASE(menoh_dtype_int16)
         MENOH_DTYPE_SIZE_CASE(menoh_dtype_int32)
         MENOH_DTYPE_SIZE_CASE(menoh_dtype_int64)
+        MENOH_DTYPE_SIZE_CASE(menoh_dtype_bfloat16)
 #undef MENOH_DTYPE_SIZE_CASE
         default:
             std::string msg("unknown dtype: " + std::to_string(dtype));
@@ -245,6 +254,14 @@ menoh_model_data_add_attribute_floats_to_current_node(
       model_data, attribute_name, size, value);
 }
 
+menoh_error_code MENOH_API
+menoh_model_data_add_attribute_string_to_current_node(
+  menoh_model_data_handle model_data, const char* attribute_name,
+  const char* value) {
+    return menoh_model_data_add_attribute_scalar_to_current_node(
+      model_data, attribute_name, std::string(value));
+}
+
 menoh_error_code MENOH_API menoh_model_data_add_parameter(
   menoh_model_data* model_data, const char* parameter_name, menoh_dtype dtype,
   int32_t dims_size, const int32_t* dims, void* buffer_handle) {
@@ -545,18 +562,25 @@ menoh_error_code menoh_model_builder_attach_external_buffer(
  * model
  */
 struct menoh_model {
-    std::unordered_map<std::string, menoh_impl::array> input_table;
-    std::unordered_map<std::string, menoh_impl::array> output_table;
-    std::unique_ptr<menoh_impl::model_core> model_core;
+    // the first stream is the one run by menoh_model_run()
+    std::vector<menoh_impl::model_stream> stream_list;
+
+    // shared by cores of all streams while profiling
+    std::shared_ptr<menoh_impl::profiler> profiler;
+
+    // workers of streams kept across menoh_model_run_batches() calls.
+    // Made on the first call
+    std::unique_ptr<menoh_impl::stream_worker_pool> worker_pool;
 };
 
-/* You can (and should) delete model_data after the model creation. */
-menoh_error_code menoh_build_model(const menoh_model_builder_handle builder,
-                                   const menoh_model_data_handle model_data,
-                                   const char* backend_name,
-                                   const char* backend_config,
-                                   menoh_model_handle* dst_model_handle) {
-    return check_error([&]() {
+namespace impl {
+    // streams of the model. The first one uses buffers attached to the
+    // builder
+    std::vector<menoh_impl::model_stream>
+    make_model_stream_list(const menoh_model_builder_handle builder,
+                           const menoh_model_data_handle model_data,
+                           const char* backend_name,
+                           const char* backend_config) {
         std::unordered_map<std::string, menoh_impl::array> input_table;
         for(auto p : builder->input_profile_table) {
             std::string name;
@@ -592,14 +616,46 @@ menoh_error_code menoh_build_model(const menoh_model_builder_handle builder,
             }
         }
 
-        *dst_model_handle =
-          std::make_unique<menoh_model>(
-            menoh_model{input_table, required_output_table,
-                        menoh_impl::make_model_core(
-                          input_table, required_output_table,
-                          builder->output_profile_table, model_data->model_data,
-                          backend_name, backend_config)})
-            .release();
+        auto stream_num = menoh_impl::parse_stream_num(backend_config);
+        std::vector<menoh_impl::model_stream> stream_list;
+        if(stream_num == 1) {
+            stream_list.push_back(menoh_impl::model_stream{
+              input_table, required_output_table,
+              menoh_impl::make_model_core(
+                input_table, required_output_table,
+                builder->output_profile_table, model_data->model_data,
+                backend_name, backend_config)});
+        } else {
+            stream_list = menoh_impl::make_model_stream_list(
+              input_table, required_output_table,
+              builder->output_profile_table, model_data->model_data,
+              backend_name, backend_config, stream_num);
+        }
+        return stream_list;
+    }
+} // namespace impl
+
+/* You can (and should) delete model_data after the model creation. */
+menoh_error_code menoh_build_model(const menoh_model_builder_handle builder,
+                                   const menoh_model_data_handle model_data,
+                                   const char* backend_name,
+                                   const char* backend_config,
+                                   menoh_model_handle* dst_model_handle) {
+    return check_error([&]() {
+        auto model = std::make_unique<menoh_model>(
+          menoh_model{impl::make_model_stream_list(
+                        builder, model_data, backend_name, backend_config),
+                      nullptr, nullptr});
+
+        // profilers made by "profiling" of backend config are replaced
+        // with one shared by all streams
+        if(model->stream_list.front().core->get_profiler()) {
+            model->profiler = std::make_shared<menoh_impl::profiler>();
+            for(auto const& stream : model->stream_list) {
+                stream.core->set_profiler(model->profiler);
+            }
+        }
+        *dst_model_handle = model.release();
         return menoh_error_code_success;
     });
 }
@@ -611,14 +667,24 @@ namespace impl {
     template <typename F>
     menoh_error_code
     menoh_model_get_variable_variable_attribute(const menoh_model_handle model,
+                                                int32_t stream_index,
                                                 const char* name, F f) {
         return check_error([&]() {
-            auto outiter = model->output_table.find(name);
-            if(outiter != model->output_table.end()) {
+            if(stream_index < 0 ||
+               model->stream_list.size() <=
+                 static_cast<std::size_t>(stream_index)) {
+                auto message = "menoh stream index out of range: " +
+                               std::to_string(stream_index);
+                menoh_impl::set_last_error_message(message.c_str());
+                return menoh_error_code_index_out_of_range;
+            }
+            auto const& stream = model->stream_list.at(stream_index);
+            auto outiter = stream.output_table.find(name);
+            if(outiter != stream.output_table.end()) {
                 f(outiter->second);
             } else {
-                auto initer = model->input_table.find(name);
-                if(initer != model->input_table.end()) {
+                auto initer = stream.input_table.find(name);
+                if(initer != stream.input_table.end()) {
                     f(initer->second);
                 } else {
                     auto message =
@@ -635,7 +701,7 @@ namespace impl {
 menoh_error_code menoh_model_get_variable_buffer_handle(
   const menoh_model_handle model, const char* variable_name, void** data_p) {
     return impl::menoh_model_get_variable_variable_attribute(
-      model, variable_name,
+      model, 0, variable_name,
       [&](menoh_impl::array const& arr) { *data_p = arr.data(); });
 }
 
@@ -643,7 +709,7 @@ menoh_error_code menoh_model_get_variable_dtype(const menoh_model_handle model,
                                                 const char* variable_name,
                                                 menoh_dtype* dst_dtype) {
     return impl::menoh_model_get_variable_variable_attribute(
-      model, variable_name, [&](menoh_impl::array const& arr) {
+      model, 0, variable_name, [&](menoh_impl::array const& arr) {
           *dst_dtype = static_cast<menoh_dtype>(arr.dtype());
       });
 }
@@ -653,7 +719,7 @@ menoh_model_get_variable_dims_size(const menoh_model_handle model,
                                    const char* variable_name,
                                    int32_t* dst_size) {
     return impl::menoh_model_get_variable_variable_attribute(
-      model, variable_name, [&](menoh_impl::array const& arr) {
+      model, 0, variable_name, [&](menoh_impl::array const& arr) {
           *dst_size = static_cast<int32_t>(arr.dims().size());
       });
 }
@@ -663,7 +729,7 @@ menoh_model_get_variable_dims_at(const menoh_model_handle model,
                                  const char* variable_name, int32_t index,
                                  int32_t* dst_size) {
     return impl::menoh_model_get_variable_variable_attribute(
-      model, variable_name,
+      model, 0, variable_name,
       [&](menoh_impl::array const& arr) { *dst_size = arr.dims().at(index); });
 }
 
@@ -672,7 +738,7 @@ menoh_error_code menoh_model_get_variable_dims(const menoh_model_handle model,
                                                int32_t* dst_size,
                                                const int32_t** dims) {
     return impl::menoh_model_get_variable_variable_attribute(
-      model, variable_name, [&](menoh_impl::array const& arr) {
+      model, 0, variable_name, [&](menoh_impl::array const& arr) {
           *dst_size = arr.dims().size();
           *dims = arr.dims().data();
       });
@@ -680,7 +746,594 @@ menoh_error_code menoh_model_get_variable_dims(const menoh_model_handle model,
 
 menoh_error_code menoh_model_run(menoh_model_handle model) {
     return check_error([&]() {
-        model->model_core->run();
+        model->stream_list.front().core->run();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_model_warmup(menoh_model_handle model,
+                                    int32_t iteration_num) {
+    return check_error([&]() {
+        menoh_impl::warm_up(model->stream_list, iteration_num);
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_model_enable_profiling(menoh_model_handle model) {
+    return check_error([&]() {
+        model->profiler = std::make_shared<menoh_impl::profiler>();
+        for(auto const& stream : model->stream_list) {
+            stream.core->set_profiler(model->profiler);
+        }
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_model_disable_profiling(menoh_model_handle model) {
+    return check_error([&]() {
+        for(auto const& stream : model->stream_list) {
+            stream.core->set_profiler(nullptr);
+        }
+        return menoh_error_code_success;
+    });
+}
+
+namespace impl {
+    template <typename F>
+    menoh_error_code save_profile(const menoh_model_handle model,
+                                  const char* filename, F to_string) {
+        return check_error([&]() {
+            // a model never profiled has no events
+            menoh_impl::profiler empty_profiler;
+            std::ofstream ofs(filename);
+            if(!ofs) {
+                throw menoh_impl::invalid_filename(filename);
+            }
+            ofs << to_string(model->profiler ? *model->profiler
+                                             : empty_profiler);
+            return menoh_error_code_success;
+        });
+    }
+} // namespace impl
+
+menoh_error_code menoh_model_save_profile_trace(const menoh_model_handle model,
+                                                const char* filename) {
+    return impl::save_profile(
+      model, filename,
+      [](menoh_impl::profiler const& p) { return p.to_chrome_trace(); });
+}
+
+menoh_error_code
+menoh_model_save_profile_summary(const menoh_model_handle model,
+                                 const char* filename) {
+    return impl::save_profile(
+      model, filename,
+      [](menoh_impl::profiler const& p) { return p.to_op_type_summary(); });
+}
+
+/*
+ * memory_stats
+ */
+struct menoh_memory_stats {
+    menoh_impl::memory_stats stats;
+};
+
+menoh_error_code
+menoh_model_get_memory_stats(const menoh_model_handle model,
+                             menoh_memory_stats_handle* dst_handle) {
+    return check_error([&]() {
+        auto stats = std::make_unique<menoh_memory_stats>();
+
+        // buffers of streams are added before cores read them
+        for(auto const& stream : model->stream_list) {
+            for(auto table : {&stream.input_table, &stream.output_table}) {
+                for(auto const& p : *table) {
+                    if(p.second.has_ownership()) {
+                        stats->stats.add(
+                          p.first, menoh_impl::memory_category::io, p.second);
+                    } else {
+                        stats->stats.exclude(p.second.data());
+                    }
+                }
+            }
+        }
+        for(auto const& stream : model->stream_list) {
+            stream.core->collect_memory_stats(stats->stats);
+        }
+        *dst_handle = stats.release();
+        return menoh_error_code_success;
+    });
+}
+void menoh_delete_memory_stats(menoh_memory_stats_handle stats) {
+    delete stats;
+}
+
+namespace impl {
+    bool is_valid_memory_category(menoh_memory_category category) {
+        return menoh_memory_category_parameter <= category &&
+               category <= menoh_memory_category_io;
+    }
+} // namespace impl
+
+menoh_error_code
+menoh_memory_stats_get_bytes(const menoh_memory_stats_handle stats,
+                             menoh_memory_category category,
+                             int64_t* dst_bytes) {
+    return check_error([&]() {
+        if(!impl::is_valid_memory_category(category)) {
+            auto message =
+              "menoh invalid memory category: " + std::to_string(category);
+            menoh_impl::set_last_error_message(message.c_str());
+            return menoh_error_code_index_out_of_range;
+        }
+        *dst_bytes = static_cast<int64_t>(stats->stats.total_bytes(
+          static_cast<menoh_impl::memory_category>(category)));
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_memory_stats_get_total_bytes(const menoh_memory_stats_handle stats,
+                                   int64_t* dst_bytes) {
+    return check_error([&]() {
+        *dst_bytes = static_cast<int64_t>(stats->stats.total_bytes());
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_memory_stats_get_entry_num(const menoh_memory_stats_handle stats,
+                                 int32_t* dst_num) {
+    return check_error([&]() {
+        *dst_num = static_cast<int32_t>(stats->stats.entry_list().size());
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_memory_stats_get_entry(
+  const menoh_memory_stats_handle stats, int32_t index, const char** dst_name,
+  menoh_memory_category* dst_category, int64_t* dst_bytes) {
+    return check_error([&]() {
+        auto const& entry_list = stats->stats.entry_list();
+        if(index < 0 || entry_list.size() <= static_cast<std::size_t>(index)) {
+            auto message =
+              "menoh entry index out of range: " + std::to_string(index);
+            menoh_impl::set_last_error_message(message.c_str());
+            return menoh_error_code_index_out_of_range;
+        }
+        auto const& e = entry_list.at(index);
+        *dst_name = e.name.c_str();
+        *dst_category = static_cast<menoh_memory_category>(e.category);
+        *dst_bytes = static_cast<int64_t>(e.bytes);
+        return menoh_error_code_success;
+    });
+}
+
+/*
+ * model_cost_table
+ */
+struct menoh_model_cost_table {
+    std::vector<menoh_impl::node_cost> cost_list;
+    menoh_impl::node_cost total;
+};
+
+menoh_error_code menoh_make_model_cost_table(
+  const menoh_model_data_handle model_data,
+  const menoh_variable_profile_table_handle variable_profile_table,
+  menoh_model_cost_table_handle* dst_handle) {
+    return check_error([&]() {
+        auto cost_list = menoh_impl::estimate_node_cost_list(
+          model_data->model_data,
+          variable_profile_table->output_profile_table);
+        auto total = menoh_impl::total_cost(cost_list);
+        *dst_handle = std::make_unique<menoh_model_cost_table>(
+                        menoh_model_cost_table{std::move(cost_list),
+                                               std::move(total)})
+                        .release();
+        return menoh_error_code_success;
+    });
+}
+void menoh_delete_model_cost_table(menoh_model_cost_table_handle table) {
+    delete table;
+}
+
+menoh_error_code
+menoh_model_cost_table_get_node_num(const menoh_model_cost_table_handle table,
+                                    int32_t* dst_num) {
+    return check_error([&]() {
+        *dst_num = static_cast<int32_t>(table->cost_list.size());
+        return menoh_error_code_success;
+    });
+}
+
+namespace impl {
+    template <typename F>
+    menoh_error_code
+    menoh_model_cost_table_get_node_attribute(
+      const menoh_model_cost_table_handle table, int32_t index, F f) {
+        return check_error([&]() -> menoh_error_code {
+            if(index < 0 ||
+               table->cost_list.size() <= static_cast<std::size_t>(index)) {
+                auto message =
+                  "menoh node index out of range: " + std::to_string(index);
+                menoh_impl::set_last_error_message(message.c_str());
+                return menoh_error_code_index_out_of_range;
+            }
+            return f(table->cost_list.at(index));
+        });
+    }
+
+    menoh_error_code get_cost_metric(menoh_impl::node_cost const& cost,
+                                     menoh_cost_metric metric,
+                                     int64_t* dst_value) {
+        switch(metric) {
+            case menoh_cost_metric_flops:
+                *dst_value = cost.flop_num;
+                break;
+            case menoh_cost_metric_parameter_bytes:
+                *dst_value = cost.parameter_bytes;
+                break;
+            case menoh_cost_metric_activation_read_bytes:
+                *dst_value = cost.activation_read_bytes;
+                break;
+            case menoh_cost_metric_activation_written_bytes:
+                *dst_value = cost.activation_written_bytes;
+                break;
+            default: {
+                auto message =
+                  "menoh invalid cost metric: " + std::to_string(metric);
+                menoh_impl::set_last_error_message(message.c_str());
+                return menoh_error_code_index_out_of_range;
+            }
+        }
+        return menoh_error_code_success;
+    }
+} // namespace impl
+
+menoh_error_code
+menoh_model_cost_table_get_node_name(const menoh_model_cost_table_handle table,
+                                     int32_t index, const char** dst_name) {
+    return impl::menoh_model_cost_table_get_node_attribute(
+      table, index, [&](menoh_impl::node_cost const& cost) {
+          *dst_name = cost.name.c_str();
+          return menoh_error_code_success;
+      });
+}
+
+menoh_error_code menoh_model_cost_table_get_node_op_type(
+  const menoh_model_cost_table_handle table, int32_t index,
+  const char** dst_op_type) {
+    return impl::menoh_model_cost_table_get_node_attribute(
+      table, index, [&](menoh_impl::node_cost const& cost) {
+          *dst_op_type = cost.op_type.c_str();
+          return menoh_error_code_success;
+      });
+}
+
+menoh_error_code
+menoh_model_cost_table_get_node_cost(const menoh_model_cost_table_handle table,
+                                     int32_t index, menoh_cost_metric metric,
+                                     int64_t* dst_value) {
+    return impl::menoh_model_cost_table_get_node_attribute(
+      table, index, [&](menoh_impl::node_cost const& cost) {
+          return impl::get_cost_metric(cost, metric, dst_value);
+      });
+}
+
+menoh_error_code
+menoh_model_cost_table_get_total_cost(const menoh_model_cost_table_handle table,
+                                      menoh_cost_metric metric,
+                                      int64_t* dst_value) {
+    return check_error([&]() {
+        return impl::get_cost_metric(table->total, metric, dst_value);
+    });
+}
+
+menoh_error_code
+menoh_model_cost_table_save(const menoh_model_cost_table_handle table,
+                            const char* filename) {
+    return check_error([&]() {
+        std::ofstream ofs(filename);
+        if(!ofs) {
+            throw menoh_impl::invalid_filename(filename);
+        }
+        ofs << menoh_impl::to_cost_table_string(table->cost_list);
+        return menoh_error_code_success;
+    });
+}
+
+/*
+ * cancellation_token
+ */
+struct menoh_cancellation_token {
+    std::atomic<bool> is_cancelled{false};
+};
+
+menoh_error_code
+menoh_make_cancellation_token(menoh_cancellation_token_handle* dst_handle) {
+    return check_error([&]() {
+        *dst_handle = std::make_unique<menoh_cancellation_token>().release();
+        return menoh_error_code_success;
+    });
+}
+void menoh_delete_cancellation_token(menoh_cancellation_token_handle token) {
+    delete token;
+}
+
+menoh_error_code
+menoh_cancellation_token_cancel(menoh_cancellation_token_handle token) {
+    return check_error([&]() {
+        token->is_cancelled = true;
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_cancellation_token_reset(menoh_cancellation_token_handle token) {
+    return check_error([&]() {
+        token->is_cancelled = false;
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_model_run_with_deadline(menoh_model_handle model,
+                              int64_t timeout_in_microseconds,
+                              const menoh_cancellation_token_handle token) {
+    return check_error([&]() {
+        menoh_impl::optional<std::chrono::steady_clock::time_point> deadline;
+        if(0 <= timeout_in_microseconds) {
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::microseconds(timeout_in_microseconds);
+        }
+        model->stream_list.front().core->run(menoh_impl::run_control(
+          deadline, token ? &token->is_cancelled : nullptr));
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_model_get_stream_num(const menoh_model_handle model,
+                                            int32_t* dst_stream_num) {
+    return check_error([&]() {
+        *dst_stream_num = static_cast<int32_t>(model->stream_list.size());
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_model_get_stream_variable_buffer_handle(
+  const menoh_model_handle model, int32_t stream_index,
+  const char* variable_name, void** data_p) {
+    return impl::menoh_model_get_variable_variable_attribute(
+      model, stream_index, variable_name,
+      [&](menoh_impl::array const& arr) { *data_p = arr.data(); });
+}
+
+menoh_error_code menoh_model_run_batches(menoh_model_handle model,
+                                         int32_t batch_num,
+                                         menoh_batch_callback prepare,
+                                         menoh_batch_callback finish,
+                                         void* user_data) {
+    return check_error([&]() {
+        auto to_batch_callback = [user_data](menoh_batch_callback callback) {
+            return callback ? menoh_impl::batch_callback(
+                                [callback, user_data](int batch_index,
+                                                      int stream_index) {
+                                    callback(user_data, batch_index,
+                                             stream_index);
+                                })
+                            : menoh_impl::batch_callback();
+        };
+        if(!model->worker_pool) {
+            model->worker_pool =
+              std::make_unique<menoh_impl::stream_worker_pool>(
+                static_cast<int>(model->stream_list.size()));
+        }
+        menoh_impl::run_batches(model->stream_list, *model->worker_pool,
+                                batch_num, to_batch_callback(prepare),
+                                to_batch_callback(finish));
+        return menoh_error_code_success;
+    });
+}
+
+/*
+ * session
+ */
+struct menoh_session {
+    std::unique_ptr<menoh_impl::session> session;
+};
+
+menoh_error_code menoh_build_session(const menoh_model_builder_handle builder,
+                                     const menoh_model_data_handle model_data,
+                                     const char* backend_name,
+                                     const char* backend_config,
+                                     menoh_session_handle* dst_handle) {
+    return check_error([&]() {
+        auto queue_capacity =
+          menoh_impl::parse_session_queue_capacity(backend_config);
+        auto warmup_iteration_num =
+          menoh_impl::parse_session_warmup_iteration_num(backend_config);
+        *dst_handle = std::make_unique<menoh_session>(
+                        menoh_session{std::make_unique<menoh_impl::session>(
+                          impl::make_model_stream_list(builder, model_data,
+                                                       backend_name,
+                                                       backend_config),
+                          queue_capacity, warmup_iteration_num)})
+                        .release();
+        return menoh_error_code_success;
+    });
+}
+void menoh_delete_session(menoh_session_handle session) {
+    delete session;
+}
+
+menoh_error_code menoh_session_submit(menoh_session_handle session,
+                                      menoh_session_prepare_callback prepare,
+                                      menoh_session_finish_callback finish,
+                                      void* user_data) {
+    return check_error([&]() {
+        menoh_impl::session::request r;
+        if(prepare) {
+            r.prepare = [prepare, user_data](int replica_index) {
+                prepare(user_data, replica_index);
+            };
+        }
+        if(finish) {
+            r.finish = [finish, user_data](int replica_index,
+                                           std::exception_ptr exception) {
+                auto ec = check_error([&]() {
+                    if(exception) {
+                        std::rethrow_exception(exception);
+                    }
+                    return menoh_error_code_success;
+                });
+                finish(user_data, replica_index, ec);
+            };
+        }
+        session->session->submit(std::move(r));
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_session_wait(menoh_session_handle session) {
+    return check_error([&]() {
+        session->session->wait();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_session_get_replica_num(const menoh_session_handle session,
+                              int32_t* dst_replica_num) {
+    return check_error([&]() {
+        *dst_replica_num = session->session->replica_num();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_session_get_variable_buffer_handle(
+  const menoh_session_handle session, int32_t replica_index,
+  const char* variable_name, void** dst_data) {
+    return check_error([&]() {
+        if(replica_index < 0 ||
+           session->session->replica_num() <= replica_index) {
+            auto message = "menoh replica index out of range: " +
+                           std::to_string(replica_index);
+            menoh_impl::set_last_error_message(message.c_str());
+            return menoh_error_code_index_out_of_range;
+        }
+        auto const& replica = session->session->replica(replica_index);
+        for(auto table : {&replica.output_table, &replica.input_table}) {
+            auto found = table->find(variable_name);
+            if(found != table->end()) {
+                *dst_data = found->second.data();
+                return menoh_error_code_success;
+            }
+        }
+        auto message = std::string("menoh variable not found: ") +
+                       variable_name;
+        menoh_impl::set_last_error_message(message.c_str());
+        return menoh_error_code_variable_not_found;
+    });
+}
+
+menoh_error_code
+menoh_session_get_queue_depth(const menoh_session_handle session,
+                              int32_t* dst_queue_depth) {
+    return check_error([&]() {
+        *dst_queue_depth = session->session->queue_depth();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_session_get_completed_request_num(const menoh_session_handle session,
+                                        int64_t* dst_num) {
+    return check_error([&]() {
+        *dst_num = session->session->completed_request_num();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_session_get_utilization(const menoh_session_handle session,
+                              float* dst_utilization) {
+    return check_error([&]() {
+        *dst_utilization =
+          static_cast<float>(session->session->utilization());
+        return menoh_error_code_success;
+    });
+}
+
+/*
+ * calibration_table
+ */
+struct menoh_calibration_table {
+    menoh_impl::calibration_table calibration_table;
+};
+
+menoh_error_code
+menoh_make_calibration_table(menoh_calibration_table_handle* dst_handle) {
+    return check_error([&]() {
+        *dst_handle = std::make_unique<menoh_calibration_table>().release();
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code menoh_make_calibration_table_from_file(
+  const char* filename, menoh_calibration_table_handle* dst_handle) {
+    return check_error([&]() {
+        *dst_handle = std::make_unique<menoh_calibration_table>(
+                        menoh_calibration_table{
+                          menoh_impl::load_calibration_table(filename)})
+                        .release();
+        return menoh_error_code_success;
+    });
+}
+
+void menoh_delete_calibration_table(menoh_calibration_table_handle table) {
+    delete table;
+}
+
+menoh_error_code menoh_variable_profile_table_builder_add_calibration_targets(
+  menoh_variable_profile_table_builder_handle builder,
+  const menoh_model_data_handle model_data) {
+    return check_error([&]() {
+        for(auto const& name :
+            menoh_impl::extract_calibration_target_name_list(
+              model_data->model_data)) {
+            auto found = std::find(builder->required_output_name_list.begin(),
+                                   builder->required_output_name_list.end(),
+                                   name);
+            if(found == builder->required_output_name_list.end()) {
+                builder->required_output_name_list.push_back(name);
+            }
+        }
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_calibration_table_update(menoh_calibration_table_handle table,
+                               const menoh_model_handle model) {
+    return check_error([&]() {
+        auto const& stream = model->stream_list.front();
+        for(auto const& p : stream.input_table) {
+            menoh_impl::update_calibration_table(table->calibration_table,
+                                                 p.first, p.second);
+        }
+        for(auto const& p : stream.output_table) {
+            menoh_impl::update_calibration_table(table->calibration_table,
+                                                 p.first, p.second);
+        }
+        return menoh_error_code_success;
+    });
+}
+
+menoh_error_code
+menoh_calibration_table_save(const menoh_calibration_table_handle table,
+                             const char* filename) {
+    return check_error([&]() {
+        menoh_impl::save_calibration_table(table->calibration_table, filename);
         return menoh_error_code_success;
     });
 }
@@ -51,7 +51,9 @@ namespace menoh_impl {
           std::unordered_map<std::string, primitive_factory>
             primitive_factory_table,
           mkldnn::engine const& engine) {
-            std::vector<mkldnn::primitive> nets;
+            // primitives of each node and what they run for the profiler
+            std::vector<std::vector<mkldnn::primitive>> net_list;
+            std::vector<std::unique_ptr<profile_event_info>> event_info_list;
             std::unordered_map<std::string, mkldnn::memory>
               variable_memory_table;
             for(auto const& name_and_arr_pair : input_table) {
@@ -73,6 +75,7 @@ namespace menoh_impl {
             }
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
             std::set<std::string> variable_name_set;
             std::vector<std::string> output_name_sorted_list;
             {
@@ -103,10 +106,12 @@ namespace menoh_impl {
                       new_output_memory_table;
                     std::vector<mkldnn::memory> new_temp_memory_list;
                     std::vector<array> new_owned_array_list;
+                    std::vector<mkldnn::memory> new_weight_memory_list;
                     if(inplace_primitive_factory_pair_iter !=
                        inplace_primitive_factory_table.end()) {
                         std::tie(net, new_output_memory_table,
-                                 new_temp_memory_list, new_owned_array_list) =
+                                 new_temp_memory_list, new_owned_array_list,
+                                 new_weight_memory_list) =
                           inplace_primitive_factory_pair_iter->second.
                           operator()(node, i, graph.node_list(),
                                      parameter_table, variable_memory_table,
@@ -115,13 +120,52 @@ namespace menoh_impl {
                         assert(primitive_factory_pair_iter !=
                                primitive_factory_table.end());
                         std::tie(net, new_output_memory_table,
-                                 new_temp_memory_list, new_owned_array_list) =
+                                 new_temp_memory_list, new_owned_array_list,
+                                 new_weight_memory_list) =
                           primitive_factory_pair_iter->second.operator()(
                             node, parameter_table, variable_memory_table,
                             output_table, engine);
                     }
 
-                    nets.insert(nets.end(), net.begin(), net.end());
+                    if(!net.empty()) {
+                        // formats are those of memories the node reads and
+                        // writes. They are unknown for parameters, which
+                        // primitives reorder by themselves
+                        auto info = std::make_unique<profile_event_info>();
+                        info->name = node.output_name_list.at(0);
+                        info->op_type = node.op_type;
+                        info->context_name = "mkldnn";
+                        for(auto const& name : node.input_name_list) {
+                            auto found = variable_memory_table.find(name);
+                            if(found != variable_memory_table.end()) {
+                                info->input_dims_list.push_back(
+                                  extract_dims(found->second));
+                                info->input_format_list.push_back(
+                                  extract_format_name(found->second));
+                                continue;
+                            }
+                            auto found_parameter = parameter_table.find(name);
+                            info->input_dims_list.push_back(
+                              found_parameter != parameter_table.end()
+                                ? found_parameter->second.dims()
+                                : std::vector<int>());
+                            info->input_format_list.push_back("");
+                        }
+                        for(auto const& name : node.output_name_list) {
+                            auto found = new_output_memory_table.find(name);
+                            if(found == new_output_memory_table.end()) {
+                                info->output_dims_list.emplace_back();
+                                info->output_format_list.emplace_back();
+                                continue;
+                            }
+                            info->output_dims_list.push_back(
+                              extract_dims(found->second));
+                            info->output_format_list.push_back(
+                              extract_format_name(found->second));
+                        }
+                        net_list.push_back(net);
+                        event_info_list.push_back(std::move(info));
+                    }
                     variable_memory_table.insert(
                       new_output_memory_table.begin(),
                       new_output_memory_table.end());
@@ -131,6 +175,9 @@ namespace menoh_impl {
                     owned_array_list.insert(owned_array_list.end(),
                                             new_owned_array_list.begin(),
                                             new_owned_array_list.end());
+                    weight_memory_list.insert(weight_memory_list.end(),
+                                              new_weight_memory_list.begin(),
+                                              new_weight_memory_list.end());
 
                     // Check weather all required output is emitted
                     std::transform(
@@ -153,8 +200,9 @@ namespace menoh_impl {
                         ", message: " + e.message);
                 }
             }
-            return std::make_tuple(nets, variable_memory_table,
-                                   temp_memory_list, owned_array_list);
+            return std::make_tuple(net_list, std::move(event_info_list),
+                                   variable_memory_table, temp_memory_list,
+                                   owned_array_list, weight_memory_list);
         }
 
         auto
@@ -213,17 +261,65 @@ namespace menoh_impl {
           std::unordered_map<std::string, array> const& output_table,
           menoh_impl::model_data const& model_data,
           mkldnn::engine const& engine)
-          : engine_(engine) {
-            std::tie(nets_, variable_memory_table_, temp_memory_list_,
-                     owned_array_list_) =
+          : engine_(engine),
+            parameter_table_(model_data.parameter_name_and_array_list.begin(),
+                             model_data.parameter_name_and_array_list.end()) {
+            std::vector<std::vector<mkldnn::primitive>> net_list;
+            std::tie(net_list, event_info_list_, variable_memory_table_,
+                     temp_memory_list_, owned_array_list_,
+                     weight_memory_list_) =
               make_nets(input_table, output_table, model_data, engine_);
+            for(auto const& net : net_list) {
+                net_runner_list_.push_back(
+                  std::make_unique<primitive_list_runner>(net));
+            }
         }
 
-        void model_core::do_run() {
+        // Arrays owned by factories are parameters or weights made from
+        // them (e.g. transposed ConvTranspose weights), so they and
+        // weight_memory_list_ are packed weights. Reordered inputs of
+        // primitives in temp_memory_list_ are scratch
+        void model_core::do_collect_memory_stats(memory_stats& stats) const {
+            for(auto const& p : parameter_table_) {
+                stats.add(p.first, memory_category::parameter, p.second);
+            }
+            auto add_memory = [&stats](std::string const& name,
+                                       memory_category category,
+                                       mkldnn::memory const& mem) {
+                stats.add(name, category, mem.get_data_handle(),
+                          mem.get_primitive_desc().get_size());
+            };
+            for(auto const& arr : owned_array_list_) {
+                stats.add("", memory_category::packed_weight, arr);
+            }
+            for(auto const& mem : weight_memory_list_) {
+                add_memory("", memory_category::packed_weight, mem);
+            }
+            for(auto const& p : variable_memory_table_) {
+                add_memory(p.first, memory_category::activation, p.second);
+            }
+            for(auto const& mem : temp_memory_list_) {
+                add_memory("", memory_category::scratch, mem);
+            }
+        }
+
+        void model_core::do_run(run_control const* control) {
+            // each node runs on its own stream so that a controlled run can
+            // stop between nodes and the profiler records each node
             try {
-                mkldnn::stream(mkldnn::stream::kind::eager)
-                  .submit(nets_)
-                  .wait();
+                for(unsigned int i = 0; i < net_runner_list_.size(); ++i) {
+                    if(control) {
+                        control->check();
+                    }
+                    if(profiler_) {
+                        auto start = profiler::clock::now();
+                        net_runner_list_[i]->run();
+                        profiler_->record(*event_info_list_[i], start,
+                                          profiler::clock::now());
+                    } else {
+                        net_runner_list_[i]->run();
+                    }
+                }
             } catch(mkldnn::error const& e) {
                 throw backend_error("mkldnn", std::string("status: ") +
                                                 std::to_string(e.status) +
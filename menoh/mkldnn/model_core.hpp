@@ -1,6 +1,7 @@
 #ifndef MENOH_MKLDNN_MODEL_CORE_HPP
 #define MENOH_MKLDNN_MODEL_CORE_HPP
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,6 +13,8 @@
 #include <menoh/model_core.hpp>
 #include <menoh/model_data.hpp>
 
+#include <menoh/mkldnn/utility.hpp>
+
 namespace menoh_impl {
     namespace mkldnn_backend {
 
@@ -24,14 +27,33 @@ namespace menoh_impl {
               menoh_impl::model_data const& model_data, mkldnn::engine const& engine);
 
         private:
-            virtual void do_run() override;
+            virtual void do_run(run_control const* control) override;
+            virtual void do_set_profiler(
+              std::shared_ptr<profiler> const& profiler) override {
+                profiler_ = profiler;
+            }
+            virtual std::shared_ptr<profiler> do_get_profiler() const override {
+                return profiler_;
+            }
+            virtual void
+            do_collect_memory_stats(memory_stats& stats) const override;
 
             mkldnn::engine engine_;
-            std::vector<mkldnn::primitive> nets_;
+            // a runner for primitives of each node
+            std::vector<std::unique_ptr<primitive_list_runner>>
+              net_runner_list_;
             std::unordered_map<std::string, mkldnn::memory>
               variable_memory_table_;
             std::vector<mkldnn::memory> temp_memory_list_;
             std::vector<array> owned_array_list_;
+            std::vector<mkldnn::memory> weight_memory_list_;
+
+            // kept because memories of parameters refer to them
+            std::unordered_map<std::string, array> parameter_table_;
+
+            // what each runner runs
+            std::vector<std::unique_ptr<profile_event_info>> event_info_list_;
+            std::shared_ptr<profiler> profiler_;
         };
 
         model_core make_model_core(
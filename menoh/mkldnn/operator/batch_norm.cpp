@@ -24,6 +24,7 @@ namespace menoh_impl {
             std::unordered_map<std::string, array> output_table;
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
 
             auto epsilon = optional_attribute_float(node, "epsilon", 1e-5f);
             auto spatial =
@@ -55,7 +56,7 @@ namespace menoh_impl {
             std::copy(fbegin(b_arr), fend(b_arr),
                       static_cast<float*>(weights_memory.get_data_handle()) +
                         total_size(scale_arr));
-            temp_memory_list.push_back(weights_memory);
+            weight_memory_list.push_back(weights_memory);
 
             auto mean_memory = array_to_memory_and_deal_ownership(
               find_value(parameter_table, node.input_name_list.at(3)),
@@ -108,7 +109,7 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list, weight_memory_list);
         }
 
     } // namespace mkldnn_backend
@@ -23,6 +23,7 @@ namespace menoh_impl {
             std::unordered_map<std::string, mkldnn::memory> output_memory_table;
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
 
             std::vector<int> strides, kernel_shape, pads;
             std::tie(strides, kernel_shape, pads) =
@@ -32,15 +33,31 @@ namespace menoh_impl {
 
             auto const& input_memory =
               find_value(variable_memory_table, node.input_name_list.at(0));
-            auto weight_memory = array_to_memory_and_deal_ownership(
-              find_value(parameter_table, node.input_name_list.at(1)),
-              mkldnn::memory::format::oihw, engine, temp_memory_list,
-              owned_array_list);
+
+            // grouped (and depthwise) convolution takes 5-D weight
+            // (g, oc/g, ic, kh, kw) in goihw format
+            auto group = optional_attribute_int(node, "group", 1);
+            auto const& weight_arr =
+              find_value(parameter_table, node.input_name_list.at(1));
+            auto output_channel_num = weight_arr.dims().at(0);
+            auto weight_memory =
+              group == 1
+                ? array_to_memory_and_deal_ownership(
+                    weight_arr, mkldnn::memory::format::oihw, engine,
+                    temp_memory_list, owned_array_list)
+                : array_to_memory_and_deal_ownership(
+                    weight_arr,
+                    {group, output_channel_num / group,
+                     weight_arr.dims().at(1), weight_arr.dims().at(2),
+                     weight_arr.dims().at(3)},
+                    mkldnn::memory::format::goihw, engine, temp_memory_list,
+                    owned_array_list);
 
             auto input_dims = extract_dims(input_memory);
             auto weight_dims = extract_dims(weight_memory);
-            auto output_dims = calc_2d_output_dims(input_dims, weight_dims[0],
-                                                   kernel_shape, strides, pads);
+            auto output_dims =
+              calc_2d_output_dims(input_dims, output_channel_num,
+                                  kernel_shape, strides, pads);
 
             auto const& output_name = node.output_name_list.at(0);
 
@@ -93,7 +110,7 @@ namespace menoh_impl {
                weight_memory.get_primitive_desc()) {
                 conv_weight_memory =
                   mkldnn::memory(conv_pd.weights_primitive_desc());
-                temp_memory_list.push_back(conv_weight_memory);
+                weight_memory_list.push_back(conv_weight_memory);
                 net.push_back(
                   mkldnn::reorder(weight_memory, conv_weight_memory));
             }
@@ -116,7 +133,7 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list, weight_memory_list);
         }
 
     } // namespace mkldnn_backend
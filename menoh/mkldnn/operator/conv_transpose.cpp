@@ -1,7 +1,9 @@
 #include <menoh/mkldnn/operator/conv_transpose.hpp>
 
+#include <algorithm>
 #include <tuple>
 
+#include <menoh/model_core.hpp>
 #include <menoh/optional.hpp>
 #include <menoh/utility.hpp>
 
@@ -23,47 +25,69 @@ namespace menoh_impl {
             std::unordered_map<std::string, mkldnn::memory> output_memory_table;
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
+
+            auto dilations =
+              optional_attribute_ints(node, "dilations", {1, 1});
+            if(!std::all_of(dilations.begin(), dilations.end(),
+                            [](int e) { return e == 1; })) {
+                throw failed_to_configure_operator(
+                  node.op_type, node.output_name_list.at(0),
+                  "dilations of ConvTranspose must be 1");
+            }
 
             std::vector<int> strides, kernel_shape, pads;
             std::tie(strides, kernel_shape, pads) =
               attributes_for_2d_data_processing(node);
 
-            std::vector<int> padding_l{pads[0], pads[1]};
-            std::vector<int> padding_r{pads[2], pads[3]};
-
             auto const& input_memory =
               find_value(variable_memory_table, node.input_name_list.at(0));
+            auto input_dims = extract_dims(input_memory);
+
+            // ONNX weight is (C_in, C_out/g, kh, kw), i.e.
+            // (g, C_in/g, C_out/g, kh, kw). It is transposed to mkldnn
+            // weight (g, C_out/g, C_in/g, kh, kw), which is 4-D oihw when
+            // group is 1
+            auto group = optional_attribute_int(node, "group", 1);
             auto weight_arr =
               find_value(parameter_table, node.input_name_list.at(1));
-            auto weight_tr_dims = weight_arr.dims();
-            std::swap(weight_tr_dims[0], weight_tr_dims[1]);
-            menoh_impl::array weight_tr_arr(weight_arr.dtype(), weight_tr_dims);
             assert(weight_arr.dtype() == dtype_t::float_);
-            for(int o = 0; o < weight_arr.dims()[0]; ++o) {
-                for(int i = 0; i < weight_arr.dims()[1]; ++i) {
-                    for(int h = 0; h < weight_arr.dims()[2]; ++h) {
-                        for(int w = 0; w < weight_arr.dims()[3]; ++w) {
-                            auto weight_i =
-                              o * weight_arr.dims()[1] * weight_arr.dims()[2] *
-                                weight_arr.dims()[3] +
-                              i * weight_arr.dims()[2] * weight_arr.dims()[3] +
-                              h * weight_arr.dims()[3] + w;
-                            auto weight_tr_i =
-                              i * weight_arr.dims()[0] * weight_arr.dims()[2] *
-                                weight_arr.dims()[3] +
-                              o * weight_arr.dims()[2] * weight_arr.dims()[3] +
-                              h * weight_arr.dims()[3] + w;
-                            *(static_cast<float*>(weight_tr_arr.data()) +
-                              weight_tr_i) =
-                              *(static_cast<float*>(weight_arr.data()) +
-                                weight_i);
-                        }
+            auto const& onnx_weight_dims = weight_arr.dims();
+            int group_input_channel_num = onnx_weight_dims.at(0) / group;
+            int group_output_channel_num = onnx_weight_dims.at(1);
+            int kernel_size = onnx_weight_dims.at(2) * onnx_weight_dims.at(3);
+            std::vector<int> weight_tr_dims{
+              group, group_output_channel_num, group_input_channel_num,
+              onnx_weight_dims.at(2), onnx_weight_dims.at(3)};
+            if(group == 1) {
+                weight_tr_dims.erase(weight_tr_dims.begin());
+            }
+            menoh_impl::array weight_tr_arr(weight_arr.dtype(), weight_tr_dims);
+            auto weight_data = static_cast<float const*>(weight_arr.data());
+            auto weight_tr_data = static_cast<float*>(weight_tr_arr.data());
+            for(int g = 0; g < group; ++g) {
+                for(int i = 0; i < group_input_channel_num; ++i) {
+                    for(int o = 0; o < group_output_channel_num; ++o) {
+                        auto first =
+                          weight_data +
+                          ((g * group_input_channel_num + i) *
+                             group_output_channel_num +
+                           o) *
+                            kernel_size;
+                        std::copy(first, first + kernel_size,
+                                  weight_tr_data +
+                                    ((g * group_output_channel_num + o) *
+                                       group_input_channel_num +
+                                     i) *
+                                      kernel_size);
                     }
                 }
             }
             auto weight_memory = array_to_memory_and_deal_ownership(
-              weight_tr_arr, mkldnn::memory::format::oihw, engine,
-              temp_memory_list, owned_array_list);
+              weight_tr_arr,
+              group == 1 ? mkldnn::memory::format::oihw
+                         : mkldnn::memory::format::goihw,
+              engine, temp_memory_list, owned_array_list);
 
             menoh_impl::optional<mkldnn::memory> bias_memory_opt;
             if(node.input_name_list.size() == 3) {
@@ -73,10 +97,20 @@ namespace menoh_impl {
                   owned_array_list);
             }
 
-            auto input_dims = extract_dims(input_memory);
+            // output_padding is added to the end side, same as shape
+            // inference
             auto weight_dims = extract_dims(weight_memory);
             auto output_dims = calc_2d_output_dims_for_conv_transpose(
-              input_dims, weight_dims[0], kernel_shape, strides, pads);
+              input_dims, group * group_output_channel_num, kernel_shape,
+              strides, pads);
+            auto output_padding =
+              optional_attribute_ints(node, "output_padding", {0, 0});
+            std::vector<int> padding_l{pads[0], pads[1]};
+            std::vector<int> padding_r{pads[2], pads[3]};
+            for(int i = 0; i < 2; ++i) {
+                output_dims.at(2 + i) += output_padding.at(i);
+                padding_r.at(i) -= output_padding.at(i);
+            }
 
             auto const& output_name = node.output_name_list.at(0);
 
@@ -125,7 +159,7 @@ namespace menoh_impl {
                weight_memory.get_primitive_desc()) {
                 deconv_weight_memory =
                   mkldnn::memory(deconv_pd.weights_primitive_desc());
-                temp_memory_list.push_back(deconv_weight_memory);
+                weight_memory_list.push_back(deconv_weight_memory);
                 net.push_back(
                   mkldnn::reorder(weight_memory, deconv_weight_memory));
             }
@@ -148,7 +182,7 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list, weight_memory_list);
         }
 
     } // namespace mkldnn_backend
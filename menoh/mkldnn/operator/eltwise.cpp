@@ -55,7 +55,8 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   std::vector<array>());
+                                   std::vector<array>(),
+                                   std::vector<mkldnn::memory>());
         }
 
         primitive_factory_return_type make_relu_primitive(
@@ -25,6 +25,7 @@ namespace menoh_impl {
             std::unordered_map<std::string, array> output_table;
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
 
             auto axis = optional_attribute_int(node, "axis", 1);
             assert(axis == 1);
@@ -89,7 +90,7 @@ namespace menoh_impl {
                weight_memory.get_primitive_desc()) {
                 fc_weight_memory =
                   mkldnn::memory(fc_pd.weights_primitive_desc());
-                temp_memory_list.push_back(fc_weight_memory);
+                weight_memory_list.push_back(fc_weight_memory);
                 net.push_back(mkldnn::reorder(weight_memory, fc_weight_memory));
             }
 
@@ -110,7 +111,7 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list, weight_memory_list);
         }
 
     } // namespace mkldnn_backend
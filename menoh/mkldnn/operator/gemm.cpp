@@ -26,6 +26,7 @@ namespace menoh_impl {
             std::unordered_map<std::string, array> output_table;
             std::vector<mkldnn::memory> temp_memory_list;
             std::vector<array> owned_array_list;
+            std::vector<mkldnn::memory> weight_memory_list;
 
             auto alpha = optional_attribute_float(node, "alpha", 1.f);
             if(alpha != 1) {
@@ -124,7 +125,7 @@ namespace menoh_impl {
                weight_memory.get_primitive_desc()) {
                 gemm_weight_memory =
                   mkldnn::memory(gemm_pd.weights_primitive_desc());
-                temp_memory_list.push_back(gemm_weight_memory);
+                weight_memory_list.push_back(gemm_weight_memory);
                 net.push_back(
                   mkldnn::reorder(weight_memory, gemm_weight_memory));
             }
@@ -146,7 +147,7 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list, weight_memory_list);
         }
 
     } // namespace mkldnn_backend
@@ -63,7 +63,8 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   owned_array_list);
+                                   owned_array_list,
+                                   std::vector<mkldnn::memory>());
         }
 
     } // namespace mkldnn_backend
@@ -71,7 +71,8 @@ namespace menoh_impl {
               });
 
             return std::make_tuple(net, output_memory_table, temp_memory_list,
-                                   std::vector<array>());
+                                   std::vector<array>(),
+                                   std::vector<mkldnn::memory>());
         }
 
         template <mkldnn::algorithm pooling_alg>
@@ -17,7 +17,8 @@ namespace menoh_impl {
                      std::unordered_map<std::string,
                                         mkldnn::memory>, // output_memory_table
                      std::vector<mkldnn::memory>,        // temp_memory_list
-                     std::vector<array>                  // owned_array_list
+                     std::vector<array>,                 // owned_array_list
+                     std::vector<mkldnn::memory>         // weight_memory_list
                      >;
     } // namespace mkldnn_backend
 } // namespace menoh_impl
@@ -73,5 +73,63 @@ namespace menoh_impl {
                          extract_dims(mem), mem.get_data_handle());
         }
 
+        std::string format_to_string(mkldnn::memory::format format) {
+#define MENOH_MKLDNN_FORMAT_CASE(name) \
+    case mkldnn::memory::format::name: \
+        return #name;
+            switch(format) {
+                case mkldnn::memory::format::format_undef:
+                    return "";
+                    MENOH_MKLDNN_FORMAT_CASE(any)
+                    MENOH_MKLDNN_FORMAT_CASE(blocked)
+                    MENOH_MKLDNN_FORMAT_CASE(x)
+                    MENOH_MKLDNN_FORMAT_CASE(nc)
+                    MENOH_MKLDNN_FORMAT_CASE(nchw)
+                    MENOH_MKLDNN_FORMAT_CASE(nhwc)
+                    MENOH_MKLDNN_FORMAT_CASE(chwn)
+                    MENOH_MKLDNN_FORMAT_CASE(nChw8c)
+                    MENOH_MKLDNN_FORMAT_CASE(nChw16c)
+                    MENOH_MKLDNN_FORMAT_CASE(oi)
+                    MENOH_MKLDNN_FORMAT_CASE(io)
+                    MENOH_MKLDNN_FORMAT_CASE(oihw)
+                    MENOH_MKLDNN_FORMAT_CASE(ihwo)
+                    MENOH_MKLDNN_FORMAT_CASE(hwio)
+                    MENOH_MKLDNN_FORMAT_CASE(OIhw8i8o)
+                    MENOH_MKLDNN_FORMAT_CASE(OIhw16i16o)
+                    MENOH_MKLDNN_FORMAT_CASE(OIhw8o8i)
+                    MENOH_MKLDNN_FORMAT_CASE(OIhw16o16i)
+                    MENOH_MKLDNN_FORMAT_CASE(Oihw8o)
+                    MENOH_MKLDNN_FORMAT_CASE(Oihw16o)
+                    MENOH_MKLDNN_FORMAT_CASE(Ohwi8o)
+                    MENOH_MKLDNN_FORMAT_CASE(Ohwi16o)
+                    MENOH_MKLDNN_FORMAT_CASE(goihw)
+                    MENOH_MKLDNN_FORMAT_CASE(gOIhw8i8o)
+                    MENOH_MKLDNN_FORMAT_CASE(gOIhw16i16o)
+                default:
+                    return std::to_string(static_cast<int>(format));
+            }
+#undef MENOH_MKLDNN_FORMAT_CASE
+        }
+
+        std::string extract_format_name(mkldnn::memory const& m) {
+            return format_to_string(static_cast<mkldnn::memory::format>(
+              m.get_primitive_desc().desc().data.format));
+        }
+
+        void primitive_list_runner::run() {
+            if(is_submitted_) {
+                stream_.rerun().wait();
+                return;
+            }
+            try {
+                stream_.submit(primitive_list_).wait();
+                is_submitted_ = true;
+            } catch(...) {
+                // the stream may keep some of the primitives
+                stream_ = mkldnn::stream(mkldnn::stream::kind::eager);
+                throw;
+            }
+        }
+
     } // namespace mkldnn_backend
 } // namespace menoh_impl
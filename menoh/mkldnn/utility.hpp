@@ -1,6 +1,7 @@
 #ifndef MENOH_MKLDNN_UTILITY_HPP
 #define MENOH_MKLDNN_UTILITY_HPP
 
+#include <utility>
 #include <vector>
 
 // mkldnn.hpp requires including <string>
@@ -36,6 +37,34 @@ namespace menoh_impl {
 
         array memory_to_array(mkldnn::memory const& mem);
 
+        // name of the format such as "nchw" or "nChw8c". Formats not named
+        // here are shown by their numbers and format_undef is empty
+        std::string format_to_string(mkldnn::memory::format format);
+
+        std::string extract_format_name(mkldnn::memory const& m);
+
+        // Runs primitives on an eager stream created once. The primitives
+        // are submitted on the first run and the stream is rerun after
+        // that, so a run creates no stream and allocates nothing. Not
+        // thread safe: each sequence of primitives has its own runner
+        class primitive_list_runner {
+        public:
+            explicit primitive_list_runner(
+              std::vector<mkldnn::primitive> primitive_list)
+              : primitive_list_(std::move(primitive_list)) {}
+
+            primitive_list_runner(primitive_list_runner const&) = delete;
+            primitive_list_runner&
+            operator=(primitive_list_runner const&) = delete;
+
+            void run();
+
+        private:
+            std::vector<mkldnn::primitive> primitive_list_;
+            mkldnn::stream stream_{mkldnn::stream::kind::eager};
+            bool is_submitted_ = false;
+        };
+
     } // namespace mkldnn_backend
 } // namespace menoh_impl
 
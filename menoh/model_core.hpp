@@ -1,11 +1,17 @@
 #ifndef MENOH_MODEL_CORE_HPP
 #define MENOH_MODEL_CORE_HPP
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 
 #include <menoh/exception.hpp>
+#include <menoh/memory_stats.hpp>
+#include <menoh/optional.hpp>
+#include <menoh/profiler.hpp>
 
 namespace menoh_impl {
 
@@ -38,14 +44,87 @@ namespace menoh_impl {
         }
     };
 
+    class deadline_exceeded : public exception {
+    public:
+        deadline_exceeded()
+          : exception(menoh_error_code_deadline_exceeded,
+                      "menoh deadline exceeded error") {}
+    };
+
+    class run_cancelled : public exception {
+    public:
+        run_cancelled()
+          : exception(menoh_error_code_run_cancelled,
+                      "menoh run cancelled error") {}
+    };
+
+    // Deadline and cancellation flag of a run. Executors call check()
+    // between procedures so that an expired or cancelled run stops early.
+    // The flag may be set from other threads
+    class run_control {
+    public:
+        run_control(
+          optional<std::chrono::steady_clock::time_point> deadline,
+          std::atomic<bool> const* is_cancelled)
+          : deadline_(deadline), is_cancelled_(is_cancelled) {}
+
+        // throws run_cancelled or deadline_exceeded
+        void check() const {
+            if(is_cancelled_ && is_cancelled_->load()) {
+                throw run_cancelled();
+            }
+            if(deadline_ && *deadline_ <= std::chrono::steady_clock::now()) {
+                throw deadline_exceeded();
+            }
+        }
+
+    private:
+        optional<std::chrono::steady_clock::time_point> deadline_;
+        std::atomic<bool> const* is_cancelled_;
+    };
+
     class model_core {
     public:
         virtual ~model_core() = 0;
 
-        void run() { do_run(); }
+        void run() { do_run(nullptr); }
+
+        // outputs are undefined when the run stops early
+        void run(run_control const& control) {
+            control.check();
+            do_run(&control);
+        }
+
+        // Subsequent runs record their procedures to `profiler`, which may
+        // be shared by cores. Null stops recording. Must not be called
+        // while running
+        void set_profiler(std::shared_ptr<profiler> const& profiler) {
+            do_set_profiler(profiler);
+        }
+
+        // the profiler set, or the one made at build by backend config
+        std::shared_ptr<profiler> get_profiler() const {
+            return do_get_profiler();
+        }
+
+        // adds memory held by the core. Buffers given to the core by its
+        // owner should be added before
+        void collect_memory_stats(memory_stats& stats) const {
+            do_collect_memory_stats(stats);
+        }
 
     private:
-        virtual void do_run() = 0;
+        // `control` is null when the run is not controlled
+        virtual void do_run(run_control const* control) = 0;
+
+        // cores which do not support profiling ignore it
+        virtual void
+        do_set_profiler(std::shared_ptr<profiler> const& /*profiler*/) {}
+        virtual std::shared_ptr<profiler> do_get_profiler() const {
+            return nullptr;
+        }
+        virtual void
+        do_collect_memory_stats(memory_stats& /*stats*/) const {}
     };
 
 } // namespace menoh_impl
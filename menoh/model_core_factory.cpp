@@ -1,40 +1,268 @@
 #include <menoh/model_core.hpp>
 #include <menoh/model_core_factory.hpp>
 
+#include <atomic>
+#include <cstdint>
+
+#include <menoh/batch_split.hpp>
+#include <menoh/cpu_placement.hpp>
+#include <menoh/multi_stream.hpp>
+#include <menoh/pipeline.hpp>
+
+#include <menoh/composite_backend/backend/mkldnn/shared_weight_cache.hpp>
 #include <menoh/composite_backend/model_core.hpp>
 #include <menoh/mkldnn/model_core.hpp>
 
 #include <menoh/json.hpp>
+#include <menoh/model_data.hpp>
 
 namespace menoh_impl {
 
+    namespace {
+
+        // float16 and bfloat16 parameters are expanded to float before
+        // passed to backends. When composite backends are configured with
+        // "compressed_weight": true, weights of Gemm and MatMul are kept
+        // compressed and expanded per layer in generic backend
+        model_data
+        expand_parameters_for_backend(menoh_impl::model_data const& model_data,
+                                      nlohmann::json const& config) {
+            std::unordered_set<std::string> kept_name_set;
+            if(config.find("compressed_weight") != config.end() &&
+               config["compressed_weight"].get<bool>()) {
+                kept_name_set =
+                  extract_compressible_parameter_name_set(model_data);
+            }
+            return expand_reduced_precision_parameters(model_data,
+                                                       kept_name_set);
+        }
+
+        // id of the placement last applied on each thread. 0 is none
+        thread_local std::uint64_t applied_placement_id = 0;
+
+        // Runs the model core with its threads pinned by the placement. The
+        // threads are pinned on the first run on each calling thread and
+        // stay pinned, so they are pinned again only after another placed
+        // core ran on the thread
+        class placed_model_core final : public menoh_impl::model_core {
+        public:
+            placed_model_core(std::unique_ptr<menoh_impl::model_core> core,
+                              cpu_placement placement)
+              : core_(std::move(core)),
+                placement_(std::move(placement)),
+                placement_id_(next_placement_id()) {}
+
+        private:
+            static std::uint64_t next_placement_id() {
+                static std::atomic<std::uint64_t> id{0};
+                return ++id;
+            }
+
+            virtual void do_run(run_control const* control) override {
+                if(applied_placement_id != placement_id_) {
+                    apply_cpu_placement(placement_);
+                    applied_placement_id = placement_id_;
+                }
+                if(control) {
+                    core_->run(*control);
+                } else {
+                    core_->run();
+                }
+            }
+
+            virtual void do_set_profiler(
+              std::shared_ptr<profiler> const& profiler) override {
+                core_->set_profiler(profiler);
+            }
+
+            virtual std::shared_ptr<profiler> do_get_profiler() const override {
+                return core_->get_profiler();
+            }
+
+            virtual void
+            do_collect_memory_stats(memory_stats& stats) const override {
+                core_->collect_memory_stats(stats);
+            }
+
+            std::unique_ptr<menoh_impl::model_core> core_;
+            cpu_placement placement_;
+            std::uint64_t placement_id_;
+        };
+
+        // Only memory allocated by menoh is moved. The memory policy is set
+        // on whole pages, which may also hold neighbouring user data
+        template <typename NameAndArrayList>
+        void move_arrays_to_numa_node(NameAndArrayList const& list,
+                                      int numa_node) {
+            for(auto const& p : list) {
+                auto const& arr = p.second;
+                if(!arr.has_ownership()) {
+                    continue;
+                }
+                move_memory_to_numa_node(
+                  arr.data(), total_size(arr) * get_size_in_bytes(arr.dtype()),
+                  numa_node);
+            }
+        }
+
+        std::unique_ptr<menoh_impl::model_core> make_backend_model_core(
+          std::unordered_map<std::string, array> const& input_table,
+          std::unordered_map<std::string, array> const& required_output_table,
+          std::unordered_map<std::string, array_profile> const&
+            output_profile_table,
+          menoh_impl::model_data const& model_data,
+          std::string const& backend_name, backend_config const& config,
+          std::shared_ptr<
+            composite_backend::mkldnn_backend::shared_weight_cache> const&
+            weight_cache) {
+            if(backend_name == "mkldnn") {
+                return std::make_unique<mkldnn_backend::model_core>(
+                  mkldnn_backend::make_model_core(
+                    input_table, required_output_table,
+                    expand_reduced_precision_parameters(model_data, {}),
+                    config));
+            } else if(backend_name == "mkldnn_with_generic_fallback") {
+                auto conf =
+                  nlohmann::json::parse(config.empty() ? "{}" : config);
+                conf.merge_patch(nlohmann::json::parse(
+                  R"({"backends":[{"type":"mkldnn"}, {"type":"generic"}]})"));
+                return std::make_unique<composite_backend::model_core>(
+                  composite_backend::make_model_core(
+                    input_table, required_output_table, output_profile_table,
+                    expand_parameters_for_backend(model_data, conf),
+                    conf.dump(), weight_cache));
+            } else if(backend_name == "composite_backend") {
+                return std::make_unique<composite_backend::model_core>(
+                  composite_backend::make_model_core(
+                    input_table, required_output_table, output_profile_table,
+                    expand_parameters_for_backend(
+                      model_data, nlohmann::json::parse(config)),
+                    config, weight_cache));
+            }
+
+            throw invalid_backend_name(backend_name);
+        }
+
+    } // namespace
+
+    std::shared_ptr<composite_backend::mkldnn_backend::shared_weight_cache>
+    make_shared_weight_cache() {
+        return std::make_shared<
+          composite_backend::mkldnn_backend::shared_weight_cache>();
+    }
+
+    // "thread_num", "cpu_list" and "numa_node" in config are common to all
+    // backends. Construction is done with threads pinned, so buffers
+    // allocated by backends are first touched on the NUMA node. Threads
+    // running the model are pinned on their first run.
+    // Parameters and given input and output buffers are moved to the node.
+    // Composite backends keep parameters and their packed weights in
+    // `weight_cache` when it is given
     std::unique_ptr<menoh_impl::model_core> make_model_core(
       std::unordered_map<std::string, array> const& input_table,
       std::unordered_map<std::string, array> const& required_output_table,
       std::unordered_map<std::string, array_profile> const&
         output_profile_table,
       menoh_impl::model_data const& model_data, std::string const& backend_name,
-      backend_config const& config) {
-        if(backend_name == "mkldnn") {
-            return std::make_unique<mkldnn_backend::model_core>(
-              mkldnn_backend::make_model_core(
-                input_table, required_output_table, model_data, config));
-        } else if(backend_name == "mkldnn_with_generic_fallback") {
-            auto conf = nlohmann::json::parse(config.empty() ? "{}" : config);
-            conf.merge_patch(
-              R"({"backends":[{"type":"mkldnn"}, {"type":"generic"}]})");
-            return std::make_unique<composite_backend::model_core>(
-              composite_backend::make_model_core(
-                input_table, required_output_table, output_profile_table,
-                model_data, conf.get<std::string>()));
-        } else if(backend_name == "composite_backend") {
-            return std::make_unique<composite_backend::model_core>(
-              composite_backend::make_model_core(
-                input_table, required_output_table, output_profile_table,
-                model_data, config));
-        }
-
-        throw invalid_backend_name(backend_name);
+      backend_config const& config,
+      std::shared_ptr<
+        composite_backend::mkldnn_backend::shared_weight_cache> const&
+        weight_cache) {
+        optional<cpu_placement> placement;
+        optional<batch_split_config> batch_split;
+        optional<pipeline_config> pipeline;
+        try {
+            placement = parse_cpu_placement(config);
+            batch_split = parse_batch_split_config(config);
+            pipeline = parse_pipeline_config(config);
+        } catch(nlohmann::json::parse_error const& e) {
+            throw json_parse_error(e.what());
+        }
+
+        // a large batch is split into sub-batches, each of which is built
+        // as a model on its own group of cpus in concurrent mode. Models of
+        // the groups share weights
+        if(batch_split) {
+            auto group_weight_cache =
+              weight_cache ? weight_cache : make_shared_weight_cache();
+            auto c = nlohmann::json::parse(config);
+            c.erase("sub_batch_size");
+            c.erase("sub_batch_mode");
+            auto core = make_batch_split_model_core(
+              input_table, required_output_table, model_data, *batch_split,
+              placement,
+              [&](std::unordered_map<std::string, array> const&
+                    sub_input_table,
+                  std::unordered_map<std::string, array> const&
+                    sub_output_table,
+                  std::unordered_map<std::string, array_profile> const&
+                    sub_profile_table,
+                  optional<cpu_placement> const& sub_placement) {
+                  if(sub_placement && sub_placement->thread_num) {
+                      c["thread_num"] = *sub_placement->thread_num;
+                  }
+                  if(sub_placement && !sub_placement->cpu_list.empty()) {
+                      c["cpu_list"] = sub_placement->cpu_list;
+                  }
+                  return make_model_core(sub_input_table, sub_output_table,
+                                         sub_profile_table, model_data,
+                                         backend_name, c.dump(),
+                                         group_weight_cache);
+              });
+            if(core) {
+                return core;
+            }
+        }
+
+        // each stage of pipeline is built with its own group of cpus
+        if(pipeline) {
+            auto placement_list =
+              partition_cpu_placement(placement, pipeline->stage_num);
+            auto c = nlohmann::json::parse(config);
+            c.erase("pipeline_stage_num");
+            c.erase("pipeline_cut_points");
+            return make_pipeline_model_core(
+              input_table, required_output_table, output_profile_table,
+              model_data, *pipeline,
+              [&](menoh_impl::model_data const& stage_model_data,
+                  std::unordered_map<std::string, array> const&
+                    stage_input_table,
+                  std::unordered_map<std::string, array> const&
+                    stage_output_table,
+                  int stage_index) {
+                  auto const& stage_placement =
+                    placement_list.at(stage_index);
+                  if(stage_placement.thread_num) {
+                      c["thread_num"] = *stage_placement.thread_num;
+                  }
+                  if(!stage_placement.cpu_list.empty()) {
+                      c["cpu_list"] = stage_placement.cpu_list;
+                  }
+                  return make_model_core(stage_input_table, stage_output_table,
+                                         output_profile_table,
+                                         stage_model_data, backend_name,
+                                         c.dump(), weight_cache);
+              });
+        }
+        if(!placement) {
+            return make_backend_model_core(input_table, required_output_table,
+                                           output_profile_table, model_data,
+                                           backend_name, config, weight_cache);
+        }
+
+        if(placement->numa_node) {
+            move_arrays_to_numa_node(model_data.parameter_name_and_array_list,
+                                     *placement->numa_node);
+            move_arrays_to_numa_node(input_table, *placement->numa_node);
+            move_arrays_to_numa_node(required_output_table,
+                                     *placement->numa_node);
+        }
+        cpu_placement_guard guard(*placement);
+        return std::make_unique<placed_model_core>(
+          make_backend_model_core(input_table, required_output_table,
+                                  output_profile_table, model_data,
+                                  backend_name, config, weight_cache),
+          *placement);
     }
 
 } // namespace menoh_impl
@@ -22,13 +22,27 @@ namespace menoh_impl {
 
     struct model_data;
 
+    namespace composite_backend {
+        namespace mkldnn_backend {
+            class shared_weight_cache;
+        } // namespace mkldnn_backend
+    }     // namespace composite_backend
+
+    // Parameters and their packed weights of models built with the same
+    // cache are shared. Only composite backends use it
+    std::shared_ptr<composite_backend::mkldnn_backend::shared_weight_cache>
+    make_shared_weight_cache();
+
     std::unique_ptr<menoh_impl::model_core> make_model_core(
       std::unordered_map<std::string, array> const& input_table,
       std::unordered_map<std::string, array> const& required_output_table,
       std::unordered_map<std::string, array_profile> const&
         output_profile_table,
       menoh_impl::model_data const& model_data, std::string const& backend_name,
-      backend_config const& config = backend_config());
+      backend_config const& config = backend_config(),
+      std::shared_ptr<
+        composite_backend::mkldnn_backend::shared_weight_cache> const&
+        weight_cache = nullptr);
 
 } // namespace menoh_impl
 
@@ -62,6 +62,43 @@ namespace menoh_impl {
         return model_data;
     }
 
+    // float16 and bfloat16 parameters which are used only as B of Gemm
+    // and MatMul. They can be kept compressed because generic backend
+    // expands them per layer when the layer runs
+    inline std::unordered_set<std::string>
+    extract_compressible_parameter_name_set(model_data const& model_data) {
+        std::unordered_set<std::string> compressible_name_set;
+        for(auto const& p : model_data.parameter_name_and_array_list) {
+            if(is_reduced_precision_float(p.second.dtype())) {
+                compressible_name_set.insert(p.first);
+            }
+        }
+        for(auto const& node : model_data.node_list) {
+            bool is_compressible_op =
+              node.op_type == "Gemm" || node.op_type == "MatMul";
+            for(unsigned int i = 0; i < node.input_name_list.size(); ++i) {
+                if(!is_compressible_op || i != 1) {
+                    compressible_name_set.erase(node.input_name_list.at(i));
+                }
+            }
+        }
+        return compressible_name_set;
+    }
+
+    // float16 and bfloat16 parameters except ones in `kept_name_set` are
+    // expanded to float
+    inline model_data expand_reduced_precision_parameters(
+      menoh_impl::model_data model_data,
+      std::unordered_set<std::string> const& kept_name_set) {
+        for(auto& p : model_data.parameter_name_and_array_list) {
+            if(is_reduced_precision_float(p.second.dtype()) &&
+               kept_name_set.find(p.first) == kept_name_set.end()) {
+                p.second = to_float_array(p.second);
+            }
+        }
+        return model_data;
+    }
+
 } // namespace menoh_impl
 
 #endif // MENOH_MODEL_DATA_HPP
@@ -0,0 +1,115 @@
+#ifndef MENOH_MPMC_QUEUE_HPP
+#define MENOH_MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace menoh_impl {
+
+    // Bounded lock-free multi-producer multi-consumer queue (Vyukov's
+    // algorithm). Each cell has a sequence number telling whether it is
+    // ready to be written or read at the current position. Capacity is
+    // rounded up to a power of 2
+    template <typename T>
+    class mpmc_queue {
+    public:
+        explicit mpmc_queue(std::size_t capacity)
+          : capacity_(round_up_to_power_of_2(capacity)),
+            buffer_(std::make_unique<cell[]>(capacity_)) {
+            for(std::size_t i = 0; i < capacity_; ++i) {
+                buffer_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        mpmc_queue(mpmc_queue const&) = delete;
+        mpmc_queue& operator=(mpmc_queue const&) = delete;
+
+        std::size_t capacity() const { return capacity_; }
+
+        // returns false when the queue is full. `value` is not moved then
+        bool try_push(T& value) {
+            auto pos = positions_.enqueue.load(std::memory_order_relaxed);
+            while(true) {
+                auto& c = buffer_[pos & (capacity_ - 1)];
+                auto sequence = c.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                            static_cast<std::ptrdiff_t>(pos);
+                if(diff == 0) {
+                    if(positions_.enqueue.compare_exchange_weak(
+                         pos, pos + 1, std::memory_order_relaxed)) {
+                        c.value = std::move(value);
+                        c.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if(diff < 0) {
+                    return false;
+                } else {
+                    pos = positions_.enqueue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // returns false when the queue is empty
+        bool try_pop(T& value) {
+            auto pos = positions_.dequeue.load(std::memory_order_relaxed);
+            while(true) {
+                auto& c = buffer_[pos & (capacity_ - 1)];
+                auto sequence = c.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                            static_cast<std::ptrdiff_t>(pos + 1);
+                if(diff == 0) {
+                    if(positions_.dequeue.compare_exchange_weak(
+                         pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(c.value);
+                        c.sequence.store(pos + capacity_,
+                                         std::memory_order_release);
+                        return true;
+                    }
+                } else if(diff < 0) {
+                    return false;
+                } else {
+                    pos = positions_.dequeue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct cell {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static std::size_t round_up_to_power_of_2(std::size_t n) {
+            assert(0 < n);
+            std::size_t power = 1;
+            while(power < n) {
+                power *= 2;
+            }
+            return power;
+        }
+
+        static constexpr std::size_t cache_line_size = 64;
+
+        // Positions are apart from each other and from other members by a
+        // cache line not to be shared between producers and consumers.
+        // Padding is used instead of alignas because over-aligned types are
+        // not aligned by operator new before C++17
+        struct padded_position_pair {
+            char padding0[cache_line_size];
+            std::atomic<std::size_t> enqueue{0};
+            char padding1[cache_line_size];
+            std::atomic<std::size_t> dequeue{0};
+            char padding2[cache_line_size];
+        };
+
+        std::size_t capacity_;
+        std::unique_ptr<cell[]> buffer_;
+        padded_position_pair positions_;
+    };
+
+} // namespace menoh_impl
+
+#endif // MENOH_MPMC_QUEUE_HPP
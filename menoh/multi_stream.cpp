@@ -0,0 +1,327 @@
+#include <menoh/multi_stream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <menoh/json.hpp>
+#include <menoh/pipeline.hpp>
+
+namespace menoh_impl {
+
+    int parse_stream_num(std::string const& config) {
+        if(config.empty()) {
+            return 1;
+        }
+        try {
+            auto c = nlohmann::json::parse(config);
+            if(c.find("stream_num") == c.end()) {
+                return 1;
+            }
+            auto stream_num = c["stream_num"].get<int>();
+            if(stream_num < 1) {
+                throw invalid_backend_config_error(
+                  "invalid value of \"stream_num\": " +
+                  std::to_string(stream_num));
+            }
+            return stream_num;
+        } catch(nlohmann::json::parse_error const& e) {
+            throw json_parse_error(e.what());
+        }
+    }
+
+    std::vector<cpu_placement>
+    partition_cpu_placement(optional<cpu_placement> const& placement,
+                            int group_num) {
+        auto cpu_list = placement && !placement->cpu_list.empty()
+                          ? placement->cpu_list
+                          : current_thread_cpu_list();
+        optional<int> thread_num;
+        if(placement) {
+            thread_num = placement->thread_num;
+        }
+        optional<int> numa_node;
+        if(placement) {
+            numa_node = placement->numa_node;
+        }
+
+        std::vector<cpu_placement> placement_list;
+        if(cpu_list.empty()) {
+            // cpus are unknown. Only the number of threads is divided
+            if(!thread_num) {
+                thread_num = std::max(
+                  1, static_cast<int>(std::thread::hardware_concurrency()) /
+                       group_num);
+            }
+            for(int i = 0; i < group_num; ++i) {
+                placement_list.push_back(
+                  cpu_placement{thread_num, {}, numa_node});
+            }
+            return placement_list;
+        }
+
+        int cpu_num = static_cast<int>(cpu_list.size());
+        if(cpu_num < group_num) {
+            throw invalid_backend_config_error(
+              "cannot split " + std::to_string(cpu_num) + " cpus into " +
+              std::to_string(group_num) + " groups");
+        }
+        for(int i = 0; i < group_num; ++i) {
+            std::vector<int> group(cpu_list.begin() + i * cpu_num / group_num,
+                                   cpu_list.begin() +
+                                     (i + 1) * cpu_num / group_num);
+            placement_list.push_back(
+              cpu_placement{thread_num, std::move(group), numa_node});
+        }
+        return placement_list;
+    }
+
+    std::vector<model_stream> make_model_stream_list(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      std::unordered_map<std::string, array_profile> const&
+        output_profile_table,
+      menoh_impl::model_data const& model_data, std::string const& backend_name,
+      backend_config const& config, int stream_num) {
+        nlohmann::json c;
+        optional<cpu_placement> placement;
+        try {
+            c = nlohmann::json::parse(config.empty() ? "{}" : config);
+            placement = parse_cpu_placement(config);
+        } catch(nlohmann::json::parse_error const& e) {
+            throw json_parse_error(e.what());
+        }
+        c.erase("stream_num");
+        auto placement_list = partition_cpu_placement(placement, stream_num);
+
+        auto make_own_table =
+          [](std::unordered_map<std::string, array> const& table) {
+              std::unordered_map<std::string, array> own_table;
+              for(auto const& p : table) {
+                  own_table.emplace(
+                    p.first, array(p.second.dtype(), p.second.dims()));
+              }
+              return own_table;
+          };
+
+        auto weight_cache = make_shared_weight_cache();
+        std::vector<model_stream> stream_list;
+        for(int i = 0; i < stream_num; ++i) {
+            auto const& stream_placement = placement_list.at(i);
+            if(stream_placement.thread_num) {
+                c["thread_num"] = *stream_placement.thread_num;
+            }
+            if(!stream_placement.cpu_list.empty()) {
+                c["cpu_list"] = stream_placement.cpu_list;
+            }
+            model_stream stream;
+            stream.input_table =
+              i == 0 ? input_table : make_own_table(input_table);
+            stream.output_table = i == 0
+                                    ? required_output_table
+                                    : make_own_table(required_output_table);
+            stream.core = make_model_core(
+              stream.input_table, stream.output_table, output_profile_table,
+              model_data, backend_name, c.dump(), weight_cache);
+            stream_list.push_back(std::move(stream));
+        }
+        return stream_list;
+    }
+
+    void warm_up_stream(model_stream& stream, int iteration_num) {
+        if(iteration_num < 0) {
+            throw std::invalid_argument(
+              "invalid number of warm-up iterations: " +
+              std::to_string(iteration_num));
+        }
+        for(auto table : {&stream.input_table, &stream.output_table}) {
+            for(auto const& p : *table) {
+                auto const& arr = p.second;
+                // user buffers may be mapped read-only
+                if(!arr.has_ownership()) {
+                    continue;
+                }
+                prefault_memory(arr.data(), total_size(arr) *
+                                              get_size_in_bytes(arr.dtype()));
+            }
+        }
+
+        // warm-up runs are not recorded to the profiler
+        auto profiler = stream.core->get_profiler();
+        if(profiler) {
+            stream.core->set_profiler(nullptr);
+        }
+        try {
+            for(int i = 0; i < iteration_num; ++i) {
+                stream.core->run();
+            }
+        } catch(...) {
+            if(profiler) {
+                stream.core->set_profiler(profiler);
+            }
+            throw;
+        }
+        if(profiler) {
+            stream.core->set_profiler(profiler);
+        }
+    }
+
+    void warm_up(std::vector<model_stream>& stream_list, int iteration_num) {
+        if(iteration_num < 0) {
+            throw std::invalid_argument(
+              "invalid number of warm-up iterations: " +
+              std::to_string(iteration_num));
+        }
+        std::mutex mutex;
+        std::exception_ptr exception;
+        auto work = [&](model_stream& stream) {
+            try {
+                warm_up_stream(stream, iteration_num);
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        };
+
+        // the first stream is warmed on the calling thread, which usually
+        // calls run() later, so that its OpenMP threads and thread local
+        // buffers of backends are also ready
+        std::vector<std::thread> worker_list;
+        for(std::size_t i = 1; i < stream_list.size(); ++i) {
+            worker_list.emplace_back(work, std::ref(stream_list.at(i)));
+        }
+        if(!stream_list.empty()) {
+            work(stream_list.front());
+        }
+        for(auto& worker : worker_list) {
+            worker.join();
+        }
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    stream_worker_pool::stream_worker_pool(int worker_num)
+      : worker_num_(worker_num) {
+        if(worker_num < 1) {
+            throw std::invalid_argument("invalid number of workers: " +
+                                        std::to_string(worker_num));
+        }
+    }
+
+    stream_worker_pool::~stream_worker_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_stopped_ = true;
+        }
+        task_cv_.notify_all();
+        for(auto& worker : worker_list_) {
+            worker.join();
+        }
+    }
+
+    void stream_worker_pool::run(std::function<void(int)> const& task) {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        if(worker_list_.empty()) {
+            for(int i = 0; i < worker_num_; ++i) {
+                worker_list_.emplace_back(&stream_worker_pool::work, this, i);
+            }
+        }
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_ = &task;
+            ++task_id_;
+            running_num_ = worker_num_;
+            task_cv_.notify_all();
+            done_cv_.wait(lock, [this] { return running_num_ == 0; });
+            task_ = nullptr;
+            std::swap(exception, exception_);
+        }
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void stream_worker_pool::work(int worker_index) {
+        std::uint64_t done_task_id = 0;
+        while(true) {
+            std::function<void(int)> const* task = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                task_cv_.wait(lock, [this, done_task_id] {
+                    return is_stopped_ || task_id_ != done_task_id;
+                });
+                if(is_stopped_) {
+                    return;
+                }
+                task = task_;
+                done_task_id = task_id_;
+            }
+            std::exception_ptr exception;
+            try {
+                (*task)(worker_index);
+            } catch(...) {
+                exception = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(exception && !exception_) {
+                    exception_ = exception;
+                }
+                if(--running_num_ == 0) {
+                    done_cv_.notify_one();
+                }
+            }
+        }
+    }
+
+    void run_batches(std::vector<model_stream>& stream_list,
+                     stream_worker_pool& worker_pool, int batch_num,
+                     batch_callback const& prepare,
+                     batch_callback const& finish) {
+        // batches are streamed through stages of a pipeline
+        if(stream_list.size() == 1) {
+            auto pipeline = dynamic_cast<pipeline_model_core*>(
+              stream_list.front().core.get());
+            if(pipeline) {
+                pipeline->run_batches(batch_num, prepare, finish);
+                return;
+            }
+        }
+
+        assert(worker_pool.worker_num() ==
+               static_cast<int>(stream_list.size()));
+        std::atomic<int> next_batch_index{0};
+        std::atomic<bool> is_failed{false};
+        worker_pool.run([&](int stream_index) {
+            try {
+                while(!is_failed) {
+                    int batch_index = next_batch_index++;
+                    if(batch_num <= batch_index) {
+                        return;
+                    }
+                    if(prepare) {
+                        prepare(batch_index, stream_index);
+                    }
+                    stream_list.at(stream_index).core->run();
+                    if(finish) {
+                        finish(batch_index, stream_index);
+                    }
+                }
+            } catch(...) {
+                is_failed = true;
+                throw;
+            }
+        });
+    }
+
+} // namespace menoh_impl
@@ -0,0 +1,118 @@
+#ifndef MENOH_MULTI_STREAM_HPP
+#define MENOH_MULTI_STREAM_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/cpu_placement.hpp>
+#include <menoh/model_core.hpp>
+#include <menoh/model_core_factory.hpp>
+#include <menoh/model_data.hpp>
+
+namespace menoh_impl {
+
+    // one of independent replicas of a model. It has its own input and
+    // output buffers and activations and runs on its own cpus
+    struct model_stream {
+        std::unordered_map<std::string, array> input_table;
+        std::unordered_map<std::string, array> output_table;
+        std::unique_ptr<model_core> core;
+    };
+
+    // "stream_num" in backend config. 1 when it is not given
+    int parse_stream_num(std::string const& config);
+
+    // Splits cpus of the placement (or all cpus the calling thread can run
+    // on) into `group_num` contiguous groups for streams or pipeline
+    // stages. "thread_num" of the placement, if given, is the number of
+    // threads of each group
+    std::vector<cpu_placement>
+    partition_cpu_placement(optional<cpu_placement> const& placement,
+                            int group_num);
+
+    // Builds `stream_num` streams of the model. The first stream uses the
+    // given buffers and the others allocate their own. Parameters are
+    // shared by all streams. With composite backends packed weights are
+    // also shared: they are made once while the first stream is built
+    std::vector<model_stream> make_model_stream_list(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      std::unordered_map<std::string, array_profile> const&
+        output_profile_table,
+      menoh_impl::model_data const& model_data, std::string const& backend_name,
+      backend_config const& config, int stream_num);
+
+    // Maps pages of inputs and outputs of the stream allocated by menoh and
+    // runs it `iteration_num` times on the calling thread without recording
+    // to its profiler. Values of outputs are overwritten
+    void warm_up_stream(model_stream& stream, int iteration_num);
+
+    // Maps pages of inputs and outputs allocated by menoh and runs each
+    // stream `iteration_num` times, so that activations allocated by
+    // backends are touched and mkldnn streams are created before the first
+    // real run. The first stream is warmed on the calling thread and the
+    // others concurrently on their own threads. Warm-up runs are not
+    // recorded to profilers. Values of outputs are overwritten
+    void warm_up(std::vector<model_stream>& stream_list, int iteration_num);
+
+    // Threads kept for streams across calls of run_batches(), one for each
+    // stream, so that OpenMP threads of backends, cpu pinning and thread
+    // local buffers are reused. Threads are started on the first run
+    class stream_worker_pool {
+    public:
+        explicit stream_worker_pool(int worker_num);
+        ~stream_worker_pool();
+
+        stream_worker_pool(stream_worker_pool const&) = delete;
+        stream_worker_pool& operator=(stream_worker_pool const&) = delete;
+
+        int worker_num() const { return worker_num_; }
+
+        // Calls `task(worker_index)` on all workers and waits for them. The
+        // first exception is rethrown after all of them return
+        void run(std::function<void(int worker_index)> const& task);
+
+    private:
+        void work(int worker_index);
+
+        int worker_num_;
+        std::vector<std::thread> worker_list_;
+        std::mutex run_mutex_; // one run at a time
+
+        std::mutex mutex_;
+        std::condition_variable task_cv_;
+        std::condition_variable done_cv_;
+        std::function<void(int)> const* task_ = nullptr;
+        std::uint64_t task_id_ = 0;
+        int running_num_ = 0;
+        std::exception_ptr exception_;
+        bool is_stopped_ = false;
+    };
+
+    using batch_callback =
+      std::function<void(int batch_index, int stream_index)>;
+
+    // Runs `batch_num` batches on the streams. A worker of the pool for
+    // each stream takes the next batch index from a shared counter, calls
+    // `prepare` to fill inputs of the stream, runs it and calls `finish`
+    // to read its outputs. Callbacks are called concurrently from
+    // different workers. The first exception is rethrown after all
+    // workers stop and no new batch is started after it. The pool has as
+    // many workers as streams
+    void run_batches(std::vector<model_stream>& stream_list,
+                     stream_worker_pool& worker_pool, int batch_num,
+                     batch_callback const& prepare,
+                     batch_callback const& finish);
+
+} // namespace menoh_impl
+
+#endif // MENOH_MULTI_STREAM_HPP
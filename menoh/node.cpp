@@ -54,6 +54,18 @@ namespace menoh_impl {
         return menoh_impl::get<array>(find_value(n.attribute_table, attr_name));
     }
 
+    std::string optional_attribute_string(node const& n,
+                                          std::string const& attr_name,
+                                          std::string const& default_value) {
+        return optional_attribute<std::string>(n, attr_name, default_value);
+    }
+
+    std::string const& attribute_string(node const& n,
+                                        std::string const& attr_name) {
+        return menoh_impl::get<std::string>(
+          find_value(n.attribute_table, attr_name));
+    }
+
     std::vector<int>
     optional_attribute_ints(node const& n, std::string const& attr_name,
                             std::vector<int> const& default_value) {
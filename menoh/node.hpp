@@ -10,8 +10,9 @@
 
 namespace menoh_impl {
 
-    using attribute = menoh_impl::variant<int, float, std::vector<int>,
-                                          std::vector<float>, array>;
+    using attribute =
+      menoh_impl::variant<int, float, std::vector<int>, std::vector<float>,
+                          array, std::string>;
 
     struct node {
         std::string op_type;
@@ -40,6 +41,11 @@ namespace menoh_impl {
     std::vector<float> const& attribute_floats(node const& n,
                                                std::string const& attr_name);
     array const& attribute_tensor(node const& n, std::string const& attr_name);
+    std::string optional_attribute_string(node const& n,
+                                          std::string const& attr_name,
+                                          std::string const& default_value);
+    std::string const& attribute_string(node const& n,
+                                        std::string const& attr_name);
 
     std::tuple<std::vector<int>, std::vector<int>, std::vector<int>>
     attributes_for_2d_data_processing(node const& n);
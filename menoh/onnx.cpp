@@ -4,6 +4,8 @@
 #include <exception>
 #include <fstream>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <numeric>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +26,10 @@ namespace menoh_impl {
     dtype_t tensor_proto_data_type_to_dtype(google::protobuf::int32 tpdt) {
         if(tpdt == menoh_onnx::TensorProto_DataType_FLOAT) {
             return dtype_t::float_;
+        } else if(tpdt == menoh_onnx::TensorProto_DataType_FLOAT16) {
+            return dtype_t::float16;
+        } else if(tpdt == 16) { // TensorProto_DataType_BFLOAT16 (onnx 1.4)
+            return dtype_t::bfloat16;
         } else if(tpdt == menoh_onnx::TensorProto_DataType_INT8) {
             return dtype_t::int8;
         } else if(tpdt == menoh_onnx::TensorProto_DataType_INT16) {
@@ -101,6 +107,13 @@ namespace menoh_impl {
             assert(tensor.float_data_size());
             std::copy(tensor.float_data().begin(), tensor.float_data().end(),
                       static_cast<float*>(data.get()));
+        } else if(dtype == dtype_t::float16 || dtype == dtype_t::bfloat16) {
+            // bit pattern of each element is stored in int32_data
+            assert(tensor.int32_data_size());
+            std::transform(
+              tensor.int32_data().begin(), tensor.int32_data().end(),
+              static_cast<dtype_type*>(data.get()),
+              [](auto e) { return static_cast<dtype_type>(e); });
         } else if(dtype == dtype_t::int32) {
             assert(tensor.int32_data_size());
             std::copy(tensor.int32_data().begin(), tensor.int32_data().end(),
@@ -128,6 +141,12 @@ namespace menoh_impl {
         if(d == menoh_impl::dtype_t::float_) {
             data = move_tensor_from_onnx_data<menoh_impl::dtype_t::float_>(
               total_size, tensor);
+        } else if(d == menoh_impl::dtype_t::float16) {
+            data = move_tensor_from_onnx_data<menoh_impl::dtype_t::float16>(
+              total_size, tensor);
+        } else if(d == menoh_impl::dtype_t::bfloat16) {
+            data = move_tensor_from_onnx_data<menoh_impl::dtype_t::bfloat16>(
+              total_size, tensor);
         } else if(d == menoh_impl::dtype_t::int8) {
             data = move_tensor_from_onnx_data<menoh_impl::dtype_t::int8>(
               total_size, tensor);
@@ -164,6 +183,15 @@ namespace menoh_impl {
         return parameter_name_and_array_list;
     }
 
+    // int attributes are kept as int. Out of range values such as INT64_MAX
+    // used for Slice ends are saturated
+    int saturate_to_int(google::protobuf::int64 i) {
+        return static_cast<int>(std::max<google::protobuf::int64>(
+          std::min<google::protobuf::int64>(i,
+                                            std::numeric_limits<int>::max()),
+          std::numeric_limits<int>::min()));
+    }
+
     auto
     extract_node_list_from_onnx_graph(menoh_onnx::GraphProto const& graph) {
         std::vector<node> node_list;
@@ -172,13 +200,14 @@ namespace menoh_impl {
             for(auto const& attr : onnx_node.attribute()) {
                 if(attr.has_i()) {
                     attribute_table.emplace(
-                      attr.name(), static_cast<int>(attr.i())); // TODO int64
+                      attr.name(), saturate_to_int(attr.i())); // TODO int64
                 } else if(attr.has_f()) {
                     attribute_table.emplace(attr.name(), attr.f());
                 } else if(attr.ints_size()) {
-                    attribute_table.emplace(
-                      attr.name(),
-                      std::vector<int>(attr.ints().begin(), attr.ints().end()));
+                    std::vector<int> ints;
+                    std::transform(attr.ints().begin(), attr.ints().end(),
+                                   std::back_inserter(ints), saturate_to_int);
+                    attribute_table.emplace(attr.name(), ints);
                 } else if(attr.floats_size()) {
                     attribute_table.emplace(
                       attr.name(), std::vector<float>(attr.floats().begin(),
@@ -186,6 +215,8 @@ namespace menoh_impl {
                 } else if(attr.has_t()) {
                     attribute_table.emplace(attr.name(),
                                             tensor_to_array(attr.t()));
+                } else if(attr.has_s()) {
+                    attribute_table.emplace(attr.name(), attr.s());
                 } else {
                     throw invalid_attribute_type(
                       attr.name(),
@@ -0,0 +1,419 @@
+#include <menoh/pipeline.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <menoh/graph.hpp>
+#include <menoh/json.hpp>
+
+namespace menoh_impl {
+
+    optional<pipeline_config> parse_pipeline_config(std::string const& config) {
+        if(config.empty()) {
+            return nullopt;
+        }
+        auto c = nlohmann::json::parse(config);
+        if(c.find("pipeline_stage_num") == c.end()) {
+            return nullopt;
+        }
+        pipeline_config pipeline;
+        pipeline.stage_num = c["pipeline_stage_num"].get<int>();
+        if(pipeline.stage_num < 1) {
+            throw invalid_backend_config_error(
+              "invalid value of \"pipeline_stage_num\": " +
+              std::to_string(pipeline.stage_num));
+        }
+        if(pipeline.stage_num == 1) {
+            return nullopt;
+        }
+        if(c.find("pipeline_cut_points") != c.end()) {
+            pipeline.cut_point_list =
+              c["pipeline_cut_points"].get<std::vector<int>>();
+            if(static_cast<int>(pipeline.cut_point_list.size()) !=
+               pipeline.stage_num - 1) {
+                throw invalid_backend_config_error(
+                  "\"pipeline_cut_points\" must have \"pipeline_stage_num\" "
+                  "- 1 elements");
+            }
+        }
+        return pipeline;
+    }
+
+    std::vector<int>
+    balance_cut_point_list(std::vector<double> const& cost_list,
+                           int stage_num) {
+        int n = static_cast<int>(cost_list.size());
+        assert(0 < stage_num && stage_num <= n);
+        std::vector<double> prefix_sum_list(n + 1, 0.);
+        for(int i = 0; i < n; ++i) {
+            prefix_sum_list.at(i + 1) = prefix_sum_list.at(i) + cost_list.at(i);
+        }
+
+        // largest_cost[k][i] is the minimum of the largest stage cost when
+        // the first i nodes are split into k stages
+        auto inf = std::numeric_limits<double>::infinity();
+        std::vector<std::vector<double>> largest_cost(
+          stage_num + 1, std::vector<double>(n + 1, inf));
+        std::vector<std::vector<int>> last_cut(stage_num + 1,
+                                               std::vector<int>(n + 1, 0));
+        largest_cost.at(0).at(0) = 0.;
+        for(int k = 1; k <= stage_num; ++k) {
+            for(int i = k; i <= n; ++i) {
+                for(int j = k - 1; j < i; ++j) {
+                    auto cost = std::max(largest_cost.at(k - 1).at(j),
+                                         prefix_sum_list.at(i) -
+                                           prefix_sum_list.at(j));
+                    if(cost < largest_cost.at(k).at(i)) {
+                        largest_cost.at(k).at(i) = cost;
+                        last_cut.at(k).at(i) = j;
+                    }
+                }
+            }
+        }
+
+        std::vector<int> cut_point_list(stage_num - 1);
+        int i = n;
+        for(int k = stage_num; 1 < k; --k) {
+            i = last_cut.at(k).at(i);
+            cut_point_list.at(k - 2) = i;
+        }
+        return cut_point_list;
+    }
+
+    void pipeline_model_core::forward(int stage_index) {
+        for(auto const& p : stage_list_.at(stage_index).forward_list) {
+            auto const& from = p.first;
+            auto const& to = p.second;
+            std::memcpy(to.data(), from.data(),
+                        total_size(from) * get_size_in_bytes(from.dtype()));
+        }
+    }
+
+    void pipeline_model_core::do_set_profiler(
+      std::shared_ptr<profiler> const& profiler) {
+        for(auto& s : stage_list_) {
+            s.core->set_profiler(profiler);
+        }
+    }
+
+    // the profiler of the first stage
+    std::shared_ptr<profiler> pipeline_model_core::do_get_profiler() const {
+        return stage_list_.front().core->get_profiler();
+    }
+
+    // variables passed between stages are activations
+    void
+    pipeline_model_core::do_collect_memory_stats(memory_stats& stats) const {
+        for(auto const& s : stage_list_) {
+            for(auto const& p : s.arriving_table) {
+                stats.add(p.first, memory_category::activation, p.second);
+            }
+        }
+        for(auto const& s : stage_list_) {
+            s.core->collect_memory_stats(stats);
+        }
+    }
+
+    void pipeline_model_core::do_run(run_control const* control) {
+        for(int i = 0; i < stage_num(); ++i) {
+            if(control) {
+                stage_list_.at(i).core->run(*control);
+            } else {
+                stage_list_.at(i).core->run();
+            }
+            forward(i);
+        }
+    }
+
+    void pipeline_model_core::run_batches(
+      int batch_num, std::function<void(int, int)> const& prepare,
+      std::function<void(int, int)> const& finish) {
+        std::mutex mutex;
+        std::condition_variable cv;
+        // is_full_list[i] is true while arriving_table of stage i holds a
+        // batch which stage i has not finished
+        std::vector<bool> is_full_list(stage_num(), false);
+        bool is_failed = false;
+        std::exception_ptr exception;
+
+        auto work = [&](int stage_index) {
+            auto is_last = stage_index + 1 == stage_num();
+            try {
+                for(int batch_index = 0; batch_index < batch_num;
+                    ++batch_index) {
+                    if(stage_index == 0) {
+                        if(prepare) {
+                            prepare(batch_index, 0);
+                        }
+                    } else {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        cv.wait(lock, [&]() {
+                            return is_full_list.at(stage_index) || is_failed;
+                        });
+                        if(is_failed) {
+                            return;
+                        }
+                    }
+
+                    stage_list_.at(stage_index).core->run();
+
+                    if(is_last) {
+                        forward(stage_index);
+                        if(finish) {
+                            finish(batch_index, 0);
+                        }
+                    } else {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            cv.wait(lock, [&]() {
+                                return !is_full_list.at(stage_index + 1) ||
+                                       is_failed;
+                            });
+                            if(is_failed) {
+                                return;
+                            }
+                        }
+                        forward(stage_index);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        is_full_list.at(stage_index + 1) = true;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        is_full_list.at(stage_index) = false;
+                    }
+                    cv.notify_all();
+                }
+            } catch(...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(!exception) {
+                        exception = std::current_exception();
+                    }
+                    is_failed = true;
+                }
+                cv.notify_all();
+            }
+        };
+
+        std::vector<std::thread> worker_list;
+        for(int i = 0; i < stage_num(); ++i) {
+            worker_list.emplace_back(work, i);
+        }
+        for(auto& worker : worker_list) {
+            worker.join();
+        }
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    namespace {
+
+        using stage_core_factory = std::function<std::unique_ptr<model_core>(
+          menoh_impl::model_data const&,
+          std::unordered_map<std::string, array> const&,
+          std::unordered_map<std::string, array> const&, int)>;
+
+        menoh_impl::model_data
+        make_stage_model_data(menoh_impl::model_data const& model_data,
+                              std::vector<node>::const_iterator first,
+                              std::vector<node>::const_iterator last) {
+            menoh_impl::model_data stage_model_data;
+            stage_model_data.node_list.assign(first, last);
+            auto input_name_set =
+              extract_all_input_name_set(stage_model_data.node_list);
+            for(auto const& p : model_data.parameter_name_and_array_list) {
+                if(input_name_set.find(p.first) != input_name_set.end()) {
+                    stage_model_data.parameter_name_and_array_list.push_back(
+                      p);
+                }
+            }
+            return stage_model_data;
+        }
+
+        // Time of each node measured by running it alone on the cpus of
+        // the first stage
+        std::vector<double> measure_node_cost_list(
+          menoh_impl::model_data const& model_data,
+          std::vector<node> const& node_list,
+          std::unordered_map<std::string, array_profile> const& profile_table,
+          stage_core_factory const& make_stage_core) {
+            std::vector<double> cost_list;
+            for(auto iter = node_list.begin(); iter != node_list.end();
+                ++iter) {
+                auto node_model_data =
+                  make_stage_model_data(model_data, iter, iter + 1);
+                std::set<std::string> parameter_name_set;
+                for(auto const& p :
+                    node_model_data.parameter_name_and_array_list) {
+                    parameter_name_set.insert(p.first);
+                }
+                std::unordered_map<std::string, array> input_table;
+                for(auto const& name : iter->input_name_list) {
+                    if(parameter_name_set.find(name) ==
+                         parameter_name_set.end() &&
+                       profile_table.find(name) != profile_table.end()) {
+                        input_table.emplace(name,
+                                            array(profile_table.at(name)));
+                    }
+                }
+                std::unordered_map<std::string, array> output_table;
+                for(auto const& name : iter->output_name_list) {
+                    output_table.emplace(name, array(profile_table.at(name)));
+                }
+                auto core = make_stage_core(node_model_data, input_table,
+                                            output_table, 0);
+                core->run();
+                auto cost = std::numeric_limits<double>::infinity();
+                for(int i = 0; i < 3; ++i) {
+                    auto start = std::chrono::steady_clock::now();
+                    core->run();
+                    auto end = std::chrono::steady_clock::now();
+                    cost = std::min(
+                      cost, std::chrono::duration<double>(end - start).count());
+                }
+                cost_list.push_back(cost);
+            }
+            return cost_list;
+        }
+
+    } // namespace
+
+    std::unique_ptr<pipeline_model_core> make_pipeline_model_core(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      std::unordered_map<std::string, array_profile> const&
+        output_profile_table,
+      menoh_impl::model_data const& model_data,
+      pipeline_config const& config,
+      stage_core_factory const& make_stage_core) {
+        auto node_list = make_graph(model_data.node_list).node_list();
+        int node_num = static_cast<int>(node_list.size());
+        if(node_num < config.stage_num) {
+            throw invalid_backend_config_error(
+              "\"pipeline_stage_num\" is larger than the number of nodes: " +
+              std::to_string(config.stage_num) + " > " +
+              std::to_string(node_num));
+        }
+
+        // profiles of all variables computed or given
+        auto profile_table = output_profile_table;
+        for(auto const& p : input_table) {
+            profile_table.emplace(
+              p.first, array_profile(p.second.dtype(), p.second.dims()));
+        }
+
+        auto cut_point_list = config.cut_point_list;
+        if(cut_point_list.empty()) {
+            cut_point_list = balance_cut_point_list(
+              measure_node_cost_list(model_data, node_list, profile_table,
+                                     make_stage_core),
+              config.stage_num);
+        }
+        std::vector<int> boundary_list{0};
+        boundary_list.insert(boundary_list.end(), cut_point_list.begin(),
+                             cut_point_list.end());
+        boundary_list.push_back(node_num);
+        for(unsigned int i = 1; i < boundary_list.size(); ++i) {
+            if(boundary_list.at(i) <= boundary_list.at(i - 1)) {
+                throw invalid_backend_config_error(
+                  "\"pipeline_cut_points\" must be increasing node indices "
+                  "in (0, " +
+                  std::to_string(node_num) + ")");
+            }
+        }
+
+        // variables used by stage i or later
+        std::vector<std::set<std::string>> used_name_set_list(
+          config.stage_num + 1);
+        for(auto const& p : required_output_table) {
+            used_name_set_list.at(config.stage_num).insert(p.first);
+        }
+        for(int i = config.stage_num - 1; 0 <= i; --i) {
+            used_name_set_list.at(i) = used_name_set_list.at(i + 1);
+            auto first = node_list.begin() + boundary_list.at(i);
+            auto last = node_list.begin() + boundary_list.at(i + 1);
+            auto input_name_set =
+              extract_all_input_name_set(std::vector<node>(first, last));
+            used_name_set_list.at(i).insert(input_name_set.begin(),
+                                            input_name_set.end());
+        }
+
+        std::vector<pipeline_model_core::stage> stage_list(config.stage_num);
+        stage_list.front().arriving_table = input_table;
+        std::set<std::string> available_name_set;
+        for(auto const& p : input_table) {
+            available_name_set.insert(p.first);
+        }
+        for(int i = 0; i < config.stage_num; ++i) {
+            auto& stage = stage_list.at(i);
+            auto is_last = i + 1 == config.stage_num;
+            auto first = node_list.begin() + boundary_list.at(i);
+            auto last = node_list.begin() + boundary_list.at(i + 1);
+            auto stage_model_data =
+              make_stage_model_data(model_data, first, last);
+            std::vector<node> stage_node_list(first, last);
+            auto input_name_set = extract_all_input_name_set(stage_node_list);
+            auto output_name_set =
+              extract_all_output_name_set(stage_node_list);
+            available_name_set.insert(output_name_set.begin(),
+                                      output_name_set.end());
+
+            std::unordered_map<std::string, array> core_input_table;
+            for(auto const& p : stage.arriving_table) {
+                if(input_name_set.find(p.first) != input_name_set.end()) {
+                    core_input_table.insert(p);
+                }
+            }
+
+            // variables sent to the next stage. After the last stage they
+            // are written to the required outputs
+            std::unordered_map<std::string, array> next_arriving_table;
+            if(is_last) {
+                next_arriving_table = required_output_table;
+            } else {
+                for(auto const& name : used_name_set_list.at(i + 1)) {
+                    if(available_name_set.find(name) !=
+                       available_name_set.end()) {
+                        next_arriving_table.emplace(
+                          name, array(profile_table.at(name)));
+                    }
+                }
+            }
+
+            std::unordered_map<std::string, array> core_output_table;
+            for(auto const& p : next_arriving_table) {
+                if(output_name_set.find(p.first) != output_name_set.end()) {
+                    // outputs of the last stage are written directly
+                    core_output_table.emplace(
+                      p.first,
+                      is_last ? p.second : array(profile_table.at(p.first)));
+                    if(!is_last) {
+                        stage.forward_list.emplace_back(
+                          core_output_table.at(p.first), p.second);
+                    }
+                } else {
+                    stage.forward_list.emplace_back(
+                      stage.arriving_table.at(p.first), p.second);
+                }
+            }
+
+            stage.core = make_stage_core(stage_model_data, core_input_table,
+                                         core_output_table, i);
+            if(!is_last) {
+                stage_list.at(i + 1).arriving_table =
+                  std::move(next_arriving_table);
+            }
+        }
+        return std::make_unique<pipeline_model_core>(std::move(stage_list));
+    }
+
+} // namespace menoh_impl
@@ -0,0 +1,99 @@
+#ifndef MENOH_PIPELINE_HPP
+#define MENOH_PIPELINE_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <menoh/array.hpp>
+#include <menoh/backend_config.hpp>
+#include <menoh/model_core.hpp>
+#include <menoh/model_data.hpp>
+#include <menoh/optional.hpp>
+
+namespace menoh_impl {
+
+    // "pipeline_stage_num" and "pipeline_cut_points" in backend config.
+    // Cut points are indices of the first nodes of stages except the first
+    // one in topological order. Empty when they are chosen by measurement
+    struct pipeline_config {
+        int stage_num;
+        std::vector<int> cut_point_list;
+    };
+
+    // nullopt when "pipeline_stage_num" is not given or 1
+    optional<pipeline_config> parse_pipeline_config(std::string const& config);
+
+    // Splits costs of nodes into `stage_num` contiguous ranges minimizing
+    // the largest sum of costs and returns their cut points
+    std::vector<int>
+    balance_cut_point_list(std::vector<double> const& cost_list,
+                           int stage_num);
+
+    // Runs contiguous ranges of nodes as stages. Each stage is a model core
+    // built on its own group of cpus. Variables used by later stages are
+    // copied from a stage to the next one after it runs, so a stage can run
+    // the next batch while the next stage runs the current one
+    class pipeline_model_core final : public model_core {
+    public:
+        struct stage {
+            std::unique_ptr<model_core> core;
+
+            // variables arriving at the stage. Inputs of core are some of
+            // them
+            std::unordered_map<std::string, array> arriving_table;
+
+            // variables copied to arriving_table of the next stage (or to
+            // the required outputs after the last stage) and their sources
+            std::vector<std::pair<array, array>> forward_list;
+        };
+
+        explicit pipeline_model_core(std::vector<stage> stage_list)
+          : stage_list_(std::move(stage_list)) {}
+
+        // Batches are streamed through stages running on their own threads.
+        // `prepare` and `finish` take batch index and 0 as stream index.
+        // `prepare` is called on the thread of the first stage and `finish`
+        // on the thread of the last stage
+        void run_batches(
+          int batch_num, std::function<void(int, int)> const& prepare,
+          std::function<void(int, int)> const& finish);
+
+        int stage_num() const { return static_cast<int>(stage_list_.size()); }
+
+    private:
+        virtual void do_run(run_control const* control) override;
+        virtual void
+        do_set_profiler(std::shared_ptr<profiler> const& profiler) override;
+        virtual std::shared_ptr<profiler> do_get_profiler() const override;
+        virtual void
+        do_collect_memory_stats(memory_stats& stats) const override;
+
+        void forward(int stage_index);
+
+        std::vector<stage> stage_list_;
+    };
+
+    // Builds stages with `make_stage_core`, which takes model data of the
+    // stage, its input and output tables and the index of the stage.
+    // `input_table` and `required_output_table` are the inputs of the
+    // first stage and the outputs of the last stage
+    std::unique_ptr<pipeline_model_core> make_pipeline_model_core(
+      std::unordered_map<std::string, array> const& input_table,
+      std::unordered_map<std::string, array> const& required_output_table,
+      std::unordered_map<std::string, array_profile> const&
+        output_profile_table,
+      menoh_impl::model_data const& model_data,
+      pipeline_config const& config,
+      std::function<std::unique_ptr<model_core>(
+        menoh_impl::model_data const&,
+        std::unordered_map<std::string, array> const&,
+        std::unordered_map<std::string, array> const&, int)> const&
+        make_stage_core);
+
+} // namespace menoh_impl
+
+#endif // MENOH_PIPELINE_HPP
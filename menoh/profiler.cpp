@@ -0,0 +1,96 @@
+#include <menoh/profiler.hpp>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <menoh/json.hpp>
+
+namespace menoh_impl {
+
+    void profiler::record(profile_event_info const& info,
+                          clock::time_point start, clock::time_point end) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_list_.push_back(
+          event{&info, start, end, std::this_thread::get_id()});
+    }
+
+    std::string profiler::to_chrome_trace() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto to_microseconds = [](clock::duration d) {
+            return std::chrono::duration<double, std::micro>(d).count();
+        };
+
+        // threads are numbered in order of their first event
+        std::unordered_map<std::thread::id, int> thread_index_table;
+        auto trace_event_list = nlohmann::json::array();
+        for(auto const& e : event_list_) {
+            auto found = thread_index_table.find(e.thread_id);
+            if(found == thread_index_table.end()) {
+                found =
+                  thread_index_table
+                    .emplace(e.thread_id,
+                             static_cast<int>(thread_index_table.size()))
+                    .first;
+            }
+            nlohmann::json trace_event;
+            trace_event["name"] = e.info->name;
+            trace_event["cat"] = e.info->op_type;
+            trace_event["ph"] = "X";
+            trace_event["ts"] = to_microseconds(e.start - start_time_);
+            trace_event["dur"] = to_microseconds(e.end - e.start);
+            trace_event["pid"] = 0;
+            trace_event["tid"] = found->second;
+            trace_event["args"] = {{"op_type", e.info->op_type},
+                                   {"context", e.info->context_name},
+                                   {"input_dims", e.info->input_dims_list},
+                                   {"output_dims", e.info->output_dims_list},
+                                   {"input_formats", e.info->input_format_list},
+                                   {"output_formats",
+                                    e.info->output_format_list}};
+            trace_event_list.push_back(trace_event);
+        }
+        nlohmann::json trace;
+        trace["traceEvents"] = trace_event_list;
+        trace["displayTimeUnit"] = "ms";
+        return trace.dump();
+    }
+
+    std::string profiler::to_op_type_summary() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        struct op_type_total {
+            int count = 0;
+            std::chrono::duration<double, std::micro> time{0.};
+        };
+        std::map<std::string, op_type_total> total_table;
+        std::chrono::duration<double, std::micro> total_time{0.};
+        for(auto const& e : event_list_) {
+            auto& total = total_table[e.info->op_type];
+            ++total.count;
+            total.time += e.end - e.start;
+            total_time += e.end - e.start;
+        }
+
+        std::vector<std::pair<std::string, op_type_total>> total_list(
+          total_table.begin(), total_table.end());
+        std::stable_sort(total_list.begin(), total_list.end(),
+                         [](auto const& a, auto const& b) {
+                             return a.second.time > b.second.time;
+                         });
+        std::ostringstream oss;
+        oss << "op_type\tcount\ttotal_us\taverage_us\tratio\n";
+        for(auto const& p : total_list) {
+            auto const& total = p.second;
+            oss << p.first << "\t" << total.count << "\t"
+                << total.time.count() << "\t"
+                << total.time.count() / total.count << "\t"
+                << (total_time.count() == 0.
+                      ? 0.
+                      : total.time.count() / total_time.count())
+                << "\n";
+        }
+        return oss.str();
+    }
+
+} // namespace menoh_impl
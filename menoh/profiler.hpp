@@ -0,0 +1,62 @@
+#ifndef MENOH_PROFILER_HPP
+#define MENOH_PROFILER_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace menoh_impl {
+
+    // what a profiled procedure runs. Owned by the model core which records
+    // it and alive as long as the core
+    struct profile_event_info {
+        std::string name; // first output name of the first node
+        std::string op_type;
+        std::string context_name;
+        std::vector<std::vector<int>> input_dims_list;
+        std::vector<std::vector<int>> output_dims_list;
+
+        // memory formats (e.g. "nChw8c") of inputs and outputs. Empty when
+        // the backend does not know them
+        std::vector<std::string> input_format_list;
+        std::vector<std::string> output_format_list;
+    };
+
+    // Collects start and end times of procedures. Cores record into it from
+    // any thread while it is attached to them
+    class profiler {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        profiler() : start_time_(clock::now()) {}
+
+        void record(profile_event_info const& info, clock::time_point start,
+                    clock::time_point end);
+
+        // Chrome trace_event JSON. Timestamps are microseconds since the
+        // profiler was made
+        std::string to_chrome_trace() const;
+
+        // tab separated table of the number of events, total and average
+        // time and ratio of total time for each op_type, sorted by total
+        // time
+        std::string to_op_type_summary() const;
+
+    private:
+        struct event {
+            profile_event_info const* info;
+            clock::time_point start;
+            clock::time_point end;
+            std::thread::id thread_id;
+        };
+
+        clock::time_point start_time_;
+        mutable std::mutex mutex_;
+        std::vector<event> event_list_;
+    };
+
+} // namespace menoh_impl
+
+#endif // MENOH_PROFILER_HPP
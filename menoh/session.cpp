@@ -0,0 +1,215 @@
+#include <menoh/session.hpp>
+
+#include <menoh/exception.hpp>
+#include <menoh/json.hpp>
+
+namespace menoh_impl {
+
+    namespace {
+        // times a worker retries to take a request before sleeping
+        constexpr int spin_num = 1000;
+    } // namespace
+
+    std::size_t parse_session_queue_capacity(std::string const& config) {
+        if(config.empty()) {
+            return 1024;
+        }
+        try {
+            auto c = nlohmann::json::parse(config);
+            if(c.find("session_queue_capacity") == c.end()) {
+                return 1024;
+            }
+            auto capacity = c["session_queue_capacity"].get<int>();
+            if(capacity < 1) {
+                throw invalid_backend_config_error(
+                  "invalid value of \"session_queue_capacity\": " +
+                  std::to_string(capacity));
+            }
+            return static_cast<std::size_t>(capacity);
+        } catch(nlohmann::json::parse_error const& e) {
+            throw json_parse_error(e.what());
+        }
+    }
+
+    int parse_session_warmup_iteration_num(std::string const& config) {
+        if(config.empty()) {
+            return 1;
+        }
+        try {
+            auto c = nlohmann::json::parse(config);
+            if(c.find("session_warmup_iteration_num") == c.end()) {
+                return 1;
+            }
+            auto iteration_num = c["session_warmup_iteration_num"].get<int>();
+            if(iteration_num < 0) {
+                throw invalid_backend_config_error(
+                  "invalid value of \"session_warmup_iteration_num\": " +
+                  std::to_string(iteration_num));
+            }
+            return iteration_num;
+        } catch(nlohmann::json::parse_error const& e) {
+            throw json_parse_error(e.what());
+        }
+    }
+
+    session::session(std::vector<model_stream> replica_list,
+                     std::size_t queue_capacity, int warmup_iteration_num)
+      : replica_list_(std::move(replica_list)), queue_(queue_capacity) {
+        for(int i = 0; i < replica_num(); ++i) {
+            worker_list_.emplace_back(
+              [this, i, warmup_iteration_num]() {
+                  work(i, warmup_iteration_num);
+              });
+        }
+
+        // waits for warm-up of all replicas. The destructor is not called
+        // when the constructor throws, so workers are stopped here
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(
+              lock, [this]() { return warmed_replica_num_ == replica_num(); });
+            exception = warmup_exception_;
+        }
+        if(exception) {
+            stop();
+            std::rethrow_exception(exception);
+        }
+        start_time_ = std::chrono::steady_clock::now();
+    }
+
+    session::~session() { stop(); }
+
+    void session::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_stopped_ = true;
+        }
+        work_cv_.notify_all();
+        for(auto& worker : worker_list_) {
+            worker.join();
+        }
+    }
+
+    void session::submit(request r) {
+        auto p = std::make_unique<request>(std::move(r));
+        ++submitted_num_;
+        ++pending_num_;
+        while(!queue_.try_push(p)) {
+            std::this_thread::yield();
+        }
+        // a worker going to sleep sees pending_num_ after increasing
+        // sleeping_num_, so either it does not sleep or it is notified
+        if(0 < sleeping_num_.load()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            work_cv_.notify_one();
+        }
+    }
+
+    void session::wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++waiting_num_;
+        done_cv_.wait(lock, [this]() {
+            return completed_num_.load() == submitted_num_.load();
+        });
+        --waiting_num_;
+        if(callback_exception_) {
+            auto exception = callback_exception_;
+            callback_exception_ = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    double session::utilization() const {
+        auto elapsed = std::chrono::duration<double, std::nano>(
+                         std::chrono::steady_clock::now() - start_time_)
+                         .count();
+        return busy_nanoseconds_.load() / (elapsed * replica_num());
+    }
+
+    void session::work(int replica_index, int warmup_iteration_num) {
+        auto& replica = replica_list_.at(replica_index);
+
+        // replicas are warmed on their workers, which run them later, so
+        // that OpenMP threads and thread local buffers of backends are ready
+        {
+            std::exception_ptr exception;
+            try {
+                warm_up_stream(replica, warmup_iteration_num);
+            } catch(...) {
+                exception = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(exception && !warmup_exception_) {
+                    warmup_exception_ = exception;
+                }
+                ++warmed_replica_num_;
+            }
+            done_cv_.notify_all();
+        }
+
+        while(true) {
+            std::unique_ptr<request> r;
+            bool is_popped = false;
+            for(int i = 0; i < spin_num && !is_popped; ++i) {
+                is_popped = queue_.try_pop(r);
+                if(!is_popped && 0 < pending_num_.load()) {
+                    // a producer has not finished pushing yet
+                    std::this_thread::yield();
+                }
+            }
+            if(!is_popped) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ++sleeping_num_;
+                work_cv_.wait(lock, [this]() {
+                    return 0 < pending_num_.load() || is_stopped_;
+                });
+                --sleeping_num_;
+                if(is_stopped_ && pending_num_.load() == 0) {
+                    return;
+                }
+                continue;
+            }
+            --pending_num_;
+
+            auto start = std::chrono::steady_clock::now();
+            std::exception_ptr exception;
+            try {
+                if(r->prepare) {
+                    r->prepare(replica_index);
+                }
+                replica.core->run();
+            } catch(...) {
+                exception = std::current_exception();
+            }
+            // an exception thrown by the callback is rethrown by wait() not
+            // to terminate the worker
+            if(r->finish) {
+                try {
+                    r->finish(replica_index, exception);
+                } catch(...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if(!callback_exception_) {
+                        callback_exception_ = std::current_exception();
+                    }
+                }
+            }
+            busy_nanoseconds_ +=
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+
+            ++completed_num_;
+            if(0 < waiting_num_.load()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                }
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+} // namespace menoh_impl
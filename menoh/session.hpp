@@ -0,0 +1,113 @@
+#ifndef MENOH_SESSION_HPP
+#define MENOH_SESSION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <menoh/mpmc_queue.hpp>
+#include <menoh/multi_stream.hpp>
+
+namespace menoh_impl {
+
+    // "session_queue_capacity" in backend config. 1024 when it is not given
+    std::size_t parse_session_queue_capacity(std::string const& config);
+
+    // "session_warmup_iteration_num" in backend config. 1 when it is not
+    // given
+    int parse_session_warmup_iteration_num(std::string const& config);
+
+    // Runs requests on a pool of replicas of a model. Requests are put into
+    // a lock-free queue and each replica has a worker thread taking them.
+    // Workers spin for a while and then sleep when the queue is empty
+    class session {
+    public:
+        struct request {
+            // fills inputs of the replica. Called on its worker. An
+            // exception thrown by it is passed to `finish`
+            std::function<void(int replica_index)> prepare;
+
+            // reads outputs of the replica. The exception is null when the
+            // request succeeded. An exception thrown by it is rethrown by
+            // wait()
+            std::function<void(int replica_index, std::exception_ptr)>
+              finish;
+        };
+
+        // Each worker warms its replica up with warm_up_stream() before
+        // taking requests. The constructor waits for it and rethrows the
+        // first exception of warm-up
+        session(std::vector<model_stream> replica_list,
+                std::size_t queue_capacity, int warmup_iteration_num);
+
+        // waits for all submitted requests
+        ~session();
+
+        session(session const&) = delete;
+        session& operator=(session const&) = delete;
+
+        // waits for a free slot when the queue is full
+        void submit(request r);
+
+        // Blocks until all submitted requests finish. Rethrows the first
+        // exception thrown by `finish` callbacks since the last call
+        void wait();
+
+        int replica_num() const {
+            return static_cast<int>(replica_list_.size());
+        }
+        model_stream const& replica(int replica_index) const {
+            return replica_list_.at(replica_index);
+        }
+
+        // number of requests submitted and not taken by workers yet
+        int queue_depth() const { return pending_num_.load(); }
+
+        std::int64_t completed_request_num() const {
+            return completed_num_.load();
+        }
+
+        // ratio of time replicas spent in requests since the session started
+        double utilization() const;
+
+    private:
+        void work(int replica_index, int warmup_iteration_num);
+
+        // stops workers after all submitted requests
+        void stop();
+
+        std::vector<model_stream> replica_list_;
+        mpmc_queue<std::unique_ptr<request>> queue_;
+
+        std::atomic<int> pending_num_{0};
+        std::atomic<std::int64_t> submitted_num_{0};
+        std::atomic<std::int64_t> completed_num_{0};
+        std::atomic<std::int64_t> busy_nanoseconds_{0};
+        std::chrono::steady_clock::time_point start_time_;
+
+        // for sleeping workers and waiters of wait()
+        std::mutex mutex_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        std::atomic<int> sleeping_num_{0};
+        std::atomic<int> waiting_num_{0};
+        bool is_stopped_ = false;
+        int warmed_replica_num_ = 0;
+        std::exception_ptr warmup_exception_;
+        std::exception_ptr callback_exception_;
+
+        std::vector<std::thread> worker_list_;
+    };
+
+} // namespace menoh_impl
+
+#endif // MENOH_SESSION_HPP
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include <menoh/array.hpp>
@@ -32,5 +34,34 @@ namespace menoh_impl {
             ASSERT_EQ(arr2.data(), data.data());
         }
 
+        TEST_F(ArrayTest, test_float16_and_bfloat16_conversion) {
+            std::vector<float> values{0.f, -0.f, 1.f, -2.5f, 65504.f,
+                                      6.103515625e-05f, 5.9604645e-08f};
+            for(auto v : values) {
+                EXPECT_EQ(float16_to_float(float_to_float16(v)), v);
+                EXPECT_EQ(bfloat16_to_float(float_to_bfloat16(v)),
+                          v == 65504.f ? 65536.f : v);
+            }
+            // rounded to nearest even
+            EXPECT_EQ(float16_to_float(float_to_float16(1.f + 1.f / 2048)),
+                      1.f);
+            EXPECT_EQ(float16_to_float(float_to_float16(1.f + 3.f / 2048)),
+                      1.f + 4.f / 2048);
+            EXPECT_TRUE(std::isinf(float16_to_float(float_to_float16(1e5f))));
+        }
+
+        TEST_F(ArrayTest, test_to_float_array) {
+            std::vector<std::uint16_t> data{float_to_float16(0.5f),
+                                            float_to_float16(-3.f)};
+            array arr(dtype_t::float16, {2}, data.data());
+            auto float_arr = to_float_array(arr);
+            ASSERT_EQ(float_arr.dtype(), dtype_t::float_);
+            EXPECT_EQ(fat(float_arr, 0), 0.5f);
+            EXPECT_EQ(fat(float_arr, 1), -3.f);
+
+            array float_arr2(dtype_t::float_, {2});
+            ASSERT_EQ(to_float_array(float_arr2).data(), float_arr2.data());
+        }
+
     } // namespace
 } // namespace menoh_impl
@@ -30,6 +30,72 @@ namespace {
           std::vector<int>({3, 3}));
     }
 
+    TEST_F(AttributeCompletionAndShapeInferenceTest, grouped_conv_check) {
+        menoh_impl::model_data model_data;
+        model_data.node_list.push_back(menoh_impl::node{
+          "Conv", {"x", "w"}, {"y"}, {{"group", 4}}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "x",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {1, 8, 5, 5}));
+        input_profile_table.emplace(
+          "w", menoh_impl::array_profile(menoh_impl::dtype_t::float_,
+                                         {12, 2, 3, 3}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y").dims(),
+                                   std::vector<int>({1, 12, 3, 3}));
+
+        model_data.node_list.at(0).attribute_table["group"] = 2;
+        EXPECT_THROW(menoh_impl::complete_attribute_and_infer_shape(
+                       model_data, input_profile_table),
+                     menoh_impl::dimension_mismatch);
+    }
+
+    TEST_F(AttributeCompletionAndShapeInferenceTest,
+           conv_transpose_completion) {
+        menoh_impl::model_data model_data;
+        model_data.node_list.push_back(
+          menoh_impl::node{"ConvTranspose",
+                           {"x", "w"},
+                           {"y"},
+                           {{"strides", std::vector<int>{3, 2}}}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "x",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {1, 1, 3, 3}));
+        input_profile_table.emplace(
+          "w",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {1, 2, 3, 3}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y").dims(),
+                                   std::vector<int>({1, 2, 9, 7}));
+        auto const& node = model_data.node_list.at(0);
+        menoh_impl::assert_eq_list(menoh_impl::attribute_ints(node, "pads"),
+                                   std::vector<int>({0, 0, 0, 0}));
+        menoh_impl::assert_eq_list(
+          menoh_impl::attribute_ints(node, "dilations"),
+          std::vector<int>({1, 1}));
+
+        // weight is (C_in, C_out/group, kh, kw) and output_padding is added
+        // to the end of spatial axes
+        model_data.node_list.at(0).attribute_table = {
+          {"strides", std::vector<int>{2, 2}},
+          {"group", 2},
+          {"output_padding", std::vector<int>{1, 0}}};
+        input_profile_table.at("x") =
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {1, 4, 3, 3});
+        input_profile_table.at("w") =
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {4, 3, 3, 3});
+        profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y").dims(),
+                                   std::vector<int>({1, 6, 8, 7}));
+    }
+
     TEST_F(AttributeCompletionAndShapeInferenceTest, sum_check) {
         menoh_impl::model_data model_data;
         model_data.node_list.push_back(
@@ -62,4 +128,145 @@ namespace {
           model_data, input_profile_table));
     }
 
+    TEST_F(AttributeCompletionAndShapeInferenceTest, reduce_mean_check) {
+        menoh_impl::model_data model_data;
+        model_data.node_list.push_back(menoh_impl::node{
+          "ReduceMean", {"x"}, {"y0"}, {{"axes", std::vector<int>{1, -1}}}});
+        model_data.node_list.push_back(
+          menoh_impl::node{"ReduceMean",
+                           {"x"},
+                           {"y1"},
+                           {{"axes", std::vector<int>{1, -1}},
+                            {"keepdims", 0}}});
+        model_data.node_list.push_back(
+          menoh_impl::node{"ReduceMean", {"x"}, {"y2"}, {}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "x",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {2, 3, 4, 5}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y0").dims(),
+                                   std::vector<int>({2, 1, 4, 1}));
+        menoh_impl::assert_eq_list(profile_table.at("y1").dims(),
+                                   std::vector<int>({2, 4}));
+        menoh_impl::assert_eq_list(profile_table.at("y2").dims(),
+                                   std::vector<int>({1, 1, 1, 1}));
+    }
+
+    TEST_F(AttributeCompletionAndShapeInferenceTest, matmul_check) {
+        menoh_impl::model_data model_data;
+        model_data.node_list.push_back(
+          menoh_impl::node{"MatMul", {"a", "b"}, {"y0"}, {}});
+        model_data.node_list.push_back(
+          menoh_impl::node{"MatMul", {"v", "b"}, {"y1"}, {}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "a",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {2, 1, 3, 4}));
+        input_profile_table.emplace(
+          "b",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {5, 4, 6}));
+        input_profile_table.emplace(
+          "v", menoh_impl::array_profile(menoh_impl::dtype_t::float_, {4}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y0").dims(),
+                                   std::vector<int>({2, 5, 3, 6}));
+        menoh_impl::assert_eq_list(profile_table.at("y1").dims(),
+                                   std::vector<int>({5, 6}));
+    }
+
+    TEST_F(AttributeCompletionAndShapeInferenceTest, resize_completion) {
+        menoh_impl::model_data model_data;
+        std::vector<float> scales{1.f, 1.f, 2.f, 1.5f};
+        std::vector<int64_t> sizes{1, 3, 7, 9};
+        model_data.parameter_name_and_array_list.push_back(
+          {"scales", menoh_impl::array(menoh_impl::dtype_t::float_, {4},
+                                       scales.data())});
+        model_data.parameter_name_and_array_list.push_back(
+          {"sizes", menoh_impl::array(menoh_impl::dtype_t::int64, {4},
+                                      sizes.data())});
+        model_data.node_list.push_back(
+          menoh_impl::node{"Upsample", {"x", "scales"}, {"y"}, {}});
+        model_data.node_list.push_back(
+          menoh_impl::node{"Resize", {"y", "", "", "sizes"}, {"z"}, {}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "x",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {1, 3, 4, 5}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y").dims(),
+                                   std::vector<int>({1, 3, 8, 7}));
+        menoh_impl::assert_eq_list(profile_table.at("z").dims(),
+                                   std::vector<int>({1, 3, 7, 9}));
+
+        // scales and sizes are taken into attributes
+        auto const& upsample = model_data.node_list.at(0);
+        EXPECT_EQ(upsample.input_name_list.size(), 1);
+        EXPECT_EQ(menoh_impl::attribute_string(upsample, "mode"), "nearest");
+        EXPECT_EQ(menoh_impl::attribute_string(
+                    upsample, "coordinate_transformation_mode"),
+                  "asymmetric");
+        auto const& resize = model_data.node_list.at(1);
+        EXPECT_EQ(resize.input_name_list.size(), 1);
+        EXPECT_EQ(menoh_impl::attribute_string(
+                    resize, "coordinate_transformation_mode"),
+                  "half_pixel");
+        EXPECT_EQ(menoh_impl::attribute_string(resize, "nearest_mode"),
+                  "round_prefer_floor");
+    }
+
+    TEST_F(AttributeCompletionAndShapeInferenceTest, split_slice_completion) {
+        menoh_impl::model_data model_data;
+        std::vector<int64_t> starts{1, -3};
+        std::vector<int64_t> ends{std::numeric_limits<int64_t>::max(), -1};
+        std::vector<int64_t> axes{0, 2};
+        model_data.parameter_name_and_array_list.push_back(
+          {"starts", menoh_impl::array(menoh_impl::dtype_t::int64, {2},
+                                       starts.data())});
+        model_data.parameter_name_and_array_list.push_back(
+          {"ends", menoh_impl::array(menoh_impl::dtype_t::int64, {2},
+                                     ends.data())});
+        model_data.parameter_name_and_array_list.push_back(
+          {"axes", menoh_impl::array(menoh_impl::dtype_t::int64, {2},
+                                     axes.data())});
+        model_data.node_list.push_back(
+          menoh_impl::node{"Split", {"x"}, {"y0", "y1"}, {}});
+        model_data.node_list.push_back(
+          menoh_impl::node{"Split",
+                           {"x"},
+                           {"z0", "z1"},
+                           {{"axis", 1}, {"split", std::vector<int>{2, 4}}}});
+        model_data.node_list.push_back(menoh_impl::node{
+          "Slice", {"x", "starts", "ends", "axes"}, {"w"}, {}});
+        std::unordered_map<std::string, menoh_impl::array_profile>
+          input_profile_table;
+        input_profile_table.emplace(
+          "x",
+          menoh_impl::array_profile(menoh_impl::dtype_t::float_, {4, 6, 5}));
+        auto profile_table = menoh_impl::complete_attribute_and_infer_shape(
+          model_data, input_profile_table);
+        menoh_impl::assert_eq_list(profile_table.at("y0").dims(),
+                                   std::vector<int>({2, 6, 5}));
+        menoh_impl::assert_eq_list(profile_table.at("y1").dims(),
+                                   std::vector<int>({2, 6, 5}));
+        menoh_impl::assert_eq_list(profile_table.at("z0").dims(),
+                                   std::vector<int>({4, 2, 5}));
+        menoh_impl::assert_eq_list(profile_table.at("z1").dims(),
+                                   std::vector<int>({4, 4, 5}));
+        menoh_impl::assert_eq_list(profile_table.at("w").dims(),
+                                   std::vector<int>({3, 6, 2}));
+
+        // starts, ends and axes are taken into attributes
+        auto const& slice = model_data.node_list.at(2);
+        EXPECT_EQ(slice.input_name_list.size(), 1);
+        menoh_impl::assert_eq_list(menoh_impl::attribute_ints(slice, "steps"),
+                                   std::vector<int>({1, 1}));
+    }
+
 } // namespace
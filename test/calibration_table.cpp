@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <menoh/calibration_table.hpp>
+
+namespace menoh_impl {
+    namespace {
+
+        class CalibrationTableTest : public ::testing::Test {};
+
+        TEST_F(CalibrationTableTest, update_per_channel_range) {
+            // (2, 2, 2) array. channel 0 is in [-1, 4], channel 1 is in
+            // [0, 40]
+            std::vector<float> data{-1, 2, 0, 10, 4, 3, 20, 40};
+            array arr(dtype_t::float_, {2, 2, 2}, data.data());
+            calibration_table table;
+            update_calibration_table(table, "x", arr);
+            auto const& range = table.at("x");
+            EXPECT_EQ(range.min, -1.f);
+            EXPECT_EQ(range.max, 40.f);
+            EXPECT_EQ(range.channel_min_list, (std::vector<float>{-1, 0}));
+            EXPECT_EQ(range.channel_max_list, (std::vector<float>{4, 40}));
+
+            std::vector<float> data2{-5, 0, 0, 0, 0, 0, 0, 0};
+            array arr2(dtype_t::float_, {2, 2, 2}, data2.data());
+            update_calibration_table(table, "x", arr2);
+            EXPECT_EQ(table.at("x").min, -5.f);
+            EXPECT_EQ(table.at("x").max, 40.f);
+            EXPECT_EQ(table.at("x").channel_min_list,
+                      (std::vector<float>{-5, 0}));
+        }
+
+        TEST_F(CalibrationTableTest, update_with_channel_num_mismatch) {
+            calibration_table table;
+            std::vector<float> data(6);
+            update_calibration_table(
+              table, "x", array(dtype_t::float_, {1, 2, 3}, data.data()));
+            EXPECT_THROW(update_calibration_table(
+                           table, "x",
+                           array(dtype_t::float_, {1, 3, 2}, data.data())),
+                         calibration_channel_num_mismatch);
+        }
+
+        TEST_F(CalibrationTableTest, save_and_load) {
+            calibration_table table;
+            table.emplace("x", variable_range{0.f, 6.f, {0.f, 1.f},
+                                              {2.f, 6.f}});
+            std::string filename =
+              ::testing::TempDir() + "menoh_calibration_table_test.json";
+            save_calibration_table(table, filename);
+            auto loaded = load_calibration_table(filename);
+            std::remove(filename.c_str());
+            ASSERT_EQ(loaded.size(), 1);
+            auto const& range = loaded.at("x");
+            EXPECT_EQ(range.min, 0.f);
+            EXPECT_EQ(range.max, 6.f);
+            EXPECT_EQ(range.channel_min_list, (std::vector<float>{0, 1}));
+            EXPECT_EQ(range.channel_max_list, (std::vector<float>{2, 6}));
+        }
+
+        TEST_F(CalibrationTableTest, load_invalid_file) {
+            EXPECT_THROW(load_calibration_table("not_exist.json"),
+                         invalid_filename);
+        }
+
+        TEST_F(CalibrationTableTest, extract_calibration_target_name_list) {
+            model_data model_data;
+            model_data.node_list.push_back(
+              node{"Relu", {"input"}, {"relu_out"}, {}});
+            model_data.node_list.push_back(
+              node{"Conv", {"relu_out", "w1"}, {"conv_out1"}, {}});
+            model_data.node_list.push_back(
+              node{"Conv", {"input", "w2"}, {"conv_out2"}, {}});
+            model_data.node_list.push_back(
+              node{"FC", {"relu_out", "w3", "b3"}, {"fc_out"}, {}});
+            EXPECT_EQ(extract_calibration_target_name_list(model_data),
+                      (std::vector<std::string>{"relu_out"}));
+        }
+
+    } // namespace
+} // namespace menoh_impl
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <menoh/cost_estimation.hpp>
+
+namespace menoh_impl {
+    namespace {
+
+        class CostEstimationTest : public ::testing::Test {};
+
+        // Conv (with bias) -> Relu -> Reshape on (1, 3, 8, 8) input
+        TEST_F(CostEstimationTest, estimate_node_cost_list) {
+            std::vector<float> weight_data(4 * 3 * 3 * 3);
+            std::vector<float> bias_data(4);
+            model_data model_data;
+            model_data.parameter_name_and_array_list.emplace_back(
+              "weight",
+              array(dtype_t::float_, {4, 3, 3, 3}, weight_data.data()));
+            model_data.parameter_name_and_array_list.emplace_back(
+              "bias", array(dtype_t::float_, {4}, bias_data.data()));
+            model_data.node_list.push_back(
+              node{"Conv", {"input", "weight", "bias"}, {"conv_out"}, {}});
+            model_data.node_list.push_back(
+              node{"Relu", {"conv_out"}, {"relu_out"}, {}});
+            model_data.node_list.push_back(
+              node{"Reshape", {"relu_out"}, {"output"}, {}});
+
+            std::unordered_map<std::string, array_profile> profile_table{
+              {"input", array_profile(dtype_t::float_, {1, 3, 8, 8})},
+              {"weight", array_profile(dtype_t::float_, {4, 3, 3, 3})},
+              {"bias", array_profile(dtype_t::float_, {4})},
+              {"conv_out", array_profile(dtype_t::float_, {1, 4, 6, 6})},
+              {"relu_out", array_profile(dtype_t::float_, {1, 4, 6, 6})},
+              {"output", array_profile(dtype_t::float_, {1, 144})}};
+
+            auto cost_list = estimate_node_cost_list(model_data, profile_table);
+            ASSERT_EQ(cost_list.size(), 3u);
+
+            auto const& conv = cost_list.at(0);
+            EXPECT_EQ(conv.name, "conv_out");
+            EXPECT_EQ(conv.op_type, "Conv");
+            // 144 outputs, each 27 multiply-adds and a bias addition
+            EXPECT_EQ(conv.flop_num, 144 * (2 * 27 + 1));
+            EXPECT_EQ(conv.parameter_bytes, (108 + 4) * 4);
+            EXPECT_EQ(conv.activation_read_bytes, 192 * 4);
+            EXPECT_EQ(conv.activation_written_bytes, 144 * 4);
+
+            auto const& relu = cost_list.at(1);
+            EXPECT_EQ(relu.flop_num, 144);
+            EXPECT_EQ(relu.parameter_bytes, 0);
+            EXPECT_EQ(relu.activation_read_bytes, 144 * 4);
+            EXPECT_EQ(relu.activation_written_bytes, 144 * 4);
+            EXPECT_DOUBLE_EQ(arithmetic_intensity(relu), 144. / (288 * 4));
+
+            EXPECT_EQ(cost_list.at(2).flop_num, 0);
+
+            auto total = total_cost(cost_list);
+            EXPECT_EQ(total.flop_num, conv.flop_num + relu.flop_num);
+            EXPECT_EQ(total.activation_written_bytes, 3 * 144 * 4);
+
+            auto table = to_cost_table_string(cost_list);
+            EXPECT_EQ(table.find("name\top_type\tflops"), 0);
+            EXPECT_NE(table.find("conv_out\tConv\t7920\t448\t768\t576\t"),
+                      std::string::npos);
+            EXPECT_NE(table.find("total\ttotal\t"), std::string::npos);
+        }
+
+        TEST_F(CostEstimationTest, gemm_with_trans_a) {
+            model_data model_data;
+            node gemm{"Gemm", {"a", "b"}, {"c"}, {}};
+            gemm.attribute_table.emplace("transA", 1);
+            model_data.node_list.push_back(gemm);
+            std::unordered_map<std::string, array_profile> profile_table{
+              {"a", array_profile(dtype_t::float_, {5, 2})},
+              {"b", array_profile(dtype_t::float_, {5, 3})},
+              {"c", array_profile(dtype_t::float_, {2, 3})}};
+            auto cost_list = estimate_node_cost_list(model_data, profile_table);
+            EXPECT_EQ(cost_list.at(0).flop_num, 2 * 6 * 5);
+            EXPECT_EQ(cost_list.at(0).activation_read_bytes, (10 + 15) * 4);
+        }
+
+    } // namespace
+} // namespace menoh_impl
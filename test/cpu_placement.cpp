@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <menoh/cpu_placement.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace menoh_impl {
+    namespace {
+
+        class CpuPlacementTest : public ::testing::Test {};
+
+        TEST_F(CpuPlacementTest, parse_cpu_list_string) {
+            EXPECT_EQ(parse_cpu_list_string("0"), (std::vector<int>{0}));
+            EXPECT_EQ(parse_cpu_list_string("0-3,8,10-11\n"),
+                      (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+            EXPECT_EQ(parse_cpu_list_string(""), (std::vector<int>{}));
+            EXPECT_THROW(parse_cpu_list_string("0-a"),
+                         invalid_backend_config_error);
+        }
+
+        TEST_F(CpuPlacementTest, parse_cpu_placement) {
+            EXPECT_FALSE(parse_cpu_placement(""));
+            EXPECT_FALSE(parse_cpu_placement(R"({"cpu_id": 0})"));
+
+            auto placement =
+              parse_cpu_placement(R"({"thread_num": 2, "cpu_list": [0, 1]})");
+            ASSERT_TRUE(placement);
+            EXPECT_EQ(*placement->thread_num, 2);
+            EXPECT_EQ(placement->cpu_list, (std::vector<int>{0, 1}));
+            EXPECT_FALSE(placement->numa_node);
+
+            EXPECT_THROW(parse_cpu_placement(R"({"thread_num": 0})"),
+                         invalid_backend_config_error);
+            EXPECT_THROW(parse_cpu_placement(R"({"cpu_list": [-1]})"),
+                         invalid_backend_config_error);
+            EXPECT_THROW(parse_cpu_placement(R"({"numa_node": 100000})"),
+                         invalid_backend_config_error);
+        }
+
+#ifdef __linux__
+        TEST_F(CpuPlacementTest, guard_restores_affinity) {
+            cpu_set_t saved_set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(saved_set), &saved_set), 0);
+            int first_cpu = 0;
+            while(!CPU_ISSET(first_cpu, &saved_set)) {
+                ++first_cpu;
+            }
+
+            cpu_placement placement;
+            placement.thread_num = 1;
+            placement.cpu_list = {first_cpu};
+            {
+                cpu_placement_guard guard(placement);
+                cpu_set_t set;
+                ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+                EXPECT_EQ(CPU_COUNT(&set), 1);
+                EXPECT_TRUE(CPU_ISSET(first_cpu, &set));
+            }
+            cpu_set_t set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+            EXPECT_TRUE(CPU_EQUAL(&set, &saved_set));
+        }
+
+        TEST_F(CpuPlacementTest, apply_keeps_affinity) {
+            cpu_set_t saved_set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(saved_set), &saved_set), 0);
+            int first_cpu = 0;
+            while(!CPU_ISSET(first_cpu, &saved_set)) {
+                ++first_cpu;
+            }
+
+            cpu_placement placement;
+            placement.thread_num = 1;
+            placement.cpu_list = {first_cpu};
+            apply_cpu_placement(placement);
+            cpu_set_t set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+            EXPECT_EQ(CPU_COUNT(&set), 1);
+            EXPECT_TRUE(CPU_ISSET(first_cpu, &set));
+            ASSERT_EQ(sched_setaffinity(0, sizeof(saved_set), &saved_set), 0);
+        }
+
+#ifdef _OPENMP
+        TEST_F(CpuPlacementTest, guard_restores_openmp_thread_affinity) {
+            cpu_set_t saved_set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(saved_set), &saved_set), 0);
+            int first_cpu = 0;
+            while(!CPU_ISSET(first_cpu, &saved_set)) {
+                ++first_cpu;
+            }
+
+            cpu_placement placement;
+            placement.thread_num = 2;
+            placement.cpu_list = {first_cpu};
+            int pinned_thread_num = 0;
+            {
+                cpu_placement_guard guard(placement);
+#pragma omp parallel num_threads(2) reduction(+ : pinned_thread_num)
+                {
+                    cpu_set_t set;
+                    if(sched_getaffinity(0, sizeof(set), &set) == 0 &&
+                       CPU_COUNT(&set) == 1 && CPU_ISSET(first_cpu, &set)) {
+                        ++pinned_thread_num;
+                    }
+                }
+            }
+            EXPECT_EQ(pinned_thread_num, 2);
+
+            int restored_thread_num = 0;
+#pragma omp parallel num_threads(2) reduction(+ : restored_thread_num)
+            {
+                cpu_set_t set;
+                if(sched_getaffinity(0, sizeof(set), &set) == 0 &&
+                   CPU_EQUAL(&set, &saved_set)) {
+                    ++restored_thread_num;
+                }
+            }
+            EXPECT_EQ(restored_thread_num, 2);
+        }
+#endif
+#endif
+
+        TEST_F(CpuPlacementTest, prefault_memory_keeps_contents) {
+            std::vector<char> data(3 * 4096 + 5);
+            for(std::size_t i = 0; i < data.size(); ++i) {
+                data.at(i) = static_cast<char>(i % 127);
+            }
+            auto copy = data;
+            prefault_memory(data.data() + 1, data.size() - 1);
+            EXPECT_EQ(data, copy);
+        }
+
+    } // namespace
+} // namespace menoh_impl
@@ -1,7 +1,23 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
 #include <gtest/gtest.h>
 
 #include "backend.hpp"
 
+#include <menoh/pipeline.hpp>
+#include <menoh/session.hpp>
+
 namespace menoh {
     class MkldnnWithGenericFallbackBackendTest : public ::testing::Test {
     protected:
@@ -9,6 +25,107 @@ namespace menoh {
         virtual void SetUp() {}
     };
 
+    // Conv with group compared to naive implementation.
+    // input is (2, group * channel_num, 9, 11) and output has
+    // group * multiplier channels
+    inline void grouped_conv_test(std::string const& backend_name,
+                                  std::string const& backend_config,
+                                  int group, int channel_num, int multiplier,
+                                  int stride, int dilation = 1) {
+        int batch_size = 2, h = 9, w = 11, k = 3, pad = 1;
+        int c = group * channel_num;
+        int m = group * multiplier;
+        int oh = (h + 2 * pad - dilation * (k - 1) - 1) / stride + 1;
+        int ow = (w + 2 * pad - dilation * (k - 1) - 1) / stride + 1;
+
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * channel_num * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> bias_data(m);
+        for(int i = 0; i < m; ++i) {
+            bias_data.at(i) = 0.1f * i;
+        }
+
+        menoh::model_data model_data;
+        menoh::variable_profile_table_builder vpt_builder;
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        model_data.add_parameter("input", dtype_t::float_, input_dims,
+                                 input_data.data());
+        model_data.add_parameter("weight", dtype_t::float_,
+                                 {m, channel_num, k, k}, weight_data.data());
+        model_data.add_parameter("bias", dtype_t::float_, {m},
+                                 bias_data.data());
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_int_to_current_node("group", group);
+        model_data.add_attribute_ints_to_current_node("pads",
+                                                      {pad, pad, pad, pad});
+        model_data.add_attribute_ints_to_current_node("strides",
+                                                      {stride, stride});
+        model_data.add_attribute_ints_to_current_node("dilations",
+                                                      {dilation, dilation});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_input_name_to_current_node("bias");
+        model_data.add_output_name_to_current_node("output");
+        vpt_builder.add_output_name("output");
+
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        auto model =
+          model_builder.build_model(model_data, backend_name, backend_config);
+        model.run();
+
+        std::vector<float> true_output_data(batch_size * m * oh * ow);
+        for(int n = 0; n < batch_size; ++n) {
+            for(int oc = 0; oc < m; ++oc) {
+                int g = oc / multiplier;
+                for(int oy = 0; oy < oh; ++oy) {
+                    for(int ox = 0; ox < ow; ++ox) {
+                        float sum = bias_data.at(oc);
+                        for(int ic = 0; ic < channel_num; ++ic) {
+                            for(int ky = 0; ky < k; ++ky) {
+                                for(int kx = 0; kx < k; ++kx) {
+                                    int iy = oy * stride - pad + ky * dilation;
+                                    int ix = ox * stride - pad + kx * dilation;
+                                    if(iy < 0 || h <= iy || ix < 0 ||
+                                       w <= ix) {
+                                        continue;
+                                    }
+                                    sum += input_data.at(
+                                             ((n * c + g * channel_num + ic) *
+                                                h +
+                                              iy) *
+                                               w +
+                                             ix) *
+                                           weight_data.at(
+                                             ((oc * channel_num + ic) * k +
+                                              ky) *
+                                               k +
+                                             kx);
+                                }
+                            }
+                        }
+                        true_output_data.at(((n * m + oc) * oh + oy) * ow +
+                                            ox) = sum;
+                    }
+                }
+            }
+        }
+        auto output_var = model.get_variable("output");
+        menoh_impl::assert_near_list(
+          static_cast<float*>(output_var.buffer_handle),
+          static_cast<float*>(output_var.buffer_handle) +
+            true_output_data.size(),
+          true_output_data.begin(), true_output_data.end(), 10.e-5);
+    }
+
     TEST_F(MkldnnWithGenericFallbackBackendTest, gemm_1d_test) {
         gemm_test("mkldnn_with_generic_fallback", R"({"log_output": "stdout"})",
                   "../data/random_input_3_4096.txt",
@@ -134,4 +251,1624 @@ namespace menoh {
         tanh_test("mkldnn_with_generic_fallback", R"({"log_output": "stdout"})",
                   "../data/random_input_3_4096.txt", "../data/tanh_1d.txt");
     }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest,
+           generic_elementwise_fusion_test) {
+        // Relu -> Mul -> Sigmoid -> Mul is fused into one procedure
+        std::string backend_name = "composite_backend";
+        std::string backend_config =
+          R"({"backends":[{"type":"generic"}], "log_output": "stdout"})";
+        menoh::model_data model_data;
+        menoh::variable_profile_table_builder vpt_builder;
+
+        std::vector<int32_t> input_dims;
+        std::vector<float> input_data;
+        std::tie(std::ignore, input_dims, input_data) =
+          menoh_impl::load_np_array("../data/random_input_3_4096.txt");
+        std::vector<float> scale_data(input_data.size());
+        for(std::size_t i = 0; i < scale_data.size(); ++i) {
+            scale_data.at(i) = 0.25f * static_cast<float>(i % 7) - 0.5f;
+        }
+        model_data.add_parameter("input", dtype_t::float_, input_dims,
+                                 input_data.data());
+        model_data.add_parameter("scale", dtype_t::float_, input_dims,
+                                 scale_data.data());
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_output_name_to_current_node("relu_out");
+
+        model_data.add_new_node("Mul");
+        model_data.add_input_name_to_current_node("relu_out");
+        model_data.add_input_name_to_current_node("scale");
+        model_data.add_output_name_to_current_node("mul_out");
+
+        model_data.add_new_node("Sigmoid");
+        model_data.add_input_name_to_current_node("mul_out");
+        model_data.add_output_name_to_current_node("sigmoid_out");
+
+        model_data.add_new_node("Mul");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("sigmoid_out");
+        model_data.add_output_name_to_current_node("output");
+        vpt_builder.add_output_name("output");
+
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        auto model =
+          model_builder.build_model(model_data, backend_name, backend_config);
+        model.run();
+
+        std::vector<float> true_output_data(input_data.size());
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            auto x = input_data.at(i);
+            auto s = std::max(x, 0.f) * scale_data.at(i);
+            true_output_data.at(i) = x * (1.f / (1.f + std::exp(-s)));
+        }
+        auto output_var = model.get_variable("output");
+        menoh_impl::assert_near_list(
+          static_cast<float*>(output_var.buffer_handle),
+          static_cast<float*>(output_var.buffer_handle) +
+            true_output_data.size(),
+          true_output_data.begin(), true_output_data.end(), 10.e-5);
+    }
+
+    // Conv (mkldnn) -> Sigmoid -> Mul with broadcast scale like SE blocks.
+    // The chain is not fused but the output of Conv must still be reordered
+    TEST_F(MkldnnWithGenericFallbackBackendTest,
+           generic_unfusable_elementwise_chain_test) {
+        int batch_size = 2, c = 8, h = 5, w = 7, m = 16;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> scale_data(m);
+        for(int i = 0; i < m; ++i) {
+            scale_data.at(i) = 0.5f + 0.1f * i;
+        }
+
+        menoh::model_data model_data;
+        menoh::variable_profile_table_builder vpt_builder;
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, 1, 1},
+                                 weight_data.data());
+        model_data.add_parameter("scale", dtype_t::float_, {1, m, 1, 1},
+                                 scale_data.data());
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+
+        model_data.add_new_node("Conv");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+
+        model_data.add_new_node("Sigmoid");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("sigmoid_out");
+
+        model_data.add_new_node("Mul");
+        model_data.add_input_name_to_current_node("sigmoid_out");
+        model_data.add_input_name_to_current_node("scale");
+        model_data.add_output_name_to_current_node("output");
+        vpt_builder.add_output_name("output");
+
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("input", input_data.data());
+        auto model = model_builder.build_model(
+          model_data, "mkldnn_with_generic_fallback",
+          R"({"log_output": "stdout"})");
+        model.run();
+
+        std::vector<float> true_output_data(batch_size * m * h * w);
+        for(int n = 0; n < batch_size; ++n) {
+            for(int oc = 0; oc < m; ++oc) {
+                for(int i = 0; i < h * w; ++i) {
+                    float sum = 0.f;
+                    for(int ic = 0; ic < c; ++ic) {
+                        sum += input_data.at((n * c + ic) * h * w + i) *
+                               weight_data.at(oc * c + ic);
+                    }
+                    true_output_data.at((n * m + oc) * h * w + i) =
+                      scale_data.at(oc) / (1.f + std::exp(-sum));
+                }
+            }
+        }
+        auto output_var = model.get_variable("output");
+        menoh_impl::assert_near_list(
+          static_cast<float*>(output_var.buffer_handle),
+          static_cast<float*>(output_var.buffer_handle) +
+            true_output_data.size(),
+          true_output_data.begin(), true_output_data.end(), 10.e-5);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, grouped_conv_test) {
+        grouped_conv_test("mkldnn_with_generic_fallback",
+                          R"({"log_output": "stdout"})", 4, 3, 2, 1);
+        grouped_conv_test("composite_backend",
+                          R"({"backends":[{"type":"generic"}]})", 4, 3, 2, 1);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, depthwise_conv_test) {
+        grouped_conv_test("mkldnn_with_generic_fallback",
+                          R"({"log_output": "stdout"})", 8, 1, 1, 2);
+        grouped_conv_test("composite_backend",
+                          R"({"backends":[{"type":"generic"}]})", 8, 1, 1, 2);
+        grouped_conv_test("composite_backend",
+                          R"({"backends":[{"type":"generic"}]})", 8, 1, 2, 1);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, dilated_conv_test) {
+        grouped_conv_test("mkldnn_with_generic_fallback",
+                          R"({"log_output": "stdout"})", 1, 3, 4, 1, 2);
+        grouped_conv_test("mkldnn_with_generic_fallback",
+                          R"({"log_output": "stdout"})", 2, 3, 2, 2, 2);
+        grouped_conv_test("composite_backend",
+                          R"({"backends":[{"type":"mkldnn"}],)"
+                          R"("conv_autotune":true})",
+                          1, 3, 4, 1, 2);
+        grouped_conv_test("composite_backend",
+                          R"({"backends":[{"type":"generic"}]})", 1, 3, 4, 1,
+                          2);
+    }
+
+    // ConvTranspose with group and output_padding compared to naive
+    // implementation. input is (2, group * channel_num, 5, 6) and weight is
+    // (group * channel_num, multiplier, 3, 3)
+    inline void conv_transpose_test(std::string const& backend_name,
+                                    std::string const& backend_config,
+                                    int group, int channel_num, int multiplier,
+                                    int output_padding) {
+        int batch_size = 2, h = 5, w = 6, k = 3, stride = 2, pad = 1;
+        int c = group * channel_num;
+        int m = group * multiplier;
+        int oh = stride * (h - 1) + k - 2 * pad + output_padding;
+        int ow = stride * (w - 1) + k - 2 * pad + output_padding;
+
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(c * multiplier * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> bias_data(m);
+        for(int i = 0; i < m; ++i) {
+            bias_data.at(i) = 0.1f * i;
+        }
+
+        menoh::model_data model_data;
+        menoh::variable_profile_table_builder vpt_builder;
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        model_data.add_parameter("weight", dtype_t::float_,
+                                 {c, multiplier, k, k}, weight_data.data());
+        model_data.add_parameter("bias", dtype_t::float_, {m},
+                                 bias_data.data());
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+
+        model_data.add_new_node("ConvTranspose");
+        model_data.add_attribute_int_to_current_node("group", group);
+        model_data.add_attribute_ints_to_current_node("pads",
+                                                      {pad, pad, pad, pad});
+        model_data.add_attribute_ints_to_current_node("strides",
+                                                      {stride, stride});
+        model_data.add_attribute_ints_to_current_node(
+          "output_padding", {output_padding, output_padding});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_input_name_to_current_node("bias");
+        model_data.add_output_name_to_current_node("output");
+        vpt_builder.add_output_name("output");
+
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("input", input_data.data());
+        auto model =
+          model_builder.build_model(model_data, backend_name, backend_config);
+        // the weight is transformed at build time only
+        model.run();
+        model.run();
+
+        std::vector<float> true_output_data(batch_size * m * oh * ow);
+        for(int n = 0; n < batch_size; ++n) {
+            for(int oc = 0; oc < m; ++oc) {
+                std::fill_n(true_output_data.begin() + (n * m + oc) * oh * ow,
+                            oh * ow, bias_data.at(oc));
+            }
+            for(int ic = 0; ic < c; ++ic) {
+                int g = ic / channel_num;
+                for(int o = 0; o < multiplier; ++o) {
+                    int oc = g * multiplier + o;
+                    for(int iy = 0; iy < h; ++iy) {
+                        for(int ix = 0; ix < w; ++ix) {
+                            auto x =
+                              input_data.at(((n * c + ic) * h + iy) * w + ix);
+                            for(int ky = 0; ky < k; ++ky) {
+                                for(int kx = 0; kx < k; ++kx) {
+                                    int oy = iy * stride - pad + ky;
+                                    int ox = ix * stride - pad + kx;
+                                    if(oy < 0 || oh <= oy || ox < 0 ||
+                                       ow <= ox) {
+                                        continue;
+                                    }
+                                    true_output_data.at(
+                                      ((n * m + oc) * oh + oy) * ow + ox) +=
+                                      x * weight_data.at(
+                                            ((ic * multiplier + o) * k + ky) *
+                                              k +
+                                            kx);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        auto output_var = model.get_variable("output");
+        ASSERT_EQ(output_var.dims,
+                  (std::vector<int32_t>{batch_size, m, oh, ow}));
+        menoh_impl::assert_near_list(
+          static_cast<float*>(output_var.buffer_handle),
+          static_cast<float*>(output_var.buffer_handle) +
+            true_output_data.size(),
+          true_output_data.begin(), true_output_data.end(), 10.e-5);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, conv_transpose_test) {
+        for(auto backend_name : {"mkldnn", "mkldnn_with_generic_fallback"}) {
+            conv_transpose_test(backend_name, "", 1, 3, 4, 0);
+            conv_transpose_test(backend_name, "", 1, 3, 4, 1);
+            conv_transpose_test(backend_name, "", 2, 3, 2, 1);
+        }
+    }
+
+    // Gemm with float16 weight. The weight is expanded at build time or
+    // kept compressed and expanded per layer
+    inline void float16_gemm_test(std::string const& backend_name,
+                                  std::string const& backend_config) {
+        int m = 3, k = 5, n = 4;
+        std::vector<float> a_data(m * k);
+        for(std::size_t i = 0; i < a_data.size(); ++i) {
+            a_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.5f;
+        }
+        std::vector<float> b_data(n * k);
+        std::vector<std::uint16_t> b_float16_data(n * k);
+        for(std::size_t i = 0; i < b_data.size(); ++i) {
+            b_float16_data.at(i) = menoh_impl::float_to_float16(
+              static_cast<float>(i % 5) / 5.f - 0.25f);
+            b_data.at(i) = menoh_impl::float16_to_float(b_float16_data.at(i));
+        }
+        std::vector<float> c_data(n, 0.5f);
+
+        menoh::model_data model_data;
+        menoh::variable_profile_table_builder vpt_builder;
+        model_data.add_parameter("b", dtype_t::float16, {n, k},
+                                 b_float16_data.data());
+        model_data.add_parameter("c", dtype_t::float_, {n}, c_data.data());
+        vpt_builder.add_input_profile("a", dtype_t::float_, {m, k});
+        model_data.add_new_node("Gemm");
+        model_data.add_attribute_int_to_current_node("transB", 1);
+        model_data.add_input_name_to_current_node("a");
+        model_data.add_input_name_to_current_node("b");
+        model_data.add_input_name_to_current_node("c");
+        model_data.add_output_name_to_current_node("y");
+        vpt_builder.add_output_name("y");
+
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("a", a_data.data());
+        auto model =
+          model_builder.build_model(model_data, backend_name, backend_config);
+        model.run();
+
+        std::vector<float> true_output_data(m * n);
+        for(int i = 0; i < m; ++i) {
+            for(int j = 0; j < n; ++j) {
+                float sum = c_data.at(j);
+                for(int l = 0; l < k; ++l) {
+                    sum += a_data.at(i * k + l) * b_data.at(j * k + l);
+                }
+                true_output_data.at(i * n + j) = sum;
+            }
+        }
+        auto output_var = model.get_variable("y");
+        menoh_impl::assert_near_list(
+          static_cast<float*>(output_var.buffer_handle),
+          static_cast<float*>(output_var.buffer_handle) +
+            true_output_data.size(),
+          true_output_data.begin(), true_output_data.end(), 10.e-5);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, float16_gemm_test) {
+        float16_gemm_test("mkldnn_with_generic_fallback", "");
+        float16_gemm_test("mkldnn_with_generic_fallback",
+                          R"({"compressed_weight": true})");
+        float16_gemm_test("composite_backend",
+                          R"({"backends":[{"type":"generic"}],)"
+                          R"("compressed_weight": true})");
+    }
+
+    // Relu -> Conv is calibrated with f32 model and rebuilt in int8
+    TEST_F(MkldnnWithGenericFallbackBackendTest, int8_conv_test) {
+        int batch_size = 2, c = 8, h = 9, w = 11, m = 16, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> bias_data(m);
+        for(int i = 0; i < m; ++i) {
+            bias_data.at(i) = 0.1f * i;
+        }
+
+        menoh::model_data model_data;
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_parameter("bias", dtype_t::float_, {m},
+                                 bias_data.data());
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_output_name_to_current_node("relu_out");
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("relu_out");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_input_name_to_current_node("bias");
+        model_data.add_output_name_to_current_node("output");
+
+        auto run = [&](bool is_calibration, std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            if(is_calibration) {
+                vpt_builder.add_calibration_targets(model_data);
+            }
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input_data.data());
+            auto model = model_builder.build_model(
+              model_data, "composite_backend", config);
+            model.run();
+            return model;
+        };
+
+        std::string table_filename =
+          ::testing::TempDir() + "menoh_int8_conv_test_calibration_table.json";
+        {
+            auto model = run(true, R"({"backends":[{"type":"mkldnn"}]})");
+            calibration_table table;
+            table.update(model);
+            table.save(table_filename);
+        }
+        struct table_remover {
+            std::string filename;
+            ~table_remover() { std::remove(filename.c_str()); }
+        } remover{table_filename};
+        auto f32_model = run(false, R"({"backends":[{"type":"mkldnn"}]})");
+        auto int8_model =
+          run(false, R"({"backends":[{"type":"mkldnn"}],)"
+                     R"("int8_calibration_table":")" +
+                       table_filename + R"("})");
+
+        // int8 convolution keeps its plain s8 weight (1 byte per element),
+        // followed by its reordered copy if any, as packed weights. f32
+        // convolution has no such memory
+        auto quantized_weight_bytes_list = [](menoh::model const& model) {
+            std::vector<int64_t> bytes_list;
+            std::string suffix = "_quantized_weight_memory";
+            for(auto const& e : model.get_memory_stats(true).entry_list) {
+                if(suffix.size() <= e.name.size() &&
+                   e.name.compare(e.name.size() - suffix.size(),
+                                  suffix.size(), suffix) == 0) {
+                    EXPECT_EQ(e.category, memory_category_t::packed_weight);
+                    bytes_list.push_back(e.bytes);
+                }
+            }
+            return bytes_list;
+        };
+        EXPECT_TRUE(quantized_weight_bytes_list(f32_model).empty());
+        auto int8_bytes_list = quantized_weight_bytes_list(int8_model);
+        ASSERT_FALSE(int8_bytes_list.empty());
+        EXPECT_EQ(int8_bytes_list.front(), m * c * k * k);
+
+        auto f32_output_var = f32_model.get_variable("output");
+        auto int8_output_var = int8_model.get_variable("output");
+        auto size = batch_size * m * h * w;
+        auto f32_output = static_cast<float*>(f32_output_var.buffer_handle);
+        auto int8_output = static_cast<float*>(int8_output_var.buffer_handle);
+        menoh_impl::assert_near_list(int8_output, int8_output + size,
+                                     f32_output, f32_output + size, 5.e-2);
+
+        // an invalid range is an error, not a silent fallback to f32
+        {
+            std::ofstream ofs(table_filename);
+            ofs << R"({"version": 1, "variables": {"relu_out": )"
+                   R"({"min": 1, "max": 0, "channel_min": [], )"
+                   R"("channel_max": []}}})";
+        }
+        try {
+            run(false, R"({"backends":[{"type":"mkldnn"}],)"
+                       R"("int8_calibration_table":")" +
+                         table_filename + R"("})");
+            FAIL() << "invalid range is not checked";
+        } catch(menoh::error const& e) {
+            EXPECT_EQ(static_cast<menoh_error_code>(e.error_code()),
+                      menoh_error_code_invalid_backend_config_error);
+        }
+    }
+
+    // Conv tuned in mkldnn backend matches generic backend. The second
+    // model reuses choices in the tuning cache file
+    TEST_F(MkldnnWithGenericFallbackBackendTest, conv_autotune_test) {
+        int batch_size = 2, c = 8, h = 9, w = 11, m = 16, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+
+        menoh::model_data model_data;
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("output");
+
+        auto run = [&](std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input_data.data());
+            auto model = model_builder.build_model(
+              model_data, "composite_backend", config);
+            model.run();
+            return model;
+        };
+
+        std::string cache_filename =
+          ::testing::TempDir() + "menoh_conv_autotune_test_cache.json";
+        std::remove(cache_filename.c_str());
+        struct cache_remover {
+            std::string filename;
+            ~cache_remover() { std::remove(filename.c_str()); }
+        } remover{cache_filename};
+        auto read_cache = [&cache_filename] {
+            std::ifstream ifs(cache_filename);
+            return std::string(std::istreambuf_iterator<char>(ifs),
+                               std::istreambuf_iterator<char>());
+        };
+
+        auto true_model = run(R"({"backends":[{"type":"generic"}]})");
+        auto true_output_var = true_model.get_variable("output");
+        auto true_output = static_cast<float*>(true_output_var.buffer_handle);
+        auto size = batch_size * m * h * w;
+        auto tuned_config =
+          R"({"backends":[{"type":"mkldnn"}],"conv_autotune":true,)"
+          R"("conv_tuning_cache":")" +
+          cache_filename + R"("})";
+        for(int i = 0; i < 2; ++i) {
+            auto tuned_model = run(tuned_config);
+            auto output_var = tuned_model.get_variable("output");
+            auto output = static_cast<float*>(output_var.buffer_handle);
+            menoh_impl::assert_near_list(output, output + size, true_output,
+                                         true_output + size, 10.e-4);
+
+            if(i == 0) {
+                // a blank line appended to the cache is kept when the next
+                // build reuses the choice without tuning and saving again
+                auto cache = read_cache();
+                ASSERT_NE(cache.find("\"entries\""), std::string::npos);
+                std::ofstream ofs(cache_filename);
+                ofs << cache << "\n";
+            }
+        }
+        auto cache = read_cache();
+        EXPECT_EQ(cache.substr(cache.size() - 2), "\n\n");
+    }
+
+    // Tanh cannot overwrite relu_out which is used by Add later, but Add
+    // can overwrite its dead inputs. Required relu_out must be kept
+    TEST_F(MkldnnWithGenericFallbackBackendTest, inplace_eltwise_sum_test) {
+        std::vector<float> input_data(2 * 3 * 4 * 5);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 11) / 11.f - 0.5f;
+        }
+        std::vector<int32_t> input_dims{2, 3, 4, 5};
+
+        menoh::model_data model_data;
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_output_name_to_current_node("relu_out");
+        model_data.add_new_node("Tanh");
+        model_data.add_input_name_to_current_node("relu_out");
+        model_data.add_output_name_to_current_node("tanh_out");
+        model_data.add_new_node("Abs");
+        model_data.add_input_name_to_current_node("tanh_out");
+        model_data.add_output_name_to_current_node("abs_out");
+        model_data.add_new_node("Add");
+        model_data.add_input_name_to_current_node("abs_out");
+        model_data.add_input_name_to_current_node("relu_out");
+        model_data.add_output_name_to_current_node("output");
+
+        for(bool is_relu_out_required : {false, true}) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            if(is_relu_out_required) {
+                vpt_builder.add_output_name("relu_out");
+            }
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input_data.data());
+            auto model = model_builder.build_model(
+              model_data, "composite_backend",
+              R"({"backends":[{"type":"mkldnn"}]})");
+            model.run();
+
+            std::vector<float> true_relu_out(input_data.size());
+            std::vector<float> true_output(input_data.size());
+            for(std::size_t i = 0; i < input_data.size(); ++i) {
+                auto r = std::max(input_data.at(i), 0.f);
+                true_relu_out.at(i) = r;
+                true_output.at(i) = std::abs(std::tanh(r)) + r;
+            }
+            auto output_var = model.get_variable("output");
+            auto output = static_cast<float*>(output_var.buffer_handle);
+            menoh_impl::assert_near_list(output, output + true_output.size(),
+                                         true_output.begin(),
+                                         true_output.end(), 10.e-5);
+            if(is_relu_out_required) {
+                auto relu_out_var = model.get_variable("relu_out");
+                auto relu_out =
+                  static_cast<float*>(relu_out_var.buffer_handle);
+                menoh_impl::assert_near_list(
+                  relu_out, relu_out + true_relu_out.size(),
+                  true_relu_out.begin(), true_relu_out.end(), 10.e-5);
+            }
+        }
+    }
+
+    // Conv -> Upsample -> Relu. mkldnn context resizes blocked Conv output
+    // as is
+    TEST_F(MkldnnWithGenericFallbackBackendTest, upsample_test) {
+        int batch_size = 2, c = 3, h = 5, w = 7, m = 16, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        for(std::string mode : {"nearest", "linear"}) {
+            menoh::model_data model_data;
+            model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                     weight_data.data());
+            model_data.add_new_node("Conv");
+            model_data.add_attribute_ints_to_current_node("pads",
+                                                          {1, 1, 1, 1});
+            model_data.add_input_name_to_current_node("input");
+            model_data.add_input_name_to_current_node("weight");
+            model_data.add_output_name_to_current_node("conv_out");
+            model_data.add_new_node("Upsample");
+            model_data.add_attribute_string_to_current_node("mode", mode);
+            model_data.add_attribute_floats_to_current_node(
+              "scales", {1.f, 1.f, 2.f, 1.5f});
+            model_data.add_input_name_to_current_node("conv_out");
+            model_data.add_output_name_to_current_node("upsample_out");
+            model_data.add_new_node("Relu");
+            model_data.add_input_name_to_current_node("upsample_out");
+            model_data.add_output_name_to_current_node("output");
+
+            auto run = [&](std::string const& config) {
+                menoh::variable_profile_table_builder vpt_builder;
+                vpt_builder.add_input_profile("input", dtype_t::float_,
+                                              input_dims);
+                vpt_builder.add_output_name("output");
+                auto vpt =
+                  vpt_builder.build_variable_profile_table(model_data);
+                model_builder model_builder(vpt);
+                model_builder.attach_external_buffer("input",
+                                                     input_data.data());
+                auto model = model_builder.build_model(
+                  model_data, "composite_backend", config);
+                model.run();
+                return model;
+            };
+
+            auto true_model = run(R"({"backends":[{"type":"generic"}]})");
+            auto model = run(R"({"backends":[{"type":"mkldnn"}],)"
+                             R"("log_output": "stdout"})");
+            auto true_output_var = true_model.get_variable("output");
+            auto output_var = model.get_variable("output");
+            ASSERT_EQ(output_var.dims,
+                      std::vector<int32_t>({batch_size, m, 2 * h, 10}));
+            auto size = batch_size * m * 2 * h * 10;
+            auto true_output =
+              static_cast<float*>(true_output_var.buffer_handle);
+            auto output = static_cast<float*>(output_var.buffer_handle);
+            menoh_impl::assert_near_list(output, output + size, true_output,
+                                         true_output + size, 10.e-4);
+        }
+    }
+
+    // Conv -> Split and Slice. Split outputs are views of blocked Conv
+    // output and must not be overwritten by Relu. split_out1 is required
+    // and Slice along width is copied
+    TEST_F(MkldnnWithGenericFallbackBackendTest, split_slice_test) {
+        int c = 3, h = 5, w = 6, m = 32, k = 3;
+        std::vector<float> input_data(c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{1, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Split");
+        model_data.add_attribute_int_to_current_node("axis", 1);
+        model_data.add_attribute_ints_to_current_node("split", {16, 10, 6});
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("split_out0");
+        model_data.add_output_name_to_current_node("split_out1");
+        model_data.add_output_name_to_current_node("split_out2");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("split_out0");
+        model_data.add_output_name_to_current_node("output0");
+        model_data.add_new_node("Tanh");
+        model_data.add_input_name_to_current_node("split_out2");
+        model_data.add_output_name_to_current_node("output2");
+        model_data.add_new_node("Slice");
+        model_data.add_attribute_ints_to_current_node("starts", {1});
+        model_data.add_attribute_ints_to_current_node("ends", {4});
+        model_data.add_attribute_ints_to_current_node("axes", {3});
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("slice_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("slice_out");
+        model_data.add_output_name_to_current_node("output3");
+
+        std::vector<std::string> output_name_list{"output0", "split_out1",
+                                                  "output2", "output3"};
+        auto run = [&](std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            for(auto const& name : output_name_list) {
+                vpt_builder.add_output_name(name);
+            }
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input_data.data());
+            auto model = model_builder.build_model(
+              model_data, "composite_backend", config);
+            model.run();
+            return model;
+        };
+
+        auto true_model = run(R"({"backends":[{"type":"generic"}]})");
+        auto model = run(R"({"backends":[{"type":"mkldnn"}],)"
+                         R"("log_output": "stdout"})");
+        for(auto const& name : output_name_list) {
+            auto true_output_var = true_model.get_variable(name);
+            auto output_var = model.get_variable(name);
+            ASSERT_EQ(output_var.dims, true_output_var.dims);
+            auto size = std::accumulate(output_var.dims.begin(),
+                                        output_var.dims.end(), 1,
+                                        std::multiplies<int32_t>());
+            auto true_output =
+              static_cast<float*>(true_output_var.buffer_handle);
+            auto output = static_cast<float*>(output_var.buffer_handle);
+            menoh_impl::assert_near_list(output, output + size, true_output,
+                                         true_output + size, 10.e-4);
+        }
+        ASSERT_EQ(model.get_variable("output3").dims,
+                  std::vector<int32_t>({1, m, h, 3}));
+    }
+
+    // Two Conv branches from the same input run concurrently and are
+    // summed. Results must not depend on the number of inter-op workers
+    TEST_F(MkldnnWithGenericFallbackBackendTest, inter_op_dag_test) {
+        int batch_size = 2, c = 3, h = 8, w = 8, m = 16, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        for(std::string branch : {"a", "b"}) {
+            model_data.add_new_node("Conv");
+            model_data.add_attribute_ints_to_current_node("pads",
+                                                          {1, 1, 1, 1});
+            model_data.add_input_name_to_current_node("input");
+            model_data.add_input_name_to_current_node("weight");
+            model_data.add_output_name_to_current_node("conv_out_" + branch);
+            model_data.add_new_node(branch == "a" ? "Relu" : "Tanh");
+            model_data.add_input_name_to_current_node("conv_out_" + branch);
+            model_data.add_output_name_to_current_node("branch_out_" +
+                                                       branch);
+        }
+        model_data.add_new_node("Add");
+        model_data.add_input_name_to_current_node("branch_out_a");
+        model_data.add_input_name_to_current_node("branch_out_b");
+        model_data.add_output_name_to_current_node("output");
+
+        auto run = [&](std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input_data.data());
+            auto model = model_builder.build_model(
+              model_data, "composite_backend", config);
+            model.run();
+            return model;
+        };
+
+        auto true_model = run(R"({"backends":[{"type":"mkldnn"}]})");
+        auto true_output_var = true_model.get_variable("output");
+        auto size = batch_size * m * h * w;
+        auto true_output = static_cast<float*>(true_output_var.buffer_handle);
+        auto model = run(R"({"backends":[{"type":"mkldnn"}],)"
+                         R"("inter_op_thread_num":4})");
+        for(int i = 0; i < 3; ++i) {
+            model.run();
+            auto output_var = model.get_variable("output");
+            auto output = static_cast<float*>(output_var.buffer_handle);
+            menoh_impl::assert_near_list(output, output + size, true_output,
+                                         true_output + size, 10.e-4);
+        }
+    }
+
+    // mkldnn streams are submitted once and rerun, so repeated runs must
+    // give identical outputs and read current contents of input buffers.
+    // A model built with another buffer attached reads that buffer
+    TEST_F(MkldnnWithGenericFallbackBackendTest, repeated_run_test) {
+        int batch_size = 1, c = 3, h = 8, w = 8, m = 4, k = 3;
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> input_data(batch_size * c * h * w);
+        std::vector<float> other_input_data(input_data.size());
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+            other_input_data.at(i) = static_cast<float>(i % 5) / 5.f - 0.5f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        auto build = [&](std::string const& backend_name, float* input) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            model_builder.attach_external_buffer("input", input);
+            return model_builder.build_model(model_data, backend_name);
+        };
+        auto output_size = batch_size * m * h * w;
+        auto get_output = [output_size](menoh::model& model) {
+            auto output =
+              static_cast<float*>(model.get_variable("output").buffer_handle);
+            return std::vector<float>(output, output + output_size);
+        };
+
+        for(auto backend_name : {"mkldnn_with_generic_fallback", "mkldnn"}) {
+            auto input = input_data;
+            auto model = build(backend_name, input.data());
+            model.run();
+            auto first_output = get_output(model);
+            for(int i = 0; i < 3; ++i) {
+                model.run();
+                EXPECT_EQ(get_output(model), first_output);
+            }
+
+            // contents of the attached buffer are rewritten
+            std::copy(other_input_data.begin(), other_input_data.end(),
+                      input.begin());
+            model.run();
+            auto rewritten_output = get_output(model);
+            EXPECT_NE(rewritten_output, first_output);
+
+            // the input is bound to another buffer in a new model
+            auto other_input = other_input_data;
+            auto other_model = build(backend_name, other_input.data());
+            other_model.run();
+            other_model.run();
+            menoh_impl::assert_near_list(get_output(other_model),
+                                         rewritten_output, 10.e-5);
+
+            std::copy(input_data.begin(), input_data.end(), input.begin());
+            model.run();
+            EXPECT_EQ(get_output(model), first_output);
+        }
+    }
+
+    // Expired or cancelled runs must stop with their own error codes and
+    // runs within the deadline must give the same outputs as run()
+    TEST_F(MkldnnWithGenericFallbackBackendTest, run_with_deadline_test) {
+        int batch_size = 1, c = 3, h = 8, w = 8, m = 4, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("input", input_data.data());
+
+        auto true_model = model_builder.build_model(
+          model_data, "mkldnn_with_generic_fallback");
+        true_model.run();
+        auto size = batch_size * m * h * w;
+        auto true_output =
+          static_cast<float*>(true_model.get_variable("output").buffer_handle);
+
+        // procedures run in order or by the inter-op executor. The mkldnn
+        // backend checks them between nodes
+        std::vector<std::pair<std::string, std::string>>
+          backend_and_config_list{
+            {"mkldnn_with_generic_fallback", ""},
+            {"mkldnn_with_generic_fallback", R"({"inter_op_thread_num":2})"},
+            {"mkldnn", ""}};
+        for(auto const& backend_and_config : backend_and_config_list) {
+            auto model = model_builder.build_model(
+              model_data, backend_and_config.first, backend_and_config.second);
+            try {
+                model.run_with_deadline(std::chrono::microseconds(0));
+                FAIL() << "deadline is not checked";
+            } catch(menoh::error const& e) {
+                EXPECT_EQ(e.error_code(), error_code_t::deadline_exceeded);
+            }
+
+            cancellation_token token;
+            token.cancel();
+            try {
+                model.run_with_deadline(std::chrono::microseconds(-1),
+                                        &token);
+                FAIL() << "cancellation is not checked";
+            } catch(menoh::error const& e) {
+                EXPECT_EQ(e.error_code(), error_code_t::run_cancelled);
+            }
+
+            token.reset();
+            model.run_with_deadline(std::chrono::seconds(60), &token);
+            auto output =
+              static_cast<float*>(model.get_variable("output").buffer_handle);
+            menoh_impl::assert_near_list(output, output + size, true_output,
+                                         true_output + size, 10.e-4);
+        }
+    }
+
+    // Runs of a chain of generic Conv nodes are stopped between nodes when
+    // the token is cancelled from another thread or the deadline expires
+    TEST_F(MkldnnWithGenericFallbackBackendTest,
+           run_with_deadline_mid_run_test) {
+        int batch_size = 1, c = 32, h = 64, w = 64, k = 3;
+        int node_num = 100;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(c * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 70.f - 0.025f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {c, c, k, k},
+                                 weight_data.data());
+        std::string value_name = "input";
+        for(int i = 0; i < node_num; ++i) {
+            auto output_name =
+              i + 1 == node_num ? "output" : "conv" + std::to_string(i);
+            model_data.add_new_node("Conv");
+            model_data.add_attribute_ints_to_current_node("pads",
+                                                          {1, 1, 1, 1});
+            model_data.add_input_name_to_current_node(value_name);
+            model_data.add_input_name_to_current_node("weight");
+            model_data.add_output_name_to_current_node(output_name);
+            value_name = output_name;
+        }
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("input", input_data.data());
+
+        for(auto config : {R"({"backends":[{"type":"generic"}]})",
+                           R"({"backends":[{"type":"generic"}],)"
+                           R"("inter_op_thread_num":2})"}) {
+            auto model = model_builder.build_model(
+              model_data, "composite_backend", config);
+            auto start = std::chrono::steady_clock::now();
+            model.run();
+            auto run_time =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            cancellation_token token;
+            std::thread canceller([&token, run_time] {
+                std::this_thread::sleep_for(run_time / 4);
+                token.cancel();
+            });
+            start = std::chrono::steady_clock::now();
+            try {
+                model.run_with_deadline(std::chrono::microseconds(-1),
+                                        &token);
+                ADD_FAILURE() << "run is not cancelled";
+            } catch(menoh::error const& e) {
+                EXPECT_EQ(e.error_code(), error_code_t::run_cancelled);
+            }
+            auto cancelled_run_time =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            canceller.join();
+            EXPECT_LT(cancelled_run_time, run_time);
+
+            try {
+                model.run_with_deadline(run_time / 4);
+                FAIL() << "deadline is not checked";
+            } catch(menoh::error const& e) {
+                EXPECT_EQ(e.error_code(), error_code_t::deadline_exceeded);
+            }
+        }
+    }
+
+    // A batch split into sub-batches must give the same outputs as the whole
+    // batch. The last sub-batch fills its core partially
+    TEST_F(MkldnnWithGenericFallbackBackendTest, batch_split_test) {
+        int batch_size = 5, c = 3, h = 8, w = 8, m = 4, k = 3;
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        model_builder.attach_external_buffer("input", input_data.data());
+
+        auto true_model = model_builder.build_model(
+          model_data, "mkldnn_with_generic_fallback");
+        true_model.run();
+        auto size = batch_size * m * h * w;
+        auto true_output =
+          static_cast<float*>(true_model.get_variable("output").buffer_handle);
+
+        std::vector<float> output_data(size);
+        model_builder.attach_external_buffer("output", output_data.data());
+        // groups of the concurrent mode share cpu 0 so that the test runs on
+        // any machine. With 2 groups the first one runs 2 sub-batches
+        for(auto config :
+            {R"({"sub_batch_size":2,"cpu_list":[0,0,0]})",
+             R"({"sub_batch_size":2,"cpu_list":[0,0]})",
+             R"({"sub_batch_size":2,"sub_batch_mode":"sequential"})"}) {
+            std::fill(output_data.begin(), output_data.end(), -1.f);
+            auto model = model_builder.build_model(
+              model_data, "mkldnn_with_generic_fallback", config);
+            model.run();
+            menoh_impl::assert_near_list(output_data.data(),
+                                         output_data.data() + size,
+                                         true_output, true_output + size,
+                                         10.e-4);
+
+            // buffers of sub-batches are named by their variables
+            for(auto const& e : model.get_memory_stats(true).entry_list) {
+                if(e.category == memory_category_t::io) {
+                    EXPECT_TRUE(e.name == "input" || e.name == "output");
+                }
+            }
+        }
+    }
+
+    // Each node run is recorded in the trace and the summary
+    TEST_F(MkldnnWithGenericFallbackBackendTest, profiling_test) {
+        menoh::model_data model_data;
+        std::vector<float> weight_data(4 * 3 * 3 * 3, 0.1f);
+        model_data.add_parameter("weight", dtype_t::float_, {4, 3, 3, 3},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, {1, 3, 8, 8});
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+
+        auto read_file = [](std::string const& filename) {
+            std::ifstream ifs(filename);
+            return std::string(std::istreambuf_iterator<char>(ifs),
+                               std::istreambuf_iterator<char>());
+        };
+        std::string trace_filename = "menoh_profiling_test_trace.json";
+        std::string summary_filename = "menoh_profiling_test_summary.tsv";
+
+        auto model =
+          model_builder.build_model(model_data, "mkldnn_with_generic_fallback",
+                                    R"({"profiling":true})");
+        model.run();
+        model.run();
+        model.save_profile_trace(trace_filename);
+        model.save_profile_summary(summary_filename);
+        auto trace = read_file(trace_filename);
+        EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+        EXPECT_NE(trace.find("\"conv_out\""), std::string::npos);
+        EXPECT_NE(trace.find("\"output\""), std::string::npos);
+        EXPECT_NE(trace.find("\"input_formats\""), std::string::npos);
+        auto summary = read_file(summary_filename);
+        EXPECT_NE(summary.find("Conv\t2\t"), std::string::npos);
+        EXPECT_NE(summary.find("Relu\t2\t"), std::string::npos);
+
+        // runs after disabling are not recorded
+        model.disable_profiling();
+        model.run();
+        model.save_profile_summary(summary_filename);
+        EXPECT_NE(read_file(summary_filename).find("Conv\t2\t"),
+                  std::string::npos);
+
+        // profiling enabled after build also records each node as its own
+        // event in both backends. Warm-up runs are not recorded
+        for(auto backend_name : {"mkldnn_with_generic_fallback", "mkldnn"}) {
+            auto other_model =
+              model_builder.build_model(model_data, backend_name);
+            other_model.enable_profiling();
+            other_model.warmup(2);
+            other_model.run();
+            other_model.save_profile_summary(summary_filename);
+            summary = read_file(summary_filename);
+            EXPECT_NE(summary.find("Conv\t1\t"), std::string::npos);
+            EXPECT_NE(summary.find("Relu\t1\t"), std::string::npos);
+            other_model.save_profile_trace(trace_filename);
+            EXPECT_NE(read_file(trace_filename).find("\"output_formats\""),
+                      std::string::npos);
+        }
+
+        std::remove(trace_filename.c_str());
+        std::remove(summary_filename.c_str());
+    }
+
+    // Buffers allocated by menoh are counted once. External buffers and
+    // parameters given by pointer are not counted
+    TEST_F(MkldnnWithGenericFallbackBackendTest, memory_stats_test) {
+        menoh::model_data model_data;
+        std::vector<float> weight_data(4 * 3 * 3 * 3, 0.1f);
+        model_data.add_parameter("weight", dtype_t::float_, {4, 3, 3, 3},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, {1, 3, 8, 8});
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+        std::vector<float> input_data(3 * 8 * 8);
+        model_builder.attach_external_buffer("input", input_data.data());
+
+        // streams other than the first allocate their own inputs and share
+        // packed weights
+        std::vector<int64_t> packed_weight_bytes_list;
+        for(auto config : {"", R"({"stream_num":2,"cpu_list":[0,0]})"}) {
+            auto model = model_builder.build_model(
+              model_data, "mkldnn_with_generic_fallback", config);
+            model.run();
+            auto stats = model.get_memory_stats(true);
+            int stream_num = model.get_stream_num();
+            int64_t input_bytes = input_data.size() * sizeof(float);
+            int64_t output_bytes = 4 * 6 * 6 * sizeof(float);
+            EXPECT_EQ(stats.parameter_bytes, 0);
+            EXPECT_EQ(stats.io_bytes, (stream_num - 1) * input_bytes +
+                                        stream_num * output_bytes);
+            EXPECT_EQ(stats.total_bytes,
+                      stats.parameter_bytes + stats.packed_weight_bytes +
+                        stats.activation_bytes + stats.scratch_bytes +
+                        stats.io_bytes);
+
+            int64_t entry_bytes = 0;
+            int input_entry_num = 0;
+            for(auto const& e : stats.entry_list) {
+                entry_bytes += e.bytes;
+                if(e.name == "input") {
+                    EXPECT_EQ(e.category, memory_category_t::io);
+                    ++input_entry_num;
+                }
+            }
+            EXPECT_EQ(entry_bytes, stats.total_bytes);
+            EXPECT_EQ(input_entry_num, stream_num - 1);
+            EXPECT_TRUE(model.get_memory_stats().entry_list.empty());
+            packed_weight_bytes_list.push_back(stats.packed_weight_bytes);
+        }
+        EXPECT_EQ(packed_weight_bytes_list.at(0),
+                  packed_weight_bytes_list.at(1));
+    }
+
+    // Warm-up of a single stream model does not change outputs of
+    // following runs
+    TEST_F(MkldnnWithGenericFallbackBackendTest, warmup_test) {
+        int batch_size = 1, c = 3, h = 8, w = 8, m = 4, k = 3;
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<float> input_data(batch_size * c * h * w);
+        for(std::size_t i = 0; i < input_data.size(); ++i) {
+            input_data.at(i) = static_cast<float>(i % 13) / 13.f - 0.5f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Sigmoid");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        auto build = [&](bool is_input_attached) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            if(is_input_attached) {
+                model_builder.attach_external_buffer("input",
+                                                     input_data.data());
+            }
+            auto model = model_builder.build_model(
+              model_data, "mkldnn_with_generic_fallback", "");
+            if(!is_input_attached) {
+                auto input = static_cast<float*>(
+                  model.get_variable("input").buffer_handle);
+                std::copy(input_data.begin(), input_data.end(), input);
+            }
+            return model;
+        };
+        auto output_size = batch_size * m * h * w;
+        auto get_output = [output_size](menoh::model& model) {
+            auto output =
+              static_cast<float*>(model.get_variable("output").buffer_handle);
+            return std::vector<float>(output, output + output_size);
+        };
+
+        auto true_model = build(true);
+        true_model.run();
+        auto true_output = get_output(true_model);
+
+        for(bool is_input_attached : {true, false}) {
+            auto model = build(is_input_attached);
+            ASSERT_EQ(model.get_stream_num(), 1);
+            model.warmup(0);
+            model.warmup(3);
+            menoh_impl::assert_near_list(get_output(model), true_output,
+                                         10.e-5);
+            auto input =
+              static_cast<float*>(model.get_variable("input").buffer_handle);
+            menoh_impl::assert_near_list(input, input + input_data.size(),
+                                         input_data.begin(), input_data.end(),
+                                         0.f);
+            model.run();
+            menoh_impl::assert_near_list(get_output(model), true_output,
+                                         10.e-5);
+        }
+    }
+
+    // Batches run on two streams must give the same outputs as on one
+    TEST_F(MkldnnWithGenericFallbackBackendTest, multi_stream_test) {
+        int batch_size = 1, c = 3, h = 8, w = 8, m = 4, k = 3;
+        int batch_num = 5;
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        auto input_size = batch_size * c * h * w;
+        auto output_size = batch_size * m * h * w;
+        auto fill_input = [input_size](float* input, int batch_index) {
+            for(int i = 0; i < input_size; ++i) {
+                input[i] =
+                  static_cast<float>((i + batch_index) % 13) / 13.f - 0.5f;
+            }
+        };
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        auto build = [&](std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            return model_builder.build_model(
+              model_data, "mkldnn_with_generic_fallback", config);
+        };
+
+        auto true_model = build("");
+        ASSERT_EQ(true_model.get_stream_num(), 1);
+        std::vector<std::vector<float>> true_output_list;
+        for(int b = 0; b < batch_num; ++b) {
+            fill_input(static_cast<float*>(
+                         true_model.get_variable("input").buffer_handle),
+                       b);
+            true_model.run();
+            auto output = static_cast<float*>(
+              true_model.get_variable("output").buffer_handle);
+            true_output_list.emplace_back(output, output + output_size);
+        }
+
+        // both streams share cpu 0 so that the test runs on any machine
+        auto model = build(R"({"stream_num":2,"cpu_list":[0,0]})");
+        ASSERT_EQ(model.get_stream_num(), 2);
+        model.warmup(2);
+        EXPECT_NE(model.get_stream_variable(0, "input").buffer_handle,
+                  model.get_stream_variable(1, "input").buffer_handle);
+        // the second call reuses workers of the first one
+        for(int round = 0; round < 2; ++round) {
+            std::vector<std::vector<float>> output_list(batch_num);
+            model.run_batches(
+              batch_num,
+              [&](int batch_index, int stream_index) {
+                  fill_input(static_cast<float*>(
+                               model.get_stream_variable(stream_index, "input")
+                                 .buffer_handle),
+                             batch_index);
+              },
+              [&](int batch_index, int stream_index) {
+                  auto output = static_cast<float*>(
+                    model.get_stream_variable(stream_index, "output")
+                      .buffer_handle);
+                  output_list.at(batch_index).assign(output,
+                                                     output + output_size);
+              });
+            for(int b = 0; b < batch_num; ++b) {
+                menoh_impl::assert_near_list(output_list.at(b),
+                                             true_output_list.at(b), 10.e-4);
+            }
+        }
+    }
+
+    // Requests run on replicas of a session must give the same outputs as
+    // the model
+    TEST_F(MkldnnWithGenericFallbackBackendTest, session_test) {
+        int batch_size = 1, c = 3, h = 8, w = 8, m = 4, k = 3;
+        int request_num = 20;
+        std::vector<float> weight_data(m * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        auto input_size = batch_size * c * h * w;
+        auto output_size = batch_size * m * h * w;
+        auto fill_input = [input_size](float* input, int request_index) {
+            for(int i = 0; i < input_size; ++i) {
+                input[i] =
+                  static_cast<float>((i + request_index) % 13) / 13.f - 0.5f;
+            }
+        };
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {m, c, k, k},
+                                 weight_data.data());
+        model_data.add_new_node("Conv");
+        model_data.add_attribute_ints_to_current_node("pads", {1, 1, 1, 1});
+        model_data.add_input_name_to_current_node("input");
+        model_data.add_input_name_to_current_node("weight");
+        model_data.add_output_name_to_current_node("conv_out");
+        model_data.add_new_node("Relu");
+        model_data.add_input_name_to_current_node("conv_out");
+        model_data.add_output_name_to_current_node("output");
+
+        menoh::variable_profile_table_builder vpt_builder;
+        vpt_builder.add_input_profile("input", dtype_t::float_, input_dims);
+        vpt_builder.add_output_name("output");
+        auto vpt = vpt_builder.build_variable_profile_table(model_data);
+        model_builder model_builder(vpt);
+
+        auto true_model = model_builder.build_model(
+          model_data, "mkldnn_with_generic_fallback");
+        std::vector<std::vector<float>> true_output_list;
+        for(int r = 0; r < request_num; ++r) {
+            fill_input(static_cast<float*>(
+                         true_model.get_variable("input").buffer_handle),
+                       r);
+            true_model.run();
+            auto output = static_cast<float*>(
+              true_model.get_variable("output").buffer_handle);
+            true_output_list.emplace_back(output, output + output_size);
+        }
+
+        // both replicas share cpu 0 so that the test runs on any machine
+        auto session = model_builder.build_session(
+          model_data, "mkldnn_with_generic_fallback",
+          R"({"stream_num":2,"cpu_list":[0,0],"session_queue_capacity":4})");
+        ASSERT_EQ(session.get_replica_num(), 2);
+        std::vector<std::vector<float>> output_list(request_num);
+        std::vector<std::exception_ptr> exception_list(request_num);
+        for(int r = 0; r < request_num; ++r) {
+            session.submit(
+              [&, r](int replica_index) {
+                  fill_input(static_cast<float*>(
+                               session.get_variable_buffer_handle(
+                                 replica_index, "input")),
+                             r);
+              },
+              [&, r](int replica_index, std::exception_ptr exception) {
+                  exception_list.at(r) = exception;
+                  auto output = static_cast<float*>(
+                    session.get_variable_buffer_handle(replica_index,
+                                                       "output"));
+                  output_list.at(r).assign(output, output + output_size);
+              });
+        }
+        session.wait();
+        EXPECT_EQ(session.get_queue_depth(), 0);
+        EXPECT_EQ(session.get_completed_request_num(), request_num);
+        EXPECT_LE(0.f, session.get_utilization());
+        for(int r = 0; r < request_num; ++r) {
+            EXPECT_FALSE(exception_list.at(r));
+            menoh_impl::assert_near_list(output_list.at(r),
+                                         true_output_list.at(r), 10.e-4);
+        }
+    }
+
+    // Replicas are warmed before the session takes requests. An exception
+    // thrown by a finish callback does not stop the worker and is rethrown
+    // by wait()
+    TEST_F(MkldnnWithGenericFallbackBackendTest, session_callback_test) {
+        class counting_model_core final : public menoh_impl::model_core {
+        public:
+            explicit counting_model_core(std::atomic<int>* run_num)
+              : run_num_(run_num) {}
+
+        private:
+            virtual void
+            do_run(menoh_impl::run_control const* /*control*/) override {
+                ++*run_num_;
+            }
+
+            std::atomic<int>* run_num_;
+        };
+
+        std::atomic<int> run_num{0};
+        std::vector<menoh_impl::model_stream> replica_list(1);
+        replica_list.front().core =
+          std::make_unique<counting_model_core>(&run_num);
+        menoh_impl::session session(std::move(replica_list), 4, 2);
+        EXPECT_EQ(run_num.load(), 2);
+
+        int request_num = 3;
+        for(int r = 0; r < request_num; ++r) {
+            menoh_impl::session::request request;
+            request.finish = [](int, std::exception_ptr) {
+                throw std::runtime_error("finish");
+            };
+            session.submit(std::move(request));
+        }
+        EXPECT_THROW(session.wait(), std::runtime_error);
+        EXPECT_EQ(session.completed_request_num(), request_num);
+        EXPECT_EQ(run_num.load(), 2 + request_num);
+
+        // the exception is rethrown once
+        session.submit(menoh_impl::session::request{});
+        EXPECT_NO_THROW(session.wait());
+        EXPECT_EQ(session.completed_request_num(), request_num + 1);
+    }
+
+    TEST_F(MkldnnWithGenericFallbackBackendTest, balance_cut_point_list) {
+        EXPECT_EQ(menoh_impl::balance_cut_point_list({1, 1, 1, 1}, 2),
+                  (std::vector<int>{2}));
+        EXPECT_EQ(
+          menoh_impl::balance_cut_point_list({1, 1, 1, 1, 4, 1, 1}, 3),
+          (std::vector<int>{4, 5}));
+    }
+
+    // Batches streamed through pipeline stages must give the same outputs
+    // as the model without stages. conv_out_0 is used across stages
+    TEST_F(MkldnnWithGenericFallbackBackendTest, pipeline_test) {
+        int batch_size = 1, c = 4, h = 8, w = 8, k = 3;
+        int batch_num = 5;
+        std::vector<float> weight_data(c * c * k * k);
+        for(std::size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data.at(i) = static_cast<float>(i % 7) / 7.f - 0.25f;
+        }
+        std::vector<int32_t> input_dims{batch_size, c, h, w};
+        auto size = batch_size * c * h * w;
+        auto fill_input = [size](float* input, int batch_index) {
+            for(int i = 0; i < size; ++i) {
+                input[i] =
+                  static_cast<float>((i + batch_index) % 13) / 13.f - 0.5f;
+            }
+        };
+
+        menoh::model_data model_data;
+        model_data.add_parameter("weight", dtype_t::float_, {c, c, k, k},
+                                 weight_data.data());
+        for(std::string i : {"0", "1"}) {
+            model_data.add_new_node("Conv");
+            model_data.add_attribute_ints_to_current_node("pads",
+                                                          {1, 1, 1, 1});
+            model_data.add_input_name_to_current_node(
+              i == "0" ? "input" : "relu_out_0");
+            model_data.add_input_name_to_current_node("weight");
+            model_data.add_output_name_to_current_node("conv_out_" + i);
+            model_data.add_new_node("Relu");
+            model_data.add_input_name_to_current_node("conv_out_" + i);
+            model_data.add_output_name_to_current_node("relu_out_" + i);
+        }
+        model_data.add_new_node("Add");
+        model_data.add_input_name_to_current_node("relu_out_1");
+        model_data.add_input_name_to_current_node("conv_out_0");
+        model_data.add_output_name_to_current_node("output");
+
+        auto build = [&](std::string const& config) {
+            menoh::variable_profile_table_builder vpt_builder;
+            vpt_builder.add_input_profile("input", dtype_t::float_,
+                                          input_dims);
+            vpt_builder.add_output_name("output");
+            auto vpt = vpt_builder.build_variable_profile_table(model_data);
+            model_builder model_builder(vpt);
+            return model_builder.build_model(
+              model_data, "mkldnn_with_generic_fallback", config);
+        };
+
+        auto true_model = build("");
+        std::vector<std::vector<float>> true_output_list;
+        for(int b = 0; b < batch_num; ++b) {
+            fill_input(static_cast<float*>(
+                         true_model.get_variable("input").buffer_handle),
+                       b);
+            true_model.run();
+            auto output = static_cast<float*>(
+              true_model.get_variable("output").buffer_handle);
+            true_output_list.emplace_back(output, output + size);
+        }
+
+        // cut points are given or chosen by measurement
+        for(auto config :
+            {R"({"pipeline_stage_num":2,"pipeline_cut_points":[2],)"
+             R"("cpu_list":[0,0]})",
+             R"({"pipeline_stage_num":3,"cpu_list":[0,0,0]})"}) {
+            auto model = build(config);
+            std::vector<std::vector<float>> output_list(batch_num);
+            model.run_batches(
+              batch_num,
+              [&](int batch_index, int) {
+                  fill_input(static_cast<float*>(
+                               model.get_variable("input").buffer_handle),
+                             batch_index);
+              },
+              [&](int batch_index, int) {
+                  auto output = static_cast<float*>(
+                    model.get_variable("output").buffer_handle);
+                  output_list.at(batch_index).assign(output, output + size);
+              });
+            for(int b = 0; b < batch_num; ++b) {
+                menoh_impl::assert_near_list(output_list.at(b),
+                                             true_output_list.at(b), 10.e-4);
+            }
+        }
+    }
 } // namespace menoh
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <menoh/mpmc_queue.hpp>
+
+namespace menoh_impl {
+    namespace {
+
+        class MpmcQueueTest : public ::testing::Test {};
+
+        TEST_F(MpmcQueueTest, capacity_is_rounded_up_to_power_of_2) {
+            EXPECT_EQ(mpmc_queue<int>(1).capacity(), 1u);
+            EXPECT_EQ(mpmc_queue<int>(3).capacity(), 4u);
+            EXPECT_EQ(mpmc_queue<int>(8).capacity(), 8u);
+        }
+
+        TEST_F(MpmcQueueTest, full_and_empty) {
+            mpmc_queue<std::unique_ptr<int>> queue(4);
+            std::unique_ptr<int> value;
+            EXPECT_FALSE(queue.try_pop(value));
+
+            // wraps around the buffer twice
+            for(int round = 0; round < 2; ++round) {
+                for(int i = 0; i < 4; ++i) {
+                    value = std::make_unique<int>(i);
+                    ASSERT_TRUE(queue.try_push(value));
+                    EXPECT_FALSE(value);
+                }
+                value = std::make_unique<int>(4);
+                EXPECT_FALSE(queue.try_push(value));
+                ASSERT_TRUE(value); // not moved when full
+                EXPECT_EQ(*value, 4);
+
+                for(int i = 0; i < 4; ++i) {
+                    ASSERT_TRUE(queue.try_pop(value));
+                    EXPECT_EQ(*value, i); // first in first out
+                }
+                EXPECT_FALSE(queue.try_pop(value));
+            }
+        }
+
+        // every pushed value is popped exactly once
+        TEST_F(MpmcQueueTest, multiple_producers_and_consumers) {
+            int producer_num = 4, consumer_num = 4;
+            int value_num_per_producer = 10000;
+            int value_num = producer_num * value_num_per_producer;
+            mpmc_queue<int> queue(64);
+
+            std::vector<std::thread> thread_list;
+            for(int p = 0; p < producer_num; ++p) {
+                thread_list.emplace_back([&queue, p, value_num_per_producer] {
+                    for(int i = 0; i < value_num_per_producer; ++i) {
+                        int value = p * value_num_per_producer + i;
+                        while(!queue.try_push(value)) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            std::atomic<int> popped_num{0};
+            std::vector<std::vector<int>> popped_list_list(consumer_num);
+            for(int c = 0; c < consumer_num; ++c) {
+                thread_list.emplace_back([&, c] {
+                    int value;
+                    while(popped_num.load() < value_num) {
+                        if(queue.try_pop(value)) {
+                            popped_list_list.at(c).push_back(value);
+                            ++popped_num;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for(auto& t : thread_list) {
+                t.join();
+            }
+
+            std::vector<int> popped_list;
+            for(auto const& l : popped_list_list) {
+                popped_list.insert(popped_list.end(), l.begin(), l.end());
+            }
+            std::sort(popped_list.begin(), popped_list.end());
+            std::vector<int> expected(value_num);
+            std::iota(expected.begin(), expected.end(), 0);
+            EXPECT_EQ(popped_list, expected);
+            int value;
+            EXPECT_FALSE(queue.try_pop(value));
+        }
+
+    } // namespace
+} // namespace menoh_impl
@@ -86,7 +86,9 @@ namespace {
               "../external/onnx/onnx/backend/test/data/node/") {}
 
         void run_test(std::string backend_name, std::string const& test_name,
-                      float eps, bool squash_dims = false) {
+                      float eps, bool squash_dims = false,
+                      std::string const& backend_config =
+                        R"({"log_output" : "stdout"})") {
             auto parent_dir_path = onnx_test_data_dir_path_ / test_name;
 
             for(int data_set_index = 0; true; ++data_set_index) {
@@ -139,7 +141,7 @@ namespace {
                 }
 
                 auto model = model_builder.build_model(
-                  model_data, backend_name, R"({"log_output" : "stdout"})");
+                  model_data, backend_name, backend_config);
 
                 model_data.reset();
 
@@ -200,6 +202,18 @@ namespace {
     TEST_OP_IMPL(backend_name, test_name, eps, false)
 #define TEST_OP_SQUASH_DIMS(backend_name, test_name, eps) \
     TEST_OP_IMPL(backend_name, test_name, eps, true)
+#define TEST_GENERIC_OP(test_name, eps)                                  \
+    TEST_F(OperatorTest, generic_##test_name) {                          \
+        run_test("composite_backend", #test_name, eps, false,            \
+                 R"({"backends":[{"type":"generic"}],)"                  \
+                 R"("log_output":"stdout"})");                           \
+    }
+#define TEST_GENERIC_FAST_MATH_OP(test_name, eps)                        \
+    TEST_F(OperatorTest, generic_fast_math_##test_name) {                \
+        run_test("composite_backend", #test_name, eps, false,            \
+                 R"({"backends":[{"type":"generic"}],)"                  \
+                 R"("math_accuracy":"fast","log_output":"stdout"})");    \
+    }
 
     float eps = 1.e-4;
 
@@ -243,6 +257,10 @@ namespace {
     TEST_OP(mkldnn_with_generic_fallback, test_batchnorm_epsilon, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_batchnorm_example, eps);
   
+    // Concat
+    TEST_OP(mkldnn_with_generic_fallback, test_concat_2d_axis_0, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_concat_2d_axis_1, eps);
+
     // Conv
     TEST_OP(mkldnn_with_generic_fallback, test_basic_conv_without_padding, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_basic_conv_with_padding, eps);
@@ -250,6 +268,10 @@ namespace {
     TEST_OP(mkldnn_with_generic_fallback, test_conv_with_strides_no_padding, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_conv_with_strides_padding, eps);
 
+    // ConvTranspose
+    TEST_OP(mkldnn_with_generic_fallback, test_convtranspose, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_convtranspose_pads, eps);
+
     TEST_OP(mkldnn_with_generic_fallback, test_constant, eps);
   
     // Eltwise
@@ -266,12 +288,24 @@ namespace {
     
     TEST_OP(mkldnn_with_generic_fallback, test_identity, eps);
 
+    // LRN
+    TEST_OP(mkldnn_with_generic_fallback, test_lrn, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_lrn_default, eps);
+
+    TEST_OP(mkldnn_with_generic_fallback, test_matmul_2d, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_matmul_3d, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_matmul_4d, eps);
+
     // Mul
     TEST_OP(mkldnn_with_generic_fallback, test_mul, eps);
     //TEST_OP(mkldnn_with_generic_fallback, test_mul_bcast, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_mul_example, eps);
   
     // Pool
+    TEST_OP(mkldnn_with_generic_fallback, test_globalaveragepool, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_globalaveragepool_precomputed, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_globalmaxpool, eps);
+    TEST_OP(mkldnn_with_generic_fallback, test_globalmaxpool_precomputed, eps);
     //TEST_OP(mkldnn_with_generic_fallback, test_averagepool_1d_default, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_averagepool_2d_default, eps);
     TEST_OP(mkldnn_with_generic_fallback, test_averagepool_2d_pads, eps);
@@ -331,6 +365,58 @@ namespace {
     TEST_OP(mkldnn_with_generic_fallback, test_transpose_default, eps);
 
 
+    // Tests for generic backend only
+
+    // Conv
+    TEST_GENERIC_OP(test_basic_conv_without_padding, eps);
+    TEST_GENERIC_OP(test_basic_conv_with_padding, eps);
+    TEST_GENERIC_OP(test_conv_with_strides_and_asymmetric_padding, eps);
+    TEST_GENERIC_OP(test_conv_with_strides_no_padding, eps);
+    TEST_GENERIC_OP(test_conv_with_strides_padding, eps);
+
+    // Gemm
+    TEST_GENERIC_OP(test_gemm_broadcast, eps);
+    TEST_GENERIC_OP(test_gemm_nobroadcast, eps);
+
+    // Exp, Sigmoid and Tanh
+    TEST_GENERIC_OP(test_exp, eps);
+    TEST_GENERIC_OP(test_exp_example, eps);
+    TEST_GENERIC_OP(test_sigmoid, eps);
+    TEST_GENERIC_OP(test_tanh, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_exp, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_exp_example, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_sigmoid, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_sigmoid_example, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_tanh, eps);
+    TEST_GENERIC_FAST_MATH_OP(test_tanh_example, eps);
+
+    // MatMul
+    TEST_GENERIC_OP(test_matmul_2d, eps);
+    TEST_GENERIC_OP(test_matmul_3d, eps);
+    TEST_GENERIC_OP(test_matmul_4d, eps);
+
+    // GlobalAveragePool and GlobalMaxPool
+    TEST_GENERIC_OP(test_globalaveragepool, eps);
+    TEST_GENERIC_OP(test_globalaveragepool_precomputed, eps);
+    TEST_GENERIC_OP(test_globalmaxpool, eps);
+    TEST_GENERIC_OP(test_globalmaxpool_precomputed, eps);
+
+    // Reduce
+    TEST_GENERIC_OP(test_reduce_max_default_axes_keepdim_example, eps);
+    TEST_GENERIC_OP(test_reduce_max_do_not_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_max_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_mean_default_axes_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_mean_do_not_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_mean_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_min_default_axes_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_min_do_not_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_min_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_sum_default_axes_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_sum_do_not_keepdims_example, eps);
+    TEST_GENERIC_OP(test_reduce_sum_keepdims_example, eps);
+
+#undef TEST_GENERIC_FAST_MATH_OP
+#undef TEST_GENERIC_OP
 #undef TEST_OP_SQUASH_DIMS
 #undef TEST_OP
 #undef TEST_OP_IMPL